@@ -124,6 +124,7 @@ void CommandLineFrontend::start()
         case InstallCommandType:
         case DumpNodesTreeCommandType:
         case ListProductsCommandType:
+        case ListDependentsCommandType:
             if (m_parser.buildConfigurations().size() > 1) {
                 QString error = Tr::tr("Invalid use of command '%1': There can be only one "
                                "build configuration.\n").arg(m_parser.commandName());
@@ -422,6 +423,10 @@ void CommandLineFrontend::handleProjectsResolved()
         listProducts();
         qApp->quit();
         break;
+    case ListDependentsCommandType:
+        listDependents();
+        qApp->quit();
+        break;
     case HelpCommandType:
     case VersionCommandType:
     case SessionCommandType:
@@ -599,8 +604,16 @@ void CommandLineFrontend::dumpNodesTree()
 {
     QFile stdOut;
     stdOut.open(stdout, QIODevice::WriteOnly);
-    const ErrorInfo error = m_projects.front().dumpNodesTree(stdOut, productsToUse()
-                                                             .value(m_projects.front()));
+    const QList<ProductData> products = productsToUse().value(m_projects.front());
+    const QString format = m_parser.graphFormat();
+    const bool dumpTree = format == GraphFormatOption::defaultFormat();
+    if (dumpTree && !m_parser.fileTags().empty()) {
+        throw ErrorInfo(Tr::tr("Filtering by file tags is not supported with the '%1' format.")
+                        .arg(format));
+    }
+    const ErrorInfo error = dumpTree
+            ? m_projects.front().dumpNodesTree(stdOut, products)
+            : m_projects.front().exportNodesGraph(stdOut, products, format, m_parser.fileTags());
     if (error.hasError())
         throw error;
 }
@@ -621,6 +634,33 @@ void CommandLineFrontend::listProducts()
     qbsInfo() << output.join(QLatin1Char('\n'));
 }
 
+void CommandLineFrontend::listDependents()
+{
+    const QStringList changedFiles = m_parser.changedFiles();
+    if (changedFiles.empty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of command '%1': No files given.\nUsage: %2")
+                        .arg(m_parser.commandName(), m_parser.commandDescription()));
+    }
+    QStringList productNames;
+    for (const ProductData &p : productsToUse().constBegin().value())
+        productNames << p.fullDisplayName();
+    ErrorInfo error;
+    const QList<Project::DependentProduct> dependents
+            = m_projects.front().dependentProducts(changedFiles, &error);
+    if (error.hasError())
+        throw error;
+    QStringList output;
+    for (const Project::DependentProduct &dependent : dependents) {
+        if (!productNames.contains(dependent.product.fullDisplayName()))
+            continue;
+        output << dependent.product.fullDisplayName();
+        for (const QString &filePath : dependent.filePaths)
+            output << QLatin1String("    ") + QDir::toNativeSeparators(filePath);
+    }
+    if (!output.empty())
+        qbsInfo() << output.join(QLatin1Char('\n'));
+}
+
 void CommandLineFrontend::connectBuildJobs()
 {
     for (AbstractJob * const job : std::as_const(m_buildJobs))
@@ -97,6 +97,7 @@ private:
     void updateTimestamps();
     void dumpNodesTree();
     void listProducts();
+    void listDependents();
     void connectBuildJobs();
     void connectBuildJob(AbstractJob *job);
     void connectJob(AbstractJob *job);
@@ -38,6 +38,7 @@
 ****************************************************************************/
 #include "commandlineoption.h"
 
+#include <api/project.h>
 #include <logging/logger.h>
 #include <logging/translator.h>
 #include <tools/error.h>
@@ -162,6 +163,45 @@ void GeneratorOption::doParse(const QString &representation, QStringList &input)
     }
 }
 
+QStringList GraphFormatOption::allFormats()
+{
+    return QStringList(defaultFormat()) + Project::nodesGraphFormats();
+}
+
+QString GraphFormatOption::defaultFormat()
+{
+    return QStringLiteral("tree");
+}
+
+QString GraphFormatOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <format>\n"
+                  "\tOutput format. Possible values are '%2'.\n"
+                  "\tThe default is '%3'.\n")
+            .arg(longRepresentation(), allFormats().join(QLatin1String("', '")),
+                 defaultFormat());
+}
+
+QString GraphFormatOption::longRepresentation() const
+{
+    return QStringLiteral("--format");
+}
+
+void GraphFormatOption::doParse(const QString &representation, QStringList &input)
+{
+    m_format = getArgument(representation, input);
+    if (m_format.isEmpty()) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': No format given.\nUsage: %2")
+                    .arg(representation, description(command())));
+    }
+    if (!allFormats().contains(m_format)) {
+        throw ErrorInfo(Tr::tr("Invalid use of option '%1': "
+                               "Invalid format '%2' given.\nUsage: %3")
+                        .arg(representation, m_format, description(command())));
+    }
+}
+
 static QString loglevelLongRepresentation() { return QStringLiteral("--log-level"); }
 
 QString VerboseOption::description(CommandType command) const
@@ -345,7 +385,10 @@ void StringListOption::doParse(const QString &representation, QStringList &input
 
 QString ChangedFilesOption::description(CommandType command) const
 {
-    Q_UNUSED(command);
+    if (command == ListDependentsCommandType) {
+        return Tr::tr("%1 <file>[,<file>...]\n"
+                      "\tList what depends on these files.\n").arg(longRepresentation());
+    }
     return Tr::tr("%1 <file>[,<file>...]\n"
                   "\tAssume these and only these files have changed.\n").arg(longRepresentation());
 }
@@ -722,4 +765,17 @@ QString RunEnvConfigOption::longRepresentation() const
     return QStringLiteral("--setup-run-env-config");
 }
 
+QString FileTagsOption::description(CommandType command) const
+{
+    Q_UNUSED(command);
+    return Tr::tr("%1 <tag>[,<tag>...]\n"
+                  "\tTake only nodes with at least one of these file tags into account.\n")
+            .arg(longRepresentation());
+}
+
+QString FileTagsOption::longRepresentation() const
+{
+    return QStringLiteral("--file-tags");
+}
+
 } // namespace qbs
@@ -81,6 +81,8 @@ public:
         WaitLockOptionType,
         RunEnvConfigOptionType,
         DeprecationWarningsOptionType,
+        GraphFormatOptionType,
+        FileTagsOptionType,
     };
 
     virtual ~CommandLineOption();
@@ -149,6 +151,23 @@ private:
     QString m_generatorName;
 };
 
+class GraphFormatOption : public CommandLineOption
+{
+public:
+    static QStringList allFormats();
+    static QString defaultFormat();
+    QString format() const { return m_format.isEmpty() ? defaultFormat() : m_format; }
+
+private:
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return {}; }
+    QString longRepresentation() const override;
+    void doParse(const QString &representation, QStringList &input) override;
+
+private:
+    QString m_format;
+};
+
 class CountingOption : public CommandLineOption
 {
 public:
@@ -298,6 +317,13 @@ class RunEnvConfigOption : public StringListOption
     QString longRepresentation() const override;
 };
 
+class FileTagsOption : public StringListOption
+{
+    QString description(CommandType command) const override;
+    QString shortRepresentation() const override { return {}; }
+    QString longRepresentation() const override;
+};
+
 class LogLevelOption : public CommandLineOption
 {
 public:
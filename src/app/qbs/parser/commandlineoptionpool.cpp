@@ -134,6 +134,12 @@ CommandLineOption *CommandLineOptionPool::getOption(CommandLineOption::Type type
         case CommandLineOption::DeprecationWarningsOptionType:
             option = new DeprecationWarningsOption;
             break;
+        case CommandLineOption::GraphFormatOptionType:
+            option = new GraphFormatOption;
+            break;
+        case CommandLineOption::FileTagsOptionType:
+            option = new FileTagsOption;
+            break;
         default:
             qFatal("Unknown option type %d", type);
         }
@@ -287,4 +293,14 @@ DeprecationWarningsOption *CommandLineOptionPool::deprecationWarningsOption() co
             (getOption(CommandLineOption::DeprecationWarningsOptionType));
 }
 
+GraphFormatOption *CommandLineOptionPool::graphFormatOption() const
+{
+    return static_cast<GraphFormatOption *>(getOption(CommandLineOption::GraphFormatOptionType));
+}
+
+FileTagsOption *CommandLineOptionPool::fileTagsOption() const
+{
+    return static_cast<FileTagsOption *>(getOption(CommandLineOption::FileTagsOptionType));
+}
+
 } // namespace qbs
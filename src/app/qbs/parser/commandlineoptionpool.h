@@ -79,6 +79,8 @@ public:
     WaitLockOption *waitLockOption() const;
     RunEnvConfigOption *runEnvConfigOption() const;
     DeprecationWarningsOption *deprecationWarningsOption() const;
+    GraphFormatOption *graphFormatOption() const;
+    FileTagsOption *fileTagsOption() const;
 
 private:
     mutable QHash<CommandLineOption::Type, CommandLineOption *> m_options;
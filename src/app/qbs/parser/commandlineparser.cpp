@@ -95,6 +95,7 @@ public:
                                             const QString &configurationName);
     bool withNonDefaultProducts() const;
     bool dryRun() const;
+    QStringList changedFiles() const;
     QString settingsDir() const { return  optionPool.settingsDirOption()->settingsDir(); }
 
     CommandEchoMode echoMode() const;
@@ -257,6 +258,11 @@ QStringList CommandLineParser::products() const
     return d->optionPool.productsOption()->arguments();
 }
 
+QStringList CommandLineParser::changedFiles() const
+{
+    return d->changedFiles();
+}
+
 QStringList CommandLineParser::runEnvConfig() const
 {
     return d->optionPool.runEnvConfigOption()->arguments();
@@ -282,6 +288,16 @@ DeprecationWarningMode CommandLineParser::deprecationWarningMode() const
     return d->optionPool.deprecationWarningsOption()->mode();
 }
 
+QString CommandLineParser::graphFormat() const
+{
+    return d->optionPool.graphFormatOption()->format();
+}
+
+QStringList CommandLineParser::fileTags() const
+{
+    return d->optionPool.fileTagsOption()->arguments();
+}
+
 QString CommandLineParser::commandName() const
 {
     return d->command->representation();
@@ -396,6 +412,7 @@ QList<Command *> CommandLineParser::CommandLineParserPrivate::allCommands() cons
             commandPool.getCommand(InstallCommandType),
             commandPool.getCommand(DumpNodesTreeCommandType),
             commandPool.getCommand(ListProductsCommandType),
+            commandPool.getCommand(ListDependentsCommandType),
             commandPool.getCommand(VersionCommandType),
             commandPool.getCommand(SessionCommandType),
             commandPool.getCommand(HelpCommandType)};
@@ -464,11 +481,7 @@ void CommandLineParser::CommandLineParserPrivate::setupBuildDirectory()
 void CommandLineParser::CommandLineParserPrivate::setupBuildOptions()
 {
     buildOptions.setDryRun(dryRun());
-    QStringList changedFiles = optionPool.changedFilesOption()->arguments();
-    QDir currentDir;
-    for (QString &file : changedFiles)
-        file = QDir::fromNativeSeparators(currentDir.absoluteFilePath(file));
-    buildOptions.setChangedFiles(changedFiles);
+    buildOptions.setChangedFiles(changedFiles());
     buildOptions.setKeepGoing(optionPool.keepGoingOption()->enabled());
     buildOptions.setForceTimestampCheck(optionPool.forceTimestampCheckOption()->enabled());
     buildOptions.setForceOutputCheck(optionPool.forceOutputCheckOption()->enabled());
@@ -624,6 +637,15 @@ bool CommandLineParser::CommandLineParserPrivate::dryRun() const
      return optionPool.dryRunOption()->enabled();
 }
 
+QStringList CommandLineParser::CommandLineParserPrivate::changedFiles() const
+{
+    QStringList changedFiles = optionPool.changedFilesOption()->arguments();
+    QDir currentDir;
+    for (QString &file : changedFiles)
+        file = QDir::fromNativeSeparators(currentDir.absoluteFilePath(file));
+    return changedFiles;
+}
+
 CommandEchoMode CommandLineParser::CommandLineParserPrivate::echoMode() const
 {
     if (command->type() == GenerateCommandType)
@@ -86,12 +86,15 @@ public:
     bool buildBeforeInstalling() const;
     QStringList runArgs() const;
     QStringList products() const;
+    QStringList changedFiles() const;
     QStringList runEnvConfig() const;
     QList<QVariantMap> buildConfigurations() const;
     bool showProgress() const;
     bool showVersion() const;
     QString settingsDir() const;
     DeprecationWarningMode deprecationWarningMode() const;
+    QString graphFormat() const;
+    QStringList fileTags() const;
 
 private:
     class CommandLineParserPrivate;
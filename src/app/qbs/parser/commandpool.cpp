@@ -89,6 +89,9 @@ qbs::Command *CommandPool::getCommand(CommandType type) const
         case ListProductsCommandType:
             command = new ListProductsCommand(m_optionPool);
             break;
+        case ListDependentsCommandType:
+            command = new ListDependentsCommand(m_optionPool);
+            break;
         case HelpCommandType:
             command = new HelpCommand(m_optionPool);
             break;
@@ -45,7 +45,7 @@ enum CommandType {
     ResolveCommandType, BuildCommandType, CleanCommandType, RunCommandType, ShellCommandType,
     StatusCommandType, UpdateTimestampsCommandType, DumpNodesTreeCommandType,
     InstallCommandType, HelpCommandType, GenerateCommandType, ListProductsCommandType,
-    VersionCommandType, SessionCommandType,
+    VersionCommandType, SessionCommandType, ListDependentsCommandType,
 };
 
 } // namespace qbs
@@ -496,6 +496,9 @@ QString DumpNodesTreeCommand::longDescription() const
     QString description = Tr::tr("qbs %1 [options] [config:<configuration-name>] ...\n")
             .arg(representation());
     description += Tr::tr("Internal command; for debugging purposes only.\n");
+    description += Tr::tr("The default format prints every path through the graph as an "
+                          "indented tree.\nThe other formats list each node and each edge "
+                          "exactly once.\n");
     return description += supportedOptionsDescription();
 }
 
@@ -507,7 +510,9 @@ QString DumpNodesTreeCommand::representation() const
 QList<CommandLineOption::Type> DumpNodesTreeCommand::supportedOptions() const
 {
     return {CommandLineOption::BuildDirectoryOptionType,
-            CommandLineOption::ProductsOptionType};
+            CommandLineOption::ProductsOptionType,
+            CommandLineOption::GraphFormatOptionType,
+            CommandLineOption::FileTagsOptionType};
 }
 
 QString ListProductsCommand::shortDescription() const
@@ -533,6 +538,34 @@ QList<CommandLineOption::Type> ListProductsCommand::supportedOptions() const
             CommandLineOption::BuildDirectoryOptionType};
 }
 
+QString ListDependentsCommand::shortDescription() const
+{
+    return Tr::tr("Lists the products and files that depend on the given files.");
+}
+
+QString ListDependentsCommand::longDescription() const
+{
+    QString description = Tr::tr("qbs %1 [options] [config:<configuration-name>] ...\n")
+            .arg(representation());
+    description += Tr::tr("Prints every product that would have to be rebuilt if one of "
+                          "the given files changed,\nfollowed by the affected generated files "
+                          "of that product, indented.\nThe information is taken from the "
+                          "existing build graph; the project is not re-resolved.\n");
+    return description += supportedOptionsDescription();
+}
+
+QString ListDependentsCommand::representation() const
+{
+    return QStringLiteral("list-dependents");
+}
+
+QList<CommandLineOption::Type> ListDependentsCommand::supportedOptions() const
+{
+    return {CommandLineOption::BuildDirectoryOptionType,
+            CommandLineOption::ChangedFilesOptionType,
+            CommandLineOption::ProductsOptionType};
+}
+
 QString HelpCommand::shortDescription() const
 {
     return Tr::tr("Show general or command-specific help.");
@@ -230,6 +230,19 @@ private:
     QList<CommandLineOption::Type> supportedOptions() const override;
 };
 
+class ListDependentsCommand : public Command
+{
+public:
+    ListDependentsCommand(CommandLineOptionPool &optionPool) : Command(optionPool) {}
+
+private:
+    CommandType type() const override { return ListDependentsCommandType; }
+    QString shortDescription() const override;
+    QString longDescription() const override;
+    QString representation() const override;
+    QList<CommandLineOption::Type> supportedOptions() const override;
+};
+
 class HelpCommand : public Command
 {
 public:
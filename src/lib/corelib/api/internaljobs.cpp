@@ -49,6 +49,7 @@
 #include <buildgraph/productinstaller.h>
 #include <buildgraph/rulesevaluationcontext.h>
 #include <language/language.h>
+#include <language/scriptcompilationcache.h>
 #include <language/scriptengine.h>
 #include <loader/projectresolver.h>
 #include <logging/logger.h>
@@ -156,12 +157,12 @@ void InternalJob::shareObserverWith(InternalJob *otherJob)
     m_observer = otherJob->m_observer;
 }
 
-void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project)
+void InternalJob::storeBuildGraph(const TopLevelProjectPtr &project, bool inBackground)
 {
     try {
         doSanityChecks(project, logger());
         TimedActivityLogger storeTimer(m_logger, Tr::tr("Storing build graph"), timed());
-        project->store(logger());
+        project->store(logger(), inBackground);
     } catch (const ErrorInfo &error) {
         ErrorInfo fullError = this->error();
         const auto items = error.items();
@@ -291,6 +292,13 @@ void InternalSetupProjectJob::execute()
 {
     RulesEvaluationContextPtr evalContext(new RulesEvaluationContext(logger()));
     evalContext->setObserver(observer());
+    if (!m_parameters.dryRun()) {
+        const QString buildDir = TopLevelProject::deriveBuildDirectory(
+                    m_parameters.buildRoot(),
+                    TopLevelProject::deriveId(m_parameters.finalBuildConfigurationTree()));
+        evalContext->engine()->setByteCodeCacheDirectory(
+                    ScriptCompilationCache::diskCacheDirectory(buildDir));
+    }
 
     switch (m_parameters.restoreBehavior()) {
     case SetupProjectParameters::ResolveOnly:
@@ -316,7 +324,7 @@ void InternalSetupProjectJob::execute()
     }
 
     if (!m_parameters.dryRun())
-        storeBuildGraph(m_newProject);
+        storeBuildGraph(m_newProject, m_parameters.storeBuildGraphInBackground());
 
     // The evalutation context cannot be re-used for building, which runs in a different thread.
     m_newProject->buildData->evaluationContext.reset();
@@ -351,17 +359,19 @@ BuildGraphTouchingJob::BuildGraphTouchingJob(const Logger &logger, QObject *pare
 BuildGraphTouchingJob::~BuildGraphTouchingJob() = default;
 
 void BuildGraphTouchingJob::setup(const TopLevelProjectPtr &project,
-                                  const QVector<ResolvedProductPtr> &products, bool dryRun)
+                                  const QVector<ResolvedProductPtr> &products, bool dryRun,
+                                  bool storeBuildGraphInBackground)
 {
     m_project = project;
     m_products = products;
     m_dryRun = dryRun;
+    m_storeBuildGraphInBackground = storeBuildGraphInBackground;
 }
 
 void BuildGraphTouchingJob::storeBuildGraph()
 {
     if (!m_dryRun && !error().isInternalError())
-        InternalJob::storeBuildGraph(m_project);
+        InternalJob::storeBuildGraph(m_project, m_storeBuildGraphInBackground);
 }
 
 InternalBuildJob::InternalBuildJob(const Logger &logger, QObject *parent)
@@ -372,7 +382,8 @@ InternalBuildJob::InternalBuildJob(const Logger &logger, QObject *parent)
 void InternalBuildJob::build(const TopLevelProjectPtr &project,
         const QVector<ResolvedProductPtr> &products, const BuildOptions &buildOptions)
 {
-    setup(project, products, buildOptions.dryRun());
+    setup(project, products, buildOptions.dryRun(),
+          buildOptions.storeBuildGraphInBackground());
     setTimed(buildOptions.logElapsedTime());
 
     m_executor = new Executor(logger());
@@ -84,7 +84,7 @@ protected:
 
     JobObserver *observer() const { return m_observer; }
     void setTimed(bool timed) { m_timed = timed; }
-    void storeBuildGraph(const TopLevelProjectPtr &project);
+    void storeBuildGraph(const TopLevelProjectPtr &project, bool inBackground = false);
 
 signals:
     void finished(Internal::InternalJob *job);
@@ -163,13 +163,14 @@ protected:
     ~BuildGraphTouchingJob() override;
 
     void setup(const TopLevelProjectPtr &project, const QVector<ResolvedProductPtr> &products,
-               bool dryRun);
+               bool dryRun, bool storeBuildGraphInBackground = false);
     void storeBuildGraph();
 
 private:
     TopLevelProjectPtr m_project;
     QVector<ResolvedProductPtr> m_products;
     bool m_dryRun;
+    bool m_storeBuildGraphInBackground = false;
 };
 
 
@@ -51,6 +51,7 @@
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/buildgraphloader.h>
 #include <buildgraph/emptydirectoriesremover.h>
+#include <buildgraph/nodegraphexporter.h>
 #include <buildgraph/nodetreedumper.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/productinstaller.h>
@@ -81,6 +82,7 @@
 #include <QtCore/qregularexpression.h>
 #include <QtCore/qshareddata.h>
 
+#include <map>
 #include <mutex>
 #include <utility>
 #include <vector>
@@ -130,6 +132,7 @@ ProjectData ProjectPrivate::projectData()
 BuildJob *ProjectPrivate::buildProducts(
     const QVector<ResolvedProductPtr> &products, const BuildOptions &options, QObject *jobOwner)
 {
+    m_reverseDependencyIndex.reset();
     const auto job = new BuildJob(logger, jobOwner);
     job->build(internalProject, products, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -139,6 +142,7 @@ BuildJob *ProjectPrivate::buildProducts(
 CleanJob *ProjectPrivate::cleanProducts(const QVector<ResolvedProductPtr> &products,
         const CleanOptions &options, QObject *jobOwner)
 {
+    m_reverseDependencyIndex.reset();
     const auto job = new CleanJob(logger, jobOwner);
     job->clean(internalProject, products, options);
     QBS_ASSERT(job->state() == AbstractJob::StateRunning,);
@@ -497,6 +501,17 @@ void ProjectPrivate::removeGroup(const ProductData &product, const GroupData &gr
 
 }
 
+const ReverseDependencyIndex &ProjectPrivate::reverseDependencyIndex()
+{
+    if (internalProject->locked)
+        throw ErrorInfo(Tr::tr("A job is currently in progress."));
+    if (!internalProject->buildData)
+        throw ErrorInfo(Tr::tr("This project has no build graph."));
+    if (!m_reverseDependencyIndex)
+        m_reverseDependencyIndex = std::make_unique<ReverseDependencyIndex>(internalProject);
+    return *m_reverseDependencyIndex;
+}
+
 void ProjectPrivate::prepareChangeToProject()
 {
     if (internalProject->locked)
@@ -986,6 +1001,62 @@ ErrorInfo Project::dumpNodesTree(QIODevice &outDevice, const QList<ProductData>
     return {};
 }
 
+QList<Project::DependentProduct> Project::dependentProducts(const QStringList &filePaths,
+                                                          ErrorInfo *error) const
+{
+    QBS_ASSERT(isValid(), return {});
+    try {
+        const std::vector<Artifact *> artifacts
+                = d->reverseDependencyIndex().dependents(filePaths);
+        QHash<QString, ProductData> productsByName;
+        for (const ProductData &p : d->projectData().allProducts())
+            productsByName.insert(p.fullDisplayName(), p);
+        std::map<QString, QStringList> filePathsPerProduct;
+        for (const Artifact * const artifact : artifacts) {
+            QStringList &productFilePaths
+                    = filePathsPerProduct[artifact->product->fullDisplayName()];
+            if (artifact->artifactType == Artifact::Generated)
+                productFilePaths.push_back(artifact->filePath());
+        }
+        QList<DependentProduct> dependents;
+        for (auto &[productName, productFilePaths] : filePathsPerProduct) {
+            productFilePaths.sort();
+            dependents.push_back({productsByName.value(productName), productFilePaths});
+        }
+        return dependents;
+    } catch (const ErrorInfo &e) {
+        if (error)
+            *error = e;
+        return {};
+    }
+}
+
+ErrorInfo Project::exportNodesGraph(QIODevice &outDevice, const QList<ProductData> &products,
+                                    const QString &format, const QStringList &fileTags)
+{
+    NodeGraphExporter::Format exportFormat;
+    if (!NodeGraphExporter::formatFromName(format, exportFormat)) {
+        return ErrorInfo(Tr::tr("Unknown graph format '%1'. Supported formats are '%2'.")
+                         .arg(format, NodeGraphExporter::formatNames()
+                              .join(QLatin1String("', '"))));
+    }
+    try {
+        NodeGraphExporter(outDevice, exportFormat, FileTags::fromStringList(fileTags))
+                .start(d->internalProducts(products));
+    } catch (const ErrorInfo &e) {
+        return e;
+    }
+    return {};
+}
+
+/*!
+ * \brief The formats that \c exportNodesGraph() accepts.
+ */
+QStringList Project::nodesGraphFormats()
+{
+    return NodeGraphExporter::formatNames();
+}
+
 Project::BuildGraphInfo Project::getBuildGraphInfo(const QString &bgFilePath,
                                                    const QStringList &requestedProperties)
 {
@@ -143,6 +143,20 @@ public:
     ProjectTransformerData transformerData(ErrorInfo *error = nullptr) const;
 
     ErrorInfo dumpNodesTree(QIODevice &outDevice, const QList<ProductData> &products);
+    ErrorInfo exportNodesGraph(QIODevice &outDevice, const QList<ProductData> &products,
+                               const QString &format, const QStringList &fileTags = {});
+    static QStringList nodesGraphFormats();
+
+    class DependentProduct
+    {
+    public:
+        ProductData product;
+        QStringList filePaths;
+    };
+    // The products and generated files that need to be rebuilt if one of the given files
+    // changes. Requires the build graph to be present.
+    QList<DependentProduct> dependentProducts(const QStringList &filePaths,
+                                              ErrorInfo *error = nullptr) const;
 
 
     class BuildGraphInfo
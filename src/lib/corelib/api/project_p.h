@@ -43,12 +43,15 @@
 #include "rulecommand.h"
 #include "transformerdata.h"
 
+#include <buildgraph/reversedependencyindex.h>
 #include <language/language.h>
 #include <logging/logger.h>
 
 #include <QtCore/qobject.h>
 #include <QtCore/qstringlist.h>
 
+#include <memory>
+
 namespace qbs {
 class BuildJob;
 class BuildOptions;
@@ -118,6 +121,7 @@ public:
     void removeGroup(const ProductData &product, const GroupData &group);
 
     void prepareChangeToProject();
+    const ReverseDependencyIndex &reverseDependencyIndex();
 
     RuleCommandList ruleCommandListForTransformer(const Transformer *transformer);
     RuleCommandList ruleCommands(const ProductData &product,
@@ -132,6 +136,7 @@ private:
                              const ResolvedProjectConstPtr &internalProject);
 
     ProjectData m_projectData;
+    std::unique_ptr<ReverseDependencyIndex> m_reverseDependencyIndex;
 };
 
 } // namespace Internal
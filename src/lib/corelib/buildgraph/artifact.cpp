@@ -143,6 +143,12 @@ void Artifact::onChildDisconnected(BuildGraphNode *child)
     childrenAddedByScanner.remove(static_cast<Artifact *>(child));
 }
 
+void Artifact::timestampChanged()
+{
+    if (!product.expired() && product->buildData)
+        product->buildData->setDirty();
+}
+
 void Artifact::load(PersistentPool &pool)
 {
     FileResourceBase::load(pool);
@@ -128,6 +128,8 @@ public:
     void setDeregister(const Deregister &deregister) { m_deregister = deregister; }
 
 private:
+    void timestampChanged() override;
+
     FileTags m_fileTags;
     Deregister m_deregister;
 };
@@ -53,7 +53,8 @@
 #include <tools/fileinfo.h>
 #include <tools/progressobserver.h>
 #include <tools/qbsassert.h>
-#include <tools/stringconstants.h>
+#include <tools/stlutils.h>
+#include <tools/threadpool.h>
 
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qdir.h>
@@ -61,9 +62,22 @@
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qstring.h>
 
+#include <future>
+#include <iterator>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
+namespace {
+struct RemovalResult
+{
+    QString path;
+    bool existed = false;
+    QString error;
+};
+} // namespace
+
 static void printRemovalMessage(const QString &path, bool dryRun, const Logger &logger)
 {
     if (dryRun)
@@ -74,39 +88,66 @@ static void printRemovalMessage(const QString &path, bool dryRun, const Logger &
 
 static void invalidateArtifactTimestamp(Artifact *artifact)
 {
-    if (artifact->timestamp().isValid()) {
-        artifact->clearTimestamp();
-        artifact->product->topLevelProject()->buildData->setDirty();
+    artifact->clearTimestamp(); // Marks the product's build data as dirty if necessary.
+}
+
+// Runs in a worker thread, so it must not touch the build graph or the logger.
+static std::vector<RemovalResult> removeFilesFromDisk(const QStringList &filePaths, bool dryRun,
+                                                      const ProgressObserver *observer)
+{
+    std::vector<RemovalResult> results;
+    results.reserve(filePaths.size());
+    for (const QString &filePath : filePaths) {
+        if (observer->canceled())
+            break;
+        RemovalResult result{filePath};
+        const QFileInfo fileInfo(filePath);
+        result.existed = FileInfo::fileExists(fileInfo);
+        if (result.existed && !dryRun) {
+            QString errorMessage;
+            if (!removeFileRecursion(fileInfo, &errorMessage))
+                result.error = errorMessage;
+        }
+        results.push_back(std::move(result));
     }
+    return results;
 }
 
-static void removeArtifactFromDisk(Artifact *artifact, bool dryRun, const Logger &logger)
+// Collects the directories in the tree below and including dirPath that contain nothing
+// but other such directories, deepest first. Returns whether dirPath itself is one of them.
+static bool collectEmptyDirectories(const QString &dirPath, QStringList &emptyDirs)
 {
-    QFileInfo fileInfo(artifact->filePath());
-    if (!FileInfo::fileExists(fileInfo)) {
-        if (!dryRun)
-            invalidateArtifactTimestamp(artifact);
-        return;
+    bool isEmpty = true;
+    QDirIterator it(dirPath, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        if (!it.fileInfo().isSymLink() && it.fileInfo().isDir()) {
+            if (!collectEmptyDirectories(it.filePath(), emptyDirs))
+                isEmpty = false;
+        } else {
+            isEmpty = false;
+        }
     }
-    printRemovalMessage(fileInfo.filePath(), dryRun, logger);
-    if (dryRun)
-        return;
-    invalidateArtifactTimestamp(artifact);
-    QString errorMessage;
-    if (!removeFileRecursion(fileInfo, &errorMessage))
-        throw ErrorInfo(errorMessage);
+    if (isEmpty)
+        emptyDirs << dirPath;
+    return isEmpty;
+}
+
+static bool isInDirectory(const QString &path, const QString &dirPath)
+{
+    return path.startsWith(dirPath) && path.size() > dirPath.size()
+            && path.at(dirPath.size()) == QLatin1Char('/');
 }
 
+// Only collects the files to remove; the removal itself happens in ArtifactCleaner::cleanup(),
+// outside of the build graph traversal.
 class CleanupVisitor : public ArtifactVisitor
 {
 public:
-    CleanupVisitor(CleanOptions options, const ProgressObserver *observer,
-                   Logger logger)
+    CleanupVisitor(bool dryRun, const ProgressObserver *observer)
         : ArtifactVisitor(Artifact::Generated)
-        , m_options(std::move(options))
+        , m_dryRun(dryRun)
         , m_observer(observer)
-        , m_logger(std::move(logger))
-        , m_hasError(false)
     {
     }
 
@@ -117,17 +158,12 @@ public:
         const AllRescuableArtifactData rescuableArtifactData
                 = product->buildData->rescuableArtifactData();
         for (auto it = rescuableArtifactData.begin(); it != rescuableArtifactData.end(); ++it) {
-            Artifact tmp;
-            tmp.product = product;
-            tmp.setFilePath(it.key());
-            tmp.setTimestamp(it.value().timeStamp);
-            removeArtifactFromDisk(&tmp, m_options.dryRun(), m_logger);
+            m_filePaths << it.key();
             product->buildData->removeFromRescuableArtifactData(it.key());
         }
     }
 
-    const Set<QString> &directories() const { return m_directories; }
-    bool hasError() const { return m_hasError; }
+    const QStringList &filePaths() const { return m_filePaths; }
 
 private:
     void doVisit(Artifact *artifact) override
@@ -137,23 +173,15 @@ private:
 
         if (artifact->product != m_product)
             return;
-        try {
-            removeArtifactFromDisk(artifact, m_options.dryRun(), m_logger);
-        } catch (const ErrorInfo &error) {
-            if (!m_options.keepGoing())
-                throw;
-            m_logger.printWarning(error);
-            m_hasError = true;
-        }
-        m_directories << artifact->dirPath();
+        if (!m_dryRun)
+            invalidateArtifactTimestamp(artifact);
+        m_filePaths << artifact->filePath();
     }
 
-    const CleanOptions m_options;
+    const bool m_dryRun;
     const ProgressObserver * const m_observer;
-    Logger m_logger;
-    bool m_hasError;
     ResolvedProductConstPtr m_product;
-    Set<QString> m_directories;
+    QStringList m_filePaths;
 };
 
 ArtifactCleaner::ArtifactCleaner(Logger logger, ProgressObserver *observer)
@@ -169,63 +197,107 @@ void ArtifactCleaner::cleanup(const TopLevelProjectPtr &project,
     const QString configString = Tr::tr(" for configuration %1").arg(project->id());
     m_observer->initialize(Tr::tr("Cleaning up%1").arg(configString), products.size() + 1);
 
-    Set<QString> directories;
+    // Collecting the files touches the build graph, so it happens in this thread.
+    std::vector<QStringList> filePathsPerProduct;
+    filePathsPerProduct.reserve(products.size());
     for (const ResolvedProductPtr &product : products) {
-        CleanupVisitor visitor(options, m_observer, m_logger);
+        CleanupVisitor visitor(options.dryRun(), m_observer);
         visitor.visitProduct(product);
-        directories.unite(visitor.directories());
-        if (visitor.hasError())
-            m_hasError = true;
+        filePathsPerProduct.push_back(visitor.filePaths());
+    }
+
+    // The removal is pure I/O, so it is spread over the I/O pool in batches, leaving the
+    // global pool to the other jobs. The progress advances as soon as all batches of
+    // a product are done. All batches are done before any error is reported.
+    static const int batchSize = 64;
+    ThreadPool &threadPool = ThreadPool::ioInstance();
+    std::vector<std::vector<std::future<std::vector<RemovalResult>>>> futuresPerProduct;
+    futuresPerProduct.reserve(filePathsPerProduct.size());
+    for (const QStringList &filePaths : filePathsPerProduct) {
+        std::vector<std::future<std::vector<RemovalResult>>> futures;
+        for (int i = 0; i < filePaths.size(); i += batchSize) {
+            futures.push_back(threadPool.run([batch = filePaths.mid(i, batchSize),
+                                              dryRun = options.dryRun(), observer = m_observer] {
+                return removeFilesFromDisk(batch, dryRun, observer);
+            }));
+        }
+        futuresPerProduct.push_back(std::move(futures));
+    }
+    std::vector<RemovalResult> results;
+    for (auto &futures : futuresPerProduct) {
+        for (auto &future : futures) {
+            const std::vector<RemovalResult> batchResults = future.get();
+            std::copy(batchResults.begin(), batchResults.end(), std::back_inserter(results));
+        }
         m_observer->incrementProgressValue();
     }
+    if (m_observer->canceled())
+        throw ErrorInfo(Tr::tr("Cleaning up was canceled."));
+    for (const RemovalResult &result : results) {
+        if (result.existed)
+            printRemovalMessage(result.path, options.dryRun(), m_logger);
+        if (result.error.isEmpty())
+            continue;
+        const ErrorInfo error(result.error);
+        if (!options.keepGoing())
+            throw error;
+        m_logger.printWarning(error);
+        m_hasError = true;
+    }
 
     // Directories created during the build are not artifacts (TODO: should they be?),
-    // so we have to clean them up manually.
-    auto dirList = rangeTo<QStringList>(directories);
-    for (int i = 0; i < dirList.size(); ++i) {
-        const QString &dir = dirList.at(i);
-        if (!dir.startsWith(project->buildDirectory))
-            continue;
-        if (FileInfo(dir).exists())
-            removeEmptyDirectories(dir, options);
-        if (dir != project->buildDirectory) {
-            const QString parentDir = QDir::cleanPath(dir + StringConstants::slashDotDot());
-            if (parentDir != project->buildDirectory && !dirList.contains(parentDir))
-                dirList.push_back(parentDir);
+    // so we have to clean them up manually. Each affected top-level directory below the
+    // build directory is scanned exactly once, with the scans running in parallel.
+    const QString &buildDir = project->buildDirectory;
+    Set<QString> rootDirs;
+    for (const QStringList &filePaths : filePathsPerProduct) {
+        for (const QString &filePath : filePaths) {
+            QString dir = FileInfo::path(filePath);
+            if (dir != buildDir && !isInDirectory(dir, buildDir))
+                continue;
+            while (dir != buildDir) {
+                const QString parentDir = FileInfo::path(dir);
+                if (parentDir == buildDir)
+                    break;
+                dir = parentDir;
+            }
+            rootDirs << dir;
         }
     }
-    m_observer->incrementProgressValue();
-
-    if (m_hasError)
-        throw ErrorInfo(Tr::tr("Failed to remove some files."));
-    m_observer->setFinished();
-}
+    if (rootDirs.contains(buildDir))
+        rootDirs = {buildDir};
+    const std::vector<QStringList> emptyDirsPerRoot = threadPool.mapped(
+            rangeTo<QStringList>(rootDirs), [](const QString &rootDir) {
+        QStringList emptyDirs;
+        if (FileInfo(rootDir).exists())
+            collectEmptyDirectories(rootDir, emptyDirs);
+        return emptyDirs;
+    }, 1);
 
-void ArtifactCleaner::removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
-                                             bool *isEmpty)
-{
-    bool subTreeIsEmpty = true;
-    QDirIterator it(rootDir, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot);
-    while (it.hasNext()) {
-        it.next();
-        if (!it.fileInfo().isSymLink() && it.fileInfo().isDir())
-            removeEmptyDirectories(it.filePath(), options, &subTreeIsEmpty);
-        else
-            subTreeIsEmpty = false;
-    }
-    if (subTreeIsEmpty) {
-        printRemovalMessage(rootDir, options.dryRun(), m_logger);
-        if (!QDir::root().rmdir(rootDir)) {
-            ErrorInfo error(Tr::tr("Failure to remove empty directory '%1'.").arg(rootDir));
+    // Deepest directories come first, so a single pass removes whole empty trees.
+    QStringList failedDirs;
+    for (const QStringList &emptyDirs : emptyDirsPerRoot) {
+        for (const QString &dir : emptyDirs) {
+            if (Internal::any_of(failedDirs, [&dir](const QString &failedDir) {
+                    return isInDirectory(failedDir, dir); })) {
+                continue;
+            }
+            printRemovalMessage(dir, options.dryRun(), m_logger);
+            if (options.dryRun() || QDir::root().rmdir(dir))
+                continue;
+            ErrorInfo error(Tr::tr("Failure to remove empty directory '%1'.").arg(dir));
             if (!options.keepGoing())
                 throw error;
             m_logger.printWarning(error);
             m_hasError = true;
-            subTreeIsEmpty = false;
+            failedDirs << dir;
         }
     }
-    if (!subTreeIsEmpty && isEmpty)
-        *isEmpty = false;
+    m_observer->incrementProgressValue();
+
+    if (m_hasError)
+        throw ErrorInfo(Tr::tr("Failed to remove some files."));
+    m_observer->setFinished();
 }
 
 } // namespace Internal
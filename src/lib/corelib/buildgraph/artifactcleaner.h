@@ -58,9 +58,6 @@ public:
                  const CleanOptions &options);
 
 private:
-    void removeEmptyDirectories(const QString &rootDir, const CleanOptions &options,
-                                bool *isEmpty = nullptr);
-
     Logger m_logger;
     bool m_hasError = false;
     ProgressObserver *m_observer = nullptr;
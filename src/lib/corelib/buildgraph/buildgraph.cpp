@@ -66,6 +66,7 @@
 #include <tools/scripttools.h>
 #include <tools/stlutils.h>
 #include <tools/stringconstants.h>
+#include <tools/threadpool.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfile.h>
@@ -498,19 +499,25 @@ void setupScriptEngineForProduct(ScriptEngine *engine, ResolvedProduct *product,
         scriptClass = engine->productPropertyScriptClass();
     }
     setupBaseProductScriptValue(engine, product);
+
     JSValue productScriptValue = JS_NewObjectClass(engine->context(), scriptClass);
     attachPointerTo(productScriptValue, product);
     setJsProperty(engine->context(), targetObject, StringConstants::productVar(),
                   productScriptValue);
 
-    JSValue data = JS_NewObjectClass(engine->context(), engine->dataWithPtrClass());
-    // If the Rule is in a Module, set up the 'moduleName' property
-    if (!module->name.isEmpty()) {
-        JS_SetPropertyUint32(engine->context(), data, ModuleNameKey,
-                             makeJsString(engine->context(), module->name));
+    // Scripts may add properties to the product object, so only its internal data is shared
+    // by all rules, commands and scanners of the same module in the product.
+    JSValue &data = engine->productDataScriptValue(product, module->name);
+    if (!JS_IsObject(data)) {
+        data = JS_NewObjectClass(engine->context(), engine->dataWithPtrClass());
+        // If the Rule is in a Module, set up the 'moduleName' property
+        if (!module->name.isEmpty()) {
+            JS_SetPropertyUint32(engine->context(), data, ModuleNameKey,
+                                 makeJsString(engine->context(), module->name));
+        }
     }
     defineJsProperty(engine->context(), productScriptValue,
-                     StringConstants::dataPropertyInternal(), data);
+                     StringConstants::dataPropertyInternal(), JS_DupValue(engine->context(), data));
 }
 
 bool findPath(BuildGraphNode *u, BuildGraphNode *v, QList<BuildGraphNode *> &path)
@@ -539,7 +546,10 @@ void connect(BuildGraphNode *p, BuildGraphNode *c)
     QBS_CHECK(p != c);
     if (c->type() == BuildGraphNode::ArtifactNodeType) {
         auto const ac = static_cast<Artifact *>(c);
-        for (const Artifact *child : filterByType<Artifact>(p->children)) {
+        if (p->children.contains(ac))
+            return;
+
+        const auto checkForClash = [p, ac](const Artifact *child) {
             if (child == ac)
                 return;
             const bool filePathsMustBeDifferent = child->artifactType == Artifact::Generated
@@ -550,11 +560,32 @@ void connect(BuildGraphNode *p, BuildGraphNode *c)
                                                                              ac->filePath()),
                                 CodeLocation(), true);
             }
+        };
+
+        // Only artifacts with the same file path can clash. Looking them up is much cheaper
+        // than iterating over all children of p, of which there can be tens of thousands.
+        // The look-up table is only conclusive if it knows about the new child, though.
+        const TopLevelProject * const project = p->product
+                ? p->product->topLevelProject() : nullptr;
+        const ProjectBuildData * const buildData = project ? project->buildData.get() : nullptr;
+        const std::vector<FileResourceBase *> * const sameFiles = buildData
+                ? &buildData->lookupFiles(ac) : nullptr;
+        if (sameFiles && contains(*sameFiles, ac)) {
+            for (FileResourceBase * const file : *sameFiles) {
+                if (file->fileType() != FileResourceBase::FileTypeArtifact)
+                    continue;
+                const auto child = static_cast<Artifact *>(file);
+                if (p->children.contains(child))
+                    checkForClash(child);
+            }
+        } else {
+            for (const Artifact * const child : filterByType<Artifact>(p->children))
+                checkForClash(child);
         }
     }
     p->children.insert(c);
     c->parents.insert(p);
-    p->product->topLevelProject()->buildData->setDirty();
+    setProductBuildDataDirty(p);
 }
 
 static bool existsPath_impl(BuildGraphNode *u, BuildGraphNode *v, NodeSet *seen)
@@ -607,6 +638,13 @@ void disconnect(BuildGraphNode *u, BuildGraphNode *v)
     u->children.remove(v);
     v->parents.remove(u);
     u->onChildDisconnected(v);
+    setProductBuildDataDirty(u);
+}
+
+void setProductBuildDataDirty(const BuildGraphNode *node)
+{
+    if (const ResolvedProduct * const product = node->product.get(); product && product->buildData)
+        product->buildData->setDirty();
 }
 
 void removeGeneratedArtifactFromDisk(Artifact *artifact, const Logger &logger)
@@ -795,12 +833,11 @@ void invalidateArtifactAsRuleInputIfNecessary(Artifact *artifact)
     }
 }
 
+// Only reads the build graph, so it can run for several products concurrently.
 static void doSanityChecksForProduct(const ResolvedProductConstPtr &product,
-        const Set<ResolvedProductPtr> &allProducts, const Logger &logger)
+                                     const Set<ResolvedProductPtr> &allProducts)
 {
     qCDebug(lcBuildGraph) << "Sanity checking product" << product->uniqueName();
-    CycleDetector cycleDetector(logger);
-    cycleDetector.visitProduct(product);
     const ProductBuildData * const buildData = product->buildData.get();
     for (const auto &m : product->modules)
         QBS_CHECK(m->product == product.get());
@@ -897,18 +934,16 @@ static void doSanityChecksForProduct(const ResolvedProductConstPtr &product,
     }
 }
 
-static void doSanityChecks(const ResolvedProjectPtr &project,
-                           const Set<ResolvedProductPtr> &allProducts, Set<QString> &productNames,
+static void doSanityChecks(const ResolvedProjectPtr &project, Set<QString> &productNames,
                            const Logger &logger)
 {
     logger.qbsDebug() << "Sanity checking project '" << project->name << "'";
     for (const ResolvedProjectPtr &subProject : std::as_const(project->subProjects))
-        doSanityChecks(subProject, allProducts, productNames, logger);
+        doSanityChecks(subProject, productNames, logger);
 
     for (const auto &product : project->products) {
         QBS_CHECK(product->project == project);
         QBS_CHECK(product->topLevelProject() == project->topLevelProject());
-        doSanityChecksForProduct(product, allProducts, logger);
         QBS_CHECK(!productNames.contains(product->uniqueName()));
         productNames << product->uniqueName();
     }
@@ -919,8 +954,19 @@ void doSanityChecks(const ResolvedProjectPtr &project, const Logger &logger)
     if (qEnvironmentVariableIsEmpty("QBS_SANITY_CHECKS"))
         return;
     Set<QString> productNames;
-    const auto allProducts = rangeTo<Set<ResolvedProductPtr>>(project->allProducts());
-    doSanityChecks(project, allProducts, productNames, logger);
+    doSanityChecks(project, productNames, logger);
+
+    // The project-level checks above also set up the products' cached top-level project
+    // pointers, so from here on the build graph is only read.
+    const std::vector<ResolvedProductPtr> products = project->allProducts();
+    const auto allProducts = rangeTo<Set<ResolvedProductPtr>>(products);
+    ThreadPool::globalInstance().runChunks(int(products.size()) + 1,
+                                           [&products, &allProducts](int check) {
+        if (check == 0)
+            CycleDetector().visitProducts(products);
+        else
+            doSanityChecksForProduct(products.at(check - 1), allProducts);
+    });
 }
 
 } // namespace Internal
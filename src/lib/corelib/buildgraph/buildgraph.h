@@ -88,6 +88,9 @@ void removeGeneratedArtifactFromDisk(const QString &filePath, const Logger &logg
 
 void disconnect(BuildGraphNode *u, BuildGraphNode *v);
 
+// To be called when something that gets stored for the node has changed.
+void setProductBuildDataDirty(const BuildGraphNode *node);
+
 void setupScriptEngineForFile(ScriptEngine *engine, const FileContextBaseConstPtr &fileContext,
         JSValue targetObject, const ObserveMode &observeMode);
 void setupScriptEngineForProduct(ScriptEngine *engine, ResolvedProduct *product,
@@ -307,27 +307,35 @@ void BuildGraphLoader::trackProjectChanges()
     std::vector<ResolvedProductPtr> allRestoredProducts = restoredProject->allProducts();
     std::vector<ResolvedProductPtr> changedProducts;
     bool reResolvingNecessary = false;
+
+    // Products can only be taken over from the earlier resolve if nothing but project files
+    // have changed, as we can attribute those to the products using them.
+    bool productsCanBeReused = true;
+
     if (!checkConfigCompatibility()) {
         m_logger.qbsInfo() << Tr::tr("One or more properties have changed.");
         reResolvingNecessary = true;
+        productsCanBeReused = false;
     }
     if (hasProductFileChanged(allRestoredProducts, restoredProject->lastStartResolveTime,
                               buildSystemFiles, changedProducts)) {
         reResolvingNecessary = true;
     }
+    if (hasBuildSystemFileChanged(buildSystemFiles, restoredProject.get()))
+        reResolvingNecessary = true;
 
     // "External" changes, e.g. in the environment or in a JavaScript file,
     // can make the list of source files in a product change without the respective file
     // having been touched. In such a case, the build data for that product will have to be set up
     // anew.
     if (probeExecutionForced(restoredProject, allRestoredProducts)
-            || hasBuildSystemFileChanged(buildSystemFiles, restoredProject.get())
             || hasEnvironmentChanged(restoredProject)
             || hasCanonicalFilePathResultChanged(restoredProject)
             || hasFileExistsResultChanged(restoredProject)
             || hasDirectoryEntriesResultChanged(restoredProject)
             || hasFileLastModifiedResultChanged(restoredProject)) {
         reResolvingNecessary = true;
+        productsCanBeReused = false;
     }
 
     if (!reResolvingNecessary) {
@@ -356,12 +364,31 @@ void BuildGraphLoader::trackProjectChanges()
         resolver.setStoredModuleProviderInfo(restoredProject->moduleProviderInfo);
     resolver.setLastResolveTime(restoredProject->lastStartResolveTime);
     QHash<QString, std::vector<ProbeConstPtr>> restoredProbes;
-    for (const auto &restoredProduct : std::as_const(allRestoredProducts))
+    QHash<QString, qint64> restoredResolveTimes;
+    for (const auto &restoredProduct : std::as_const(allRestoredProducts)) {
         restoredProbes.insert(restoredProduct->uniqueName(), restoredProduct->probes);
+        restoredResolveTimes.insert(restoredProduct->uniqueName(), restoredProduct->resolveTime);
+    }
     resolver.setOldProductProbes(restoredProbes);
+    resolver.setOldProductResolveTimes(restoredResolveTimes);
+    const QHash<QString, ResolvedProductPtr> reusableProducts = productsCanBeReused
+            ? findReusableProducts(allRestoredProducts, changedProducts)
+            : QHash<QString, ResolvedProductPtr>();
+    resolver.setReusableProducts(reusableProducts, restoredProject);
     if (!m_parameters.overrideBuildGraphData())
         resolver.setStoredProfiles(restoredProject->profileConfigs);
-    m_result.newlyResolvedProject = resolver.resolve();
+    std::vector<std::pair<ResolvedProductPtr, ResolvedProjectPtr>> originalProjects;
+    for (const ResolvedProductPtr &product : reusableProducts)
+        originalProjects.emplace_back(product, product->project.lock());
+    try {
+        m_result.newlyResolvedProject = resolver.resolve();
+    } catch (...) {
+        // The restored project might still be in use, so re-used products must not stay
+        // attached to the aborted new one.
+        for (const auto &productAndProject : originalProjects)
+            productAndProject.first->project = productAndProject.second;
+        throw;
+    }
 
     std::vector<ResolvedProductPtr> allNewlyResolvedProducts
             = m_result.newlyResolvedProject->allProducts();
@@ -629,11 +656,13 @@ bool BuildGraphLoader::hasProductFileChanged(const std::vector<ResolvedProductPt
 bool BuildGraphLoader::hasBuildSystemFileChanged(const Set<QString> &buildSystemFiles,
                                                  const TopLevelProject *restoredProject)
 {
+    bool hasChanged = false;
     for (const QString &file : buildSystemFiles) {
         const FileInfo fi(file);
         if (!fi.exists()) {
             m_removedProjectFiles << file;
-            return true;
+            hasChanged = true;
+            continue;
         }
         const auto generatedChecker = [&file, restoredProject](const auto &item) {
             const ModuleProviderInfo &mpi = item.second;
@@ -645,10 +674,52 @@ bool BuildGraphLoader::hasBuildSystemFileChanged(const Set<QString> &buildSystem
                 ? restoredProject->lastEndResolveTime : restoredProject->lastStartResolveTime;
         if (referenceTime < fi.lastModified()) {
             m_changedProjectFiles << file;
-            return true;
+            hasChanged = true;
         }
     }
-    return false;
+    return hasChanged;
+}
+
+QHash<QString, ResolvedProductPtr> BuildGraphLoader::findReusableProducts(
+        const std::vector<ResolvedProductPtr> &restoredProducts,
+        const std::vector<ResolvedProductPtr> &changedProducts) const
+{
+    Set<QString> changedFiles = m_changedProjectFiles;
+    changedFiles.unite(m_removedProjectFiles);
+    Set<QString> unattributedFiles = changedFiles;
+    std::vector<ResolvedProductPtr> affectedProducts = changedProducts;
+    for (const ResolvedProductPtr &product : restoredProducts) {
+        bool isAffected = product->buildSystemFiles.empty();
+        for (const QString &file : changedFiles) {
+            if (product->buildSystemFiles.contains(file)) {
+                unattributedFiles.remove(file);
+                isAffected = true;
+            }
+        }
+        if (isAffected && !contains(affectedProducts, product))
+            affectedProducts.push_back(product);
+    }
+
+    // A file that no product was set up from, e.g. a module file that has not been
+    // loaded before, could potentially affect every product.
+    if (!unattributedFiles.empty()) {
+        qCDebug(lcBuildGraph) << "changed file" << *unattributedFiles.cbegin()
+                              << "does not belong to a product, re-resolving everything";
+        return {};
+    }
+
+    // Products whose dependencies are affected are affected themselves, as they
+    // see the Export items and properties of these dependencies.
+    makeChangedProductsListComplete(affectedProducts, restoredProducts);
+
+    QHash<QString, ResolvedProductPtr> reusableProducts;
+    for (const ResolvedProductPtr &product : restoredProducts) {
+        if (!contains(affectedProducts, product))
+            reusableProducts.insert(product->uniqueName(), product);
+    }
+    qCDebug(lcBuildGraph) << reusableProducts.size() << "of" << restoredProducts.size()
+                          << "products are not affected by the changes";
+    return reusableProducts;
 }
 
 void BuildGraphLoader::markTransformersForChangeTracking(
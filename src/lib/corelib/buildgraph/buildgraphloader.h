@@ -99,6 +99,9 @@ private:
                                std::vector<ResolvedProductPtr> &productsWithChangedFiles);
     bool hasBuildSystemFileChanged(const Set<QString> &buildSystemFiles,
                                    const TopLevelProject *restoredProject);
+    QHash<QString, ResolvedProductPtr> findReusableProducts(
+            const std::vector<ResolvedProductPtr> &restoredProducts,
+            const std::vector<ResolvedProductPtr> &changedProducts) const;
     void markTransformersForChangeTracking(const std::vector<ResolvedProductPtr> &restoredProducts);
     void checkAllProductsForChanges(const std::vector<ResolvedProductPtr> &restoredProducts,
             std::vector<ResolvedProductPtr> &changedProducts);
@@ -50,7 +50,7 @@ namespace Internal {
 
 class BuildGraphVisitor;
 
-class BuildGraphNode
+class BuildGraphNode : public PersistentObject
 {
     friend NodeSet;
 public:
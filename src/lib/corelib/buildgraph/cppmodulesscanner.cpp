@@ -102,6 +102,7 @@ static RawScanResult runScannerForArtifact(const Artifact *artifact)
             scanData.rawScanResult.requiresModules += QString::fromUtf8(module);
 
         scanData.lastScanTime = FileTime::currentTime();
+        artifact->product->topLevelProject()->buildData->setRawScanResultsDirty();
     }
     return scanData.rawScanResult;
 }
@@ -39,8 +39,7 @@
 #include "cycledetector.h"
 
 #include "artifact.h"
-#include "buildgraph.h"
-#include "projectbuilddata.h"
+#include "productbuilddata.h"
 #include "rulenode.h"
 
 #include <language/language.h>
@@ -48,62 +47,134 @@
 #include <tools/error.h>
 #include <tools/qttools.h>
 
+#include <unordered_map>
+
 namespace qbs {
 namespace Internal {
 
-CycleDetector::CycleDetector(Logger logger)
-    : m_parent(nullptr), m_logger(std::move(logger))
-{
-}
-
 void CycleDetector::visitProject(const TopLevelProjectConstPtr &project)
 {
-    project->accept(this);
+    visitProducts(project->allProducts());
 }
 
 void CycleDetector::visitProduct(const ResolvedProductConstPtr &product)
 {
-    product->accept(this);
+    if (product->buildData)
+        visitRootNodes(product->buildData->rootNodes());
 }
 
-bool CycleDetector::visit(Artifact *artifact)
+void CycleDetector::visitProducts(const std::vector<ResolvedProductPtr> &products)
 {
-    return visitNode(artifact);
+    NodeSet rootNodes;
+    for (const ResolvedProductPtr &product : products) {
+        if (product->buildData)
+            rootNodes.unite(product->buildData->rootNodes());
+    }
+    visitRootNodes(rootNodes);
 }
 
-bool CycleDetector::visit(RuleNode *ruleNode)
+// Tarjan's algorithm, with an explicit stack instead of recursion. A strongly connected
+// component with more than one node, or a node that is its own child, means there is a cycle.
+void CycleDetector::visitRootNodes(const NodeSet &rootNodes)
 {
-    return visitNode(ruleNode);
-}
+    struct NodeData
+    {
+        int index = 0;
+        int lowLink = 0;
+        bool onStack = false;
+    };
+    struct Frame
+    {
+        BuildGraphNode *node;
+        NodeSet::const_iterator nextChild;
+    };
 
-bool CycleDetector::visitNode(BuildGraphNode *node)
-{
-    if (Q_UNLIKELY(m_nodesInCurrentPath.contains(node))) {
-        ErrorInfo error(Tr::tr("Cycle in build graph detected."));
-        const auto nodes = cycle(node);
-        for (const BuildGraphNode * const n : nodes)
-            error.append(n->toString());
-        throw error;
-    }
+    std::unordered_map<BuildGraphNode *, NodeData> nodeData;
+    std::vector<BuildGraphNode *> componentStack;
+    std::vector<Frame> path;
+    int nextIndex = 0;
+    const auto push = [&](BuildGraphNode *node) {
+        NodeData &data = nodeData[node];
+        data.index = data.lowLink = nextIndex++;
+        data.onStack = true;
+        componentStack.push_back(node);
+        path.push_back({node, node->children.constBegin()});
+    };
+
+    for (BuildGraphNode * const root : rootNodes) {
+        if (nodeData.find(root) != nodeData.cend())
+            continue;
+        push(root);
+        while (!path.empty()) {
+            Frame &frame = path.back();
+            if (frame.nextChild != frame.node->children.constEnd()) {
+                BuildGraphNode * const child = *frame.nextChild++;
+                if (Q_UNLIKELY(child == frame.node))
+                    throwCycleError(child, NodeSet{child});
+                const auto it = nodeData.find(child);
+                if (it == nodeData.cend()) {
+                    push(child);
+                } else if (it->second.onStack) {
+                    NodeData &data = nodeData[frame.node];
+                    data.lowLink = std::min(data.lowLink, it->second.index);
+                }
+                continue;
+            }
 
-    if (m_allNodes.contains(node))
-        return false;
+            BuildGraphNode * const node = frame.node;
+            path.pop_back();
+            NodeData &data = nodeData[node];
+            if (data.lowLink == data.index) {
+                if (Q_UNLIKELY(componentStack.back() != node)) {
+                    NodeSet component;
+                    while (componentStack.back() != node) {
+                        component.insert(componentStack.back());
+                        componentStack.pop_back();
+                    }
+                    component.insert(node);
+                    throwCycleError(node, component);
+                }
+                componentStack.pop_back();
+                data.onStack = false;
+            }
+            if (!path.empty()) {
+                NodeData &parentData = nodeData[path.back().node];
+                parentData.lowLink = std::min(parentData.lowLink, data.lowLink);
+            }
+        }
+    }
+}
 
-    m_nodesInCurrentPath += node;
-    m_parent = node;
-    for (BuildGraphNode * const child : std::as_const(node->children))
-        child->accept(this);
-    m_nodesInCurrentPath -= node;
-    m_allNodes += node;
-    return false;
+void CycleDetector::throwCycleError(BuildGraphNode *node, const NodeSet &component)
+{
+    ErrorInfo error(Tr::tr("Cycle in build graph detected."));
+    const auto nodes = cycle(node, component);
+    for (const BuildGraphNode * const n : nodes)
+        error.append(n->toString());
+    throw error;
 }
 
-QList<BuildGraphNode *> CycleDetector::cycle(BuildGraphNode *doubleEntry)
+// A shortest path from the node back to itself within its strongly connected component,
+// with the node appearing at both ends.
+QList<BuildGraphNode *> CycleDetector::cycle(BuildGraphNode *node, const NodeSet &component)
 {
-    QList<BuildGraphNode *> path;
-    findPath(doubleEntry, m_parent, path);
-    path.push_back(doubleEntry);
-    return path;
+    std::unordered_map<BuildGraphNode *, BuildGraphNode *> predecessors;
+    std::vector<BuildGraphNode *> queue{node};
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        BuildGraphNode * const current = queue.at(i);
+        for (BuildGraphNode * const child : std::as_const(current->children)) {
+            if (child == node) {
+                QList<BuildGraphNode *> path{node};
+                for (BuildGraphNode *n = current; n != node; n = predecessors.at(n))
+                    path.insert(1, n);
+                path.push_back(node);
+                return path;
+            }
+            if (component.contains(child) && predecessors.emplace(child, current).second)
+                queue.push_back(child);
+        }
+    }
+    return {node};
 }
 
 } // namespace Internal
@@ -39,36 +39,34 @@
 #ifndef QBS_CYCLEDETECTOR_H
 #define QBS_CYCLEDETECTOR_H
 
-#include "buildgraphvisitor.h"
 #include "nodeset.h"
 #include <language/forward_decls.h>
-#include <logging/logger.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qlist.h>
+
+#include <vector>
 
 namespace qbs {
 namespace Internal {
 
 class BuildGraphNode;
 
-class QBS_AUTOTEST_EXPORT CycleDetector : private BuildGraphVisitor
+// Finds cycles among the nodes reachable from the products' root nodes by computing the
+// strongly connected components of the graph. The traversal is iterative, so the depth of
+// the graph is not limited by the size of the stack.
+class QBS_AUTOTEST_EXPORT CycleDetector
 {
 public:
-    CycleDetector(Logger logger);
-
     void visitProject(const TopLevelProjectConstPtr &project);
     void visitProduct(const ResolvedProductConstPtr &product);
+    void visitProducts(const std::vector<ResolvedProductPtr> &products);
 
 private:
-    bool visit(Artifact *artifact) override;
-    bool visit(RuleNode *ruleNode) override;
-
-    bool visitNode(BuildGraphNode *node);
-
-    QList<BuildGraphNode *> cycle(BuildGraphNode *doubleEntry);
+    void visitRootNodes(const NodeSet &rootNodes);
+    [[noreturn]] void throwCycleError(BuildGraphNode *node, const NodeSet &component);
 
-    NodeSet m_allNodes;
-    NodeSet m_nodesInCurrentPath;
-    BuildGraphNode *m_parent;
-    Logger m_logger;
+    static QList<BuildGraphNode *> cycle(BuildGraphNode *node, const NodeSet &component);
 };
 
 } // namespace Internal
@@ -46,6 +46,7 @@
 #include "cycledetector.h"
 #include "executorjob.h"
 #include "inputartifactscanner.h"
+#include "jscommandexecutor.h"
 #include "productinstaller.h"
 #include "rescuableartifactdata.h"
 #include "rulecommands.h"
@@ -56,6 +57,7 @@
 #include <buildgraph/transformer.h>
 #include <language/language.h>
 #include <language/propertymapinternal.h>
+#include <language/scriptcompilationcache.h>
 #include <language/scriptengine.h>
 #include <logging/categories.h>
 #include <logging/translator.h>
@@ -69,6 +71,7 @@
 #include <tools/settings.h>
 #include <tools/stlutils.h>
 #include <tools/stringconstants.h>
+#include <tools/threadpool.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qtimer.h>
@@ -235,6 +238,7 @@ void Executor::doBuild()
         qCDebug(lcExec) << "max job count not explicitly set, using value of"
                         << m_buildOptions.maxJobCount();
     }
+    ThreadPool::globalInstance().setMaxThreadCount(m_buildOptions.maxJobCount());
     QBS_CHECK(m_state == ExecutorIdle);
     m_leaves = Leaves();
     m_error.clear();
@@ -279,6 +283,10 @@ void Executor::doBuild()
     QBS_CHECK(!m_project->buildData->evaluationContext);
     m_project->buildData->evaluationContext = std::make_shared<RulesEvaluationContext>(m_logger);
     m_evalContext = m_project->buildData->evaluationContext;
+    if (!m_buildOptions.dryRun()) {
+        m_evalContext->engine()->setByteCodeCacheDirectory(
+                    ScriptCompilationCache::diskCacheDirectory(m_project->buildDirectory));
+    }
     m_progressObserver->addScriptEngine(m_evalContext->engine());
 
     m_elapsedTimeRules = m_elapsedTimeScanners = m_elapsedTimeInstalling = 0;
@@ -584,13 +592,18 @@ void Executor::finishJob(ExecutorJob *job, bool success)
     m_processingJobs.erase(it);
     m_availableJobs.push_back(job);
     updateJobCounts(transformer.get(), -1);
+
+    // The job has updated the transformer's change tracking data.
+    setProductBuildDataDirty(*transformer->outputs.cbegin());
+
     if (success) {
-        m_project->buildData->setDirty();
         for (Artifact * const artifact : std::as_const(transformer->outputs)) {
             if (artifact->alwaysUpdated) {
                 artifact->setTimestamp(FileTime::currentTime());
-                for (Artifact * const parent : artifact->parentArtifacts())
+                for (Artifact * const parent : artifact->parentArtifacts()) {
                     parent->transformer->markedForRerun = true;
+                    setProductBuildDataDirty(parent);
+                }
                 if (m_buildOptions.forceOutputCheck()
                         && !m_buildOptions.dryRun() && !FileInfo(artifact->filePath()).exists()) {
                     if (transformer->rule) {
@@ -787,10 +800,12 @@ void Executor::addExecutorJobs()
     qCDebug(lcExec) << "preparing executor for" << count << "jobs in parallel";
     m_allJobs.reserve(count);
     m_availableJobs.reserve(count);
+    m_jsCommandEnginePool = std::make_unique<JsCommandEnginePool>(m_logger);
     for (int i = 1; i <= count; i++) {
         m_allJobs.push_back(std::make_unique<ExecutorJob>(m_logger));
         const auto job = m_allJobs.back().get();
         job->setMainThreadScriptEngine(m_evalContext->engine());
+        job->setJsCommandEnginePool(m_jsCommandEnginePool.get());
         job->setObjectName(QStringLiteral("J%1").arg(i));
         job->setDryRun(m_buildOptions.dryRun());
         job->setEchoMode(m_buildOptions.echoMode());
@@ -1040,7 +1055,10 @@ void Executor::runTransformer(const TransformerPtr &transformer)
 
 void Executor::finishTransformer(const TransformerPtr &transformer)
 {
-    transformer->markedForRerun = false;
+    if (transformer->markedForRerun) {
+        transformer->markedForRerun = false;
+        setProductBuildDataDirty(*transformer->outputs.cbegin());
+    }
     for (Artifact * const artifact : std::as_const(transformer->outputs)) {
         possiblyInstallArtifact(artifact);
         finishArtifact(artifact);
@@ -1236,13 +1254,18 @@ void Executor::syncFileDependencies()
         FileDependency * const dep = *it;
         FileInfo fi(dep->filePath());
         if (fi.exists()) {
-            dep->setTimestamp(fi.lastModified());
+            const FileTime timestamp = fi.lastModified();
+            if (timestamp != dep->timestamp()) {
+                dep->setTimestamp(timestamp);
+                m_project->buildData->setFileDependencyDirty(dep);
+            }
             ++it;
             continue;
         }
         qCDebug(lcBuildGraph()) << "file dependency" << dep->filePath() << "no longer exists; "
                                    "removing from lookup table";
         m_project->buildData->removeFromLookupTable(dep);
+        m_project->buildData->setFileDependencyDirty(dep);
         bool isReferencedByArtifact = false;
         for (const auto &product : m_allProducts) {
             if (!product->buildData)
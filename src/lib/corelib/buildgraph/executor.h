@@ -66,6 +66,7 @@ namespace Internal {
 class ExecutorJob;
 class FileTime;
 class InputArtifactScannerContext;
+class JsCommandEnginePool;
 class ProductInstaller;
 class ProgressObserver;
 class RuleNode;
@@ -167,6 +168,7 @@ private:
     BuildOptions m_buildOptions;
     Logger m_logger;
     ProgressObserver *m_progressObserver;
+    std::unique_ptr<JsCommandEnginePool> m_jsCommandEnginePool; // Must outlive the jobs.
     std::vector<std::unique_ptr<ExecutorJob>> m_allJobs;
     QList<ExecutorJob*> m_availableJobs;
     ExecutorState m_state;
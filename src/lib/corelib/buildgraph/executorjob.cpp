@@ -79,6 +79,11 @@ void ExecutorJob::setMainThreadScriptEngine(ScriptEngine *engine)
     m_jsCommandExecutor->setMainThreadScriptEngine(engine);
 }
 
+void ExecutorJob::setJsCommandEnginePool(JsCommandEnginePool *pool)
+{
+    m_jsCommandExecutor->setEnginePool(pool);
+}
+
 void ExecutorJob::setDryRun(bool enabled)
 {
     m_processCommandExecutor->setDryRunEnabled(enabled);
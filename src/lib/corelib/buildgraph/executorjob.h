@@ -55,6 +55,7 @@ class ProcessResult;
 namespace Internal {
 class AbstractCommandExecutor;
 class ProductBuildData;
+class JsCommandEnginePool;
 class JsCommandExecutor;
 class Logger;
 class ProcessCommandExecutor;
@@ -69,6 +70,7 @@ public:
     ~ExecutorJob() override;
 
     void setMainThreadScriptEngine(ScriptEngine *engine);
+    void setJsCommandEnginePool(JsCommandEnginePool *pool);
     void setDryRun(bool enabled);
     void setEchoMode(CommandEchoMode echoMode);
     void run(Transformer *t);
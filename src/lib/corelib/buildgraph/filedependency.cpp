@@ -39,19 +39,23 @@
 
 #include "filedependency.h"
 
-#include <tools/fileinfo.h>
-
 namespace qbs {
 namespace Internal {
 
 FileResourceBase::FileResourceBase() = default;
 
-FileResourceBase::~FileResourceBase() = default;
+FileResourceBase::~FileResourceBase()
+{
+    if (m_path)
+        PathTable::instance().release(m_path);
+}
 
 void FileResourceBase::setTimestamp(const FileTime &t)
-
 {
+    if (t == m_timestamp)
+        return;
     m_timestamp = t;
+    timestampChanged();
 }
 
 const FileTime &FileResourceBase::timestamp() const
@@ -59,26 +63,37 @@ const FileTime &FileResourceBase::timestamp() const
     return m_timestamp;
 }
 
-void FileResourceBase::setFilePath(const QString &filePath)
+void FileResourceBase::clearTimestamp()
 {
-    m_filePath = filePath;
-    FileInfo::splitIntoDirectoryAndFileName(m_filePath, &m_dirPath, &m_fileName);
+    if (!m_timestamp.isValid())
+        return;
+    m_timestamp.clear();
+    timestampChanged();
 }
 
-const QString &FileResourceBase::filePath() const
+void FileResourceBase::setFilePath(const QString &filePath)
 {
-    return m_filePath;
+    const PathTable::Entry * const oldPath = m_path;
+    m_path = PathTable::instance().intern(filePath);
+    if (oldPath)
+        PathTable::instance().release(oldPath);
 }
 
+// The directory goes through the pool's string table, so it is stored only once per
+// build graph. The remainder keeps its leading slash, which makes the split unambiguous.
 void FileResourceBase::load(PersistentPool &pool)
 {
-    serializationOp<PersistentPool::Load>(pool);
-    FileInfo::splitIntoDirectoryAndFileName(m_filePath, &m_dirPath, &m_fileName);
+    const QString dirPath = pool.load<QString>();
+    const QString remainder = pool.load<QString>();
+    setFilePath(dirPath + remainder);
+    pool.load(m_timestamp);
 }
 
 void FileResourceBase::store(PersistentPool &pool)
 {
-    serializationOp<PersistentPool::Store>(pool);
+    const QString path = filePath();
+    const qsizetype dirPathSize = m_path ? m_path->dirPath.size() : 0;
+    pool.store(path.left(dirPathSize), path.mid(dirPathSize), m_timestamp);
 }
 
 
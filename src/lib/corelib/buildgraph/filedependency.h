@@ -41,6 +41,7 @@
 #define QBS_FILEDEPENDENCY_H
 
 #include <tools/filetime.h>
+#include <tools/pathtable.h>
 #include <tools/persistence.h>
 
 namespace qbs {
@@ -54,34 +55,35 @@ protected:
 public:
     virtual ~FileResourceBase();
 
+    FileResourceBase(const FileResourceBase &) = delete;
+    FileResourceBase &operator=(const FileResourceBase &) = delete;
+
     enum FileType { FileTypeDependency, FileTypeArtifact };
     virtual FileType fileType() const = 0;
 
     void setTimestamp(const FileTime &t);
     const FileTime &timestamp() const;
-    void clearTimestamp() { m_timestamp.clear(); }
+    void clearTimestamp();
 
     void setFilePath(const QString &filePath);
-    const QString &filePath() const;
-    QString dirPath() const { return m_dirPath.toString(); }
-    QString fileName() const { return m_fileName.toString(); }
+    QString filePath() const { return m_path ? m_path->filePath() : QString(); }
+    QString dirPath() const { return m_path ? m_path->dirPath.toString() : QString(); }
+    QString fileName() const { return m_path ? m_path->fileName : QString(); }
+    PathTable::PathId pathId() const { return m_path ? m_path->id : PathTable::invalidPathId; }
 
     virtual void load(PersistentPool &pool);
     virtual void store(PersistentPool &pool);
 
-private:
-    template<PersistentPool::OpType opType> void serializationOp(PersistentPool &pool)
-    {
-        pool.serializationOp<opType>(m_filePath, m_timestamp);
-    }
+protected:
+    // Called when the timestamp was changed by setTimestamp() or clearTimestamp().
+    virtual void timestampChanged() {}
 
+private:
     FileTime m_timestamp;
-    QString m_filePath;
-    QStringView m_dirPath;
-    QStringView m_fileName;
+    const PathTable::Entry *m_path = nullptr;
 };
 
-class FileDependency : public FileResourceBase
+class FileDependency : public FileResourceBase, public PersistentObject
 {
 public:
     FileDependency();
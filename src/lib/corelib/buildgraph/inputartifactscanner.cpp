@@ -262,6 +262,7 @@ void InputArtifactScanner::scanForScannerFileDependencies(
         qCDebug(lcDepScan) << "scanning" << FileInfo::fileName(filePathToBeScanned);
         scanWithScannerPlugin(scanner, inputArtifact, fileToBeScanned, &scanData.rawScanResult);
         scanData.lastScanTime = FileTime::currentTime();
+        m_artifact->product->topLevelProject()->buildData->setRawScanResultsDirty();
     }
 
     resolveScanResultDependencies(inputArtifact, scanData.rawScanResult, filesToScan, *cache);
@@ -378,9 +379,12 @@ void InputArtifactScanner::handleDependency(ResolvedDependency &dependency)
         return;
 
     if (fileDependency) {
-        m_artifact->fileDependencies << fileDependency;
-        if (!fileDependency->timestamp().isValid())
+        if (m_artifact->fileDependencies.insert(fileDependency).second)
+            setProductBuildDataDirty(m_artifact);
+        if (!fileDependency->timestamp().isValid()) {
             fileDependency->setTimestamp(FileInfo(fileDependency->filePath()).lastModified());
+            product->topLevelProject()->buildData->setFileDependencyDirty(fileDependency);
+        }
     } else {
         if (m_artifact->children.contains(artifactDependency))
             return;
@@ -47,21 +47,25 @@
 #include <language/language.h>
 #include <language/preparescriptobserver.h>
 #include <language/resolvedfilecontext.h>
+#include <language/scriptcompilationcache.h>
 #include <language/scriptengine.h>
 #include <logging/logger.h>
 #include <tools/codelocation.h>
 #include <tools/error.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
+#include <tools/threadpool.h>
 
 #include <quickjs.h>
 
 #include <QtCore/qeventloop.h>
 #include <QtCore/qmutex.h>
 #include <QtCore/qpointer.h>
-#include <QtCore/qthread.h>
 #include <QtCore/qtimer.h>
 
+#include <algorithm>
+#include <atomic>
+
 namespace qbs {
 namespace Internal {
 
@@ -72,16 +76,63 @@ struct JavaScriptCommandResult
     CodeLocation errorLocation;
 };
 
+JsCommandEnginePool::JsCommandEnginePool(Logger logger) : m_logger(std::move(logger)) {}
+
+JsCommandEnginePool::~JsCommandEnginePool() = default;
+
+ScriptEngine *JsCommandEnginePool::acquire()
+{
+    std::unique_lock lock(m_mutex);
+    if (m_idleEngines.empty()) {
+        lock.unlock();
+        std::unique_ptr<ScriptEngine> engine = ScriptEngine::create(m_logger,
+                                                                    EvalContext::JsCommand);
+        ScriptEngine * const enginePtr = engine.get();
+        lock.lock();
+        m_engines.push_back(std::move(engine));
+        return enginePtr;
+    }
+
+    // Imported files and product objects can be modified by a command, so nothing set up
+    // for an earlier command must be visible to the next one.
+    ScriptEngine * const engine = m_idleEngines.back();
+    m_idleEngines.pop_back();
+    lock.unlock();
+    engine->reset();
+    return engine;
+}
+
+void JsCommandEnginePool::release(ScriptEngine *engine)
+{
+    const std::lock_guard lock(m_mutex);
+    m_idleEngines.push_back(engine);
+}
+
+// For engines that might be in an undefined state, e.g. due to a cancel request.
+void JsCommandEnginePool::discard(ScriptEngine *engine)
+{
+    std::unique_ptr<ScriptEngine> discardedEngine;
+    {
+        const std::lock_guard lock(m_mutex);
+        const auto it = std::find_if(m_engines.begin(), m_engines.end(),
+                                     [engine](const auto &e) { return e.get() == engine; });
+        QBS_CHECK(it != m_engines.end());
+        discardedEngine = std::move(*it);
+        m_engines.erase(it);
+    }
+}
+
 class JsCommandExecutorThreadObject : public QObject
 {
     Q_OBJECT
 public:
     JsCommandExecutorThreadObject(Logger logger)
         : m_logger(std::move(logger))
-        , m_scriptEngine(nullptr)
     {
     }
 
+    void setEnginePool(JsCommandEnginePool *pool) { m_enginePool = pool; }
+
     const JavaScriptCommandResult &result() const
     {
         return m_result;
@@ -109,22 +160,26 @@ public:
         }
 
         m_running = true;
+        ScriptEngine * const scriptEngine = provideScriptEngine();
         try {
-            doStart(cmd, transformer);
+            doStart(scriptEngine, cmd, transformer);
         } catch (const qbs::ErrorInfo &error) {
             setError(error.toString(), cmd->codeLocation());
         }
+        releaseScriptEngine();
 
         m_running = false;
         emit finished();
     }
 
 private:
-    void doStart(const JavaScriptCommand *cmd, Transformer *transformer)
+    void doStart(ScriptEngine *scriptEngine, const JavaScriptCommand *cmd,
+                 Transformer *transformer)
     {
         m_result.success = true;
         m_result.errorMessage.clear();
-        ScriptEngine * const scriptEngine = provideScriptEngine();
+        scriptEngine->setByteCodeCacheDirectory(ScriptCompilationCache::diskCacheDirectory(
+                transformer->product()->topLevelProject()->buildDirectory));
         JSContext * const ctx = scriptEngine->context();
         const ScopedJsValue scope(ctx, JS_NewObject(scriptEngine->context()));
         setupScriptEngineForFile(scriptEngine,
@@ -147,8 +202,8 @@ private:
         JSValueList scopeChain;
         if (JS_IsObject(importScopeForSourceCode))
             scopeChain << importScopeForSourceCode;
-        const ScopedJsValue res(ctx, scriptEngine->evaluate(JsValueOwner::Caller, cmd->sourceCode(),
-                                                            {}, 1, scopeChain));
+        const ScopedJsValue res(ctx, scriptEngine->evaluateCached(
+                                    JsValueOwner::Caller, cmd->sourceCode(), {}, 1, scopeChain));
         transformer->propertiesRequestedInCommands
                 += scriptEngine->propertiesRequestedInScript();
         unite(transformer->propertiesRequestedFromArtifactInCommands,
@@ -183,46 +238,75 @@ private:
 
     ScriptEngine *provideScriptEngine()
     {
-        if (!m_scriptEngine)
-            m_scriptEngine = ScriptEngine::create(m_logger, EvalContext::JsCommand);
+        ScriptEngine *engine = nullptr;
+        if (m_enginePool) {
+            engine = m_enginePool->acquire();
+        } else {
+            if (!m_ownScriptEngine)
+                m_ownScriptEngine = ScriptEngine::create(m_logger, EvalContext::JsCommand);
+            else
+                m_ownScriptEngine->reset();
+            engine = m_ownScriptEngine.get();
+        }
+        QMutexLocker locker(&m_resultMutex);
+        m_scriptEngine = engine;
+        return engine;
+    }
+
+    void releaseScriptEngine()
+    {
+        ScriptEngine *engine;
+        bool cancelled;
+        {
+            QMutexLocker locker(&m_resultMutex);
+            engine = m_scriptEngine;
+            m_scriptEngine = nullptr;
+            cancelled = m_cancelled;
+        }
+        if (!m_enginePool)
+            return;
+        if (cancelled)
+            m_enginePool->discard(engine);
         else
-            m_scriptEngine->reset();
-        return m_scriptEngine.get();
+            m_enginePool->release(engine);
     }
 
     Logger m_logger;
-    std::unique_ptr<ScriptEngine> m_scriptEngine;
+    JsCommandEnginePool *m_enginePool = nullptr;
+    std::unique_ptr<ScriptEngine> m_ownScriptEngine;
+    ScriptEngine *m_scriptEngine = nullptr; // The one currently in use.
     JavaScriptCommandResult m_result;
     QMutex m_resultMutex;
     bool m_running = false;
-    bool m_cancelled = false;
+    std::atomic_bool m_cancelled = false; // Also read outside of m_resultMutex.
 };
 
 
 JsCommandExecutor::JsCommandExecutor(const Logger &logger, QObject *parent)
     : AbstractCommandExecutor(logger, parent)
-    , m_thread(new QThread(this))
     , m_objectInThread(new JsCommandExecutorThreadObject(logger))
     , m_running(false)
 {
-    qRegisterMetaType<Transformer *>("Transformer *");
-    qRegisterMetaType<const JavaScriptCommand *>("const JavaScriptCommand *");
-
-    m_objectInThread->moveToThread(m_thread);
+    // The command runs in the shared thread pool, so the result must always be
+    // delivered via the event loop of the executor's thread.
     connect(m_objectInThread, &JsCommandExecutorThreadObject::finished,
-            this, &JsCommandExecutor::onJavaScriptCommandFinished);
-    connect(this, &JsCommandExecutor::startRequested,
-            m_objectInThread, &JsCommandExecutorThreadObject::start);
+            this, &JsCommandExecutor::onJavaScriptCommandFinished, Qt::QueuedConnection);
 }
 
 JsCommandExecutor::~JsCommandExecutor()
 {
     waitForFinished();
-    m_thread->quit();
-    m_thread->wait();
+    if (m_task.valid())
+        m_task.wait();
     delete m_objectInThread;
 }
 
+void JsCommandExecutor::setEnginePool(JsCommandEnginePool *pool)
+{
+    QBS_ASSERT(!m_running, return);
+    m_objectInThread->setEnginePool(pool);
+}
+
 void JsCommandExecutor::doReportCommandDescription(const QString &productName)
 {
     if ((m_echoMode == CommandEchoModeCommandLine
@@ -253,9 +337,13 @@ bool JsCommandExecutor::doStart()
         return false;
     }
 
-    m_thread->start();
+    if (m_task.valid())
+        m_task.wait();
     m_running = true;
-    emit startRequested(jsCommand(), transformer());
+    m_task = ThreadPool::globalInstance().run(
+                [object = m_objectInThread, cmd = jsCommand(), transformer = transformer()] {
+        object->start(cmd, transformer);
+    });
     return true;
 }
 
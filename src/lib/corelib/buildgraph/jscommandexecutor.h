@@ -43,8 +43,15 @@
 
 #include "abstractcommandexecutor.h"
 
+#include <language/forward_decls.h>
+
 #include <QtCore/qstring.h>
 
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
 namespace qbs {
 class CodeLocation;
 
@@ -52,6 +59,25 @@ namespace Internal {
 class JavaScriptCommand;
 class JsCommandExecutorThreadObject;
 
+// The script engines running JavaScript commands, shared by all executor jobs.
+// Engines are reset when handed out, so only their creation is saved.
+class JsCommandEnginePool
+{
+public:
+    explicit JsCommandEnginePool(Logger logger);
+    ~JsCommandEnginePool();
+
+    ScriptEngine *acquire();
+    void release(ScriptEngine *engine);
+    void discard(ScriptEngine *engine);
+
+private:
+    const Logger m_logger;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ScriptEngine>> m_engines;
+    std::vector<ScriptEngine *> m_idleEngines;
+};
+
 class JsCommandExecutor : public AbstractCommandExecutor
 {
     Q_OBJECT
@@ -59,8 +85,7 @@ public:
     explicit JsCommandExecutor(const Logger &logger, QObject *parent = nullptr);
     ~JsCommandExecutor() override;
 
-signals:
-    void startRequested(const JavaScriptCommand *cmd, Transformer *transformer);
+    void setEnginePool(JsCommandEnginePool *pool);
 
 private:
     void onJavaScriptCommandFinished();
@@ -73,8 +98,8 @@ private:
 
     const JavaScriptCommand *jsCommand() const;
 
-    QThread *m_thread;
     JsCommandExecutorThreadObject *m_objectInThread;
+    std::future<void> m_task;
     bool m_running;
 };
 
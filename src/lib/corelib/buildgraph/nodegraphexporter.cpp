@@ -0,0 +1,261 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "nodegraphexporter.h"
+
+#include "artifact.h"
+#include "productbuilddata.h"
+#include "rulenode.h"
+
+#include <language/language.h>
+
+#include <QtCore/qiodevice.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+
+namespace qbs {
+namespace Internal {
+
+static QString dotName() { return QStringLiteral("dot"); }
+static QString graphMlName() { return QStringLiteral("graphml"); }
+static QString jsonLinesName() { return QStringLiteral("jsonl"); }
+
+static QString dotEscaped(QString s)
+{
+    return s.replace(QLatin1Char('\\'), QLatin1String("\\\\"))
+            .replace(QLatin1Char('"'), QLatin1String("\\\""));
+}
+
+static QString nodeKind(const BuildGraphNode *node)
+{
+    return node->type() == BuildGraphNode::ArtifactNodeType ? QStringLiteral("artifact")
+                                                            : QStringLiteral("rule");
+}
+
+static QString nodeLabel(const BuildGraphNode *node)
+{
+    if (node->type() == BuildGraphNode::ArtifactNodeType)
+        return static_cast<const Artifact *>(node)->filePath();
+    return node->toString();
+}
+
+static FileTags nodeFileTags(const BuildGraphNode *node)
+{
+    if (node->type() == BuildGraphNode::ArtifactNodeType)
+        return static_cast<const Artifact *>(node)->fileTags();
+    return static_cast<const RuleNode *>(node)->rule()->collectedOutputFileTags();
+}
+
+static QString nodeProductName(const BuildGraphNode *node)
+{
+    const ResolvedProduct * const product = node->product.get();
+    return product ? product->fullDisplayName() : QString();
+}
+
+QStringList NodeGraphExporter::formatNames()
+{
+    return {dotName(), graphMlName(), jsonLinesName()};
+}
+
+bool NodeGraphExporter::formatFromName(const QString &name, Format &format)
+{
+    if (name == dotName())
+        format = Format::Dot;
+    else if (name == graphMlName())
+        format = Format::GraphML;
+    else if (name == jsonLinesName())
+        format = Format::JsonLines;
+    else
+        return false;
+    return true;
+}
+
+NodeGraphExporter::NodeGraphExporter(QIODevice &outDevice, Format format, FileTags fileTags)
+    : m_outDevice(outDevice), m_format(format), m_fileTags(std::move(fileTags))
+{
+}
+
+void NodeGraphExporter::start(const QVector<ResolvedProductPtr> &products)
+{
+    m_nodeIds.clear();
+    writeHeader();
+
+    // Every node belongs to exactly one product, so writing the outgoing edges of a node
+    // only while iterating over its own product's nodes emits each edge exactly once.
+    // Children living in products that were not requested still show up as edge targets,
+    // but their own dependencies are not followed.
+    for (const ResolvedProductPtr &p : products) {
+        if (!p->buildData)
+            continue;
+        for (const BuildGraphNode * const node : p->buildData->allNodes()) {
+            if (!isIncluded(node))
+                continue;
+            const int id = nodeId(node);
+            for (const BuildGraphNode * const child : node->children) {
+                if (isIncluded(child))
+                    writeEdge(id, nodeId(child));
+            }
+        }
+    }
+
+    writeFooter();
+    m_nodeIds.clear();
+}
+
+bool NodeGraphExporter::isIncluded(const BuildGraphNode *node) const
+{
+    return m_fileTags.empty() || nodeFileTags(node).intersects(m_fileTags);
+}
+
+int NodeGraphExporter::nodeId(const BuildGraphNode *node)
+{
+    const auto it = m_nodeIds.find(node);
+    if (it != m_nodeIds.cend())
+        return it->second;
+    const int id = int(m_nodeIds.size()) + 1;
+    m_nodeIds.insert({node, id});
+    writeNode(id, node);
+    return id;
+}
+
+void NodeGraphExporter::writeHeader()
+{
+    switch (m_format) {
+    case Format::Dot:
+        m_outDevice.write("digraph \"build graph\" {\n");
+        break;
+    case Format::GraphML:
+        m_outDevice.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                          "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+                          "  <key id=\"kind\" for=\"node\" attr.name=\"kind\" "
+                          "attr.type=\"string\"/>\n"
+                          "  <key id=\"label\" for=\"node\" attr.name=\"label\" "
+                          "attr.type=\"string\"/>\n"
+                          "  <key id=\"product\" for=\"node\" attr.name=\"product\" "
+                          "attr.type=\"string\"/>\n"
+                          "  <key id=\"fileTags\" for=\"node\" attr.name=\"fileTags\" "
+                          "attr.type=\"string\"/>\n"
+                          "  <graph id=\"build graph\" edgedefault=\"directed\">\n");
+        break;
+    case Format::JsonLines:
+        break;
+    }
+}
+
+void NodeGraphExporter::writeFooter()
+{
+    switch (m_format) {
+    case Format::Dot:
+        m_outDevice.write("}\n");
+        break;
+    case Format::GraphML:
+        m_outDevice.write("  </graph>\n</graphml>\n");
+        break;
+    case Format::JsonLines:
+        break;
+    }
+}
+
+void NodeGraphExporter::writeNode(int id, const BuildGraphNode *node)
+{
+    const QStringList fileTags = nodeFileTags(node).toStringList();
+    QString line;
+    switch (m_format) {
+    case Format::Dot:
+        line = QStringLiteral("    n%1 [label=\"%2\", kind=\"%3\", product=\"%4\", "
+                              "fileTags=\"%5\"%6];\n")
+                .arg(QString::number(id), dotEscaped(nodeLabel(node)), nodeKind(node),
+                     dotEscaped(nodeProductName(node)),
+                     dotEscaped(fileTags.join(QLatin1Char(','))),
+                     node->type() == BuildGraphNode::RuleNodeType
+                        ? QStringLiteral(", shape=box") : QString());
+        break;
+    case Format::GraphML:
+        line = QStringLiteral("    <node id=\"n%1\">"
+                              "<data key=\"kind\">%2</data>"
+                              "<data key=\"label\">%3</data>"
+                              "<data key=\"product\">%4</data>"
+                              "<data key=\"fileTags\">%5</data>"
+                              "</node>\n")
+                .arg(QString::number(id), nodeKind(node), nodeLabel(node).toHtmlEscaped(),
+                     nodeProductName(node).toHtmlEscaped(),
+                     fileTags.join(QLatin1Char(',')).toHtmlEscaped());
+        break;
+    case Format::JsonLines: {
+        const QJsonObject object{
+            {QStringLiteral("type"), QStringLiteral("node")},
+            {QStringLiteral("id"), id},
+            {QStringLiteral("kind"), nodeKind(node)},
+            {QStringLiteral("label"), nodeLabel(node)},
+            {QStringLiteral("product"), nodeProductName(node)},
+            {QStringLiteral("fileTags"), QJsonArray::fromStringList(fileTags)}};
+        m_outDevice.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        m_outDevice.write("\n");
+        return;
+    }
+    }
+    m_outDevice.write(line.toUtf8());
+}
+
+void NodeGraphExporter::writeEdge(int parentId, int childId)
+{
+    switch (m_format) {
+    case Format::Dot:
+        m_outDevice.write(QStringLiteral("    n%1 -> n%2;\n").arg(parentId).arg(childId)
+                          .toUtf8());
+        break;
+    case Format::GraphML:
+        m_outDevice.write(QStringLiteral("    <edge source=\"n%1\" target=\"n%2\"/>\n")
+                          .arg(parentId).arg(childId).toUtf8());
+        break;
+    case Format::JsonLines: {
+        const QJsonObject object{
+            {QStringLiteral("type"), QStringLiteral("edge")},
+            {QStringLiteral("from"), parentId},
+            {QStringLiteral("to"), childId}};
+        m_outDevice.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        m_outDevice.write("\n");
+        break;
+    }
+    }
+}
+
+} // namespace Internal
+} // namespace qbs
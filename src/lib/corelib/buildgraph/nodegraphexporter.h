@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_NODEGRAPHEXPORTER_H
+#define QBS_NODEGRAPHEXPORTER_H
+
+#include <language/filetags.h>
+#include <language/forward_decls.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qstringlist.h>
+
+#include <unordered_map>
+
+QT_BEGIN_NAMESPACE
+class QIODevice;
+QT_END_NAMESPACE
+
+namespace qbs {
+namespace Internal {
+class BuildGraphNode;
+
+// Writes the build graph of the given products as a flat list of nodes and edges.
+// Unlike NodeTreeDumper, every node and every edge appears exactly once, and output
+// goes straight to the device, so memory use does not grow with the size of the output.
+class QBS_AUTOTEST_EXPORT NodeGraphExporter
+{
+public:
+    enum class Format { Dot, GraphML, JsonLines };
+
+    static QStringList formatNames();
+    static bool formatFromName(const QString &name, Format &format);
+
+    NodeGraphExporter(QIODevice &outDevice, Format format, FileTags fileTags = {});
+
+    void start(const QVector<ResolvedProductPtr> &products);
+
+private:
+    bool isIncluded(const BuildGraphNode *node) const;
+    int nodeId(const BuildGraphNode *node);
+
+    void writeHeader();
+    void writeFooter();
+    void writeNode(int id, const BuildGraphNode *node);
+    void writeEdge(int parentId, int childId);
+
+    QIODevice &m_outDevice;
+    const Format m_format;
+    const FileTags m_fileTags;
+    std::unordered_map<const BuildGraphNode *, int> m_nodeIds;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_NODEGRAPHEXPORTER_H
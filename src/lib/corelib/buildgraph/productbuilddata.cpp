@@ -72,6 +72,7 @@ void ProductBuildData::addArtifactToSet(Artifact *artifact)
         m_artifactsByFileTag[tag] += artifact;
         m_jsArtifactsMapUpToDate = false;
     }
+    setDirty();
 }
 
 void ProductBuildData::removeArtifact(Artifact *artifact)
@@ -79,6 +80,7 @@ void ProductBuildData::removeArtifact(Artifact *artifact)
     m_roots.remove(artifact);
     m_nodes.remove(artifact);
     removeArtifactFromSet(artifact);
+    setDirty();
 }
 
 void ProductBuildData::removeArtifactFromSetByFileTag(Artifact *artifact, const FileTag &fileTag)
@@ -91,6 +93,7 @@ void ProductBuildData::removeArtifactFromSetByFileTag(Artifact *artifact, const
     if (it->empty())
         m_artifactsByFileTag.erase(it);
     m_jsArtifactsMapUpToDate = false;
+    setDirty();
 }
 
 void ProductBuildData::addFileTagToArtifact(Artifact *artifact, const FileTag &tag)
@@ -98,6 +101,7 @@ void ProductBuildData::addFileTagToArtifact(Artifact *artifact, const FileTag &t
     std::lock_guard<std::mutex> l(m_artifactsMapMutex);
     m_artifactsByFileTag[tag] += artifact;
     m_jsArtifactsMapUpToDate = false;
+    setDirty();
 }
 
 ArtifactSetByFileTag ProductBuildData::artifactsByFileTag() const
@@ -108,17 +112,25 @@ ArtifactSetByFileTag ProductBuildData::artifactsByFileTag() const
 void ProductBuildData::setRescuableArtifactData(const AllRescuableArtifactData &rad)
 {
     m_rescuableArtifactData = rad;
+    setDirty();
 }
 
 RescuableArtifactData ProductBuildData::removeFromRescuableArtifactData(const QString &filePath)
 {
-    return m_rescuableArtifactData.take(filePath);
+    const auto it = m_rescuableArtifactData.find(filePath);
+    if (it == m_rescuableArtifactData.end())
+        return {};
+    setDirty();
+    const RescuableArtifactData rad = it.value();
+    m_rescuableArtifactData.erase(it);
+    return rad;
 }
 
 void ProductBuildData::addRescuableArtifactData(const QString &filePath,
                                                 const RescuableArtifactData &rad)
 {
     m_rescuableArtifactData.insert(filePath, rad);
+    setDirty();
 }
 
 bool ProductBuildData::checkAndSetJsArtifactsMapUpToDateFlag()
@@ -57,7 +57,7 @@ class Logger;
 
 using ArtifactSetByFileTag = QHash<FileTag, ArtifactSet>;
 
-class QBS_AUTOTEST_EXPORT ProductBuildData
+class QBS_AUTOTEST_EXPORT ProductBuildData : public PersistentObject
 {
 public:
     ~ProductBuildData();
@@ -66,9 +66,9 @@ public:
     const NodeSet &allNodes() const { return m_nodes; }
     const NodeSet &rootNodes() const { return m_roots; }
 
-    void addNode(BuildGraphNode *node) { m_nodes.insert(node); }
-    void addRootNode(BuildGraphNode *node) { m_roots.insert(node); }
-    void removeFromRootNodes(BuildGraphNode *node) { m_roots.remove(node); }
+    void addNode(BuildGraphNode *node) { m_nodes.insert(node); setDirty(); }
+    void addRootNode(BuildGraphNode *node) { m_roots.insert(node); setDirty(); }
+    void removeFromRootNodes(BuildGraphNode *node) { m_roots.remove(node); setDirty(); }
     void addArtifact(Artifact *artifact);
     void addArtifactToSet(Artifact *artifact);
     void removeArtifact(Artifact *artifact);
@@ -82,6 +82,12 @@ public:
     RescuableArtifactData removeFromRescuableArtifactData(const QString &filePath);
     void addRescuableArtifactData(const QString &filePath, const RescuableArtifactData &rad);
 
+    // Whether anything that gets stored for this product has changed since the build graph
+    // was loaded or stored. Only the build graph file sections of dirty products are rewritten.
+    void setDirty() { m_isDirty = true; }
+    void setClean() { m_isDirty = false; }
+    bool isDirty() const { return m_isDirty; }
+
     unsigned int buildPriority() const { return m_buildPriority; }
     void setBuildPriority(unsigned int prio) { m_buildPriority = prio; }
 
@@ -115,6 +121,7 @@ private:
     mutable std::mutex m_artifactsMapMutex;
 
     bool m_jsArtifactsMapUpToDate = true;
+    bool m_isDirty = true;
 };
 
 } // namespace Internal
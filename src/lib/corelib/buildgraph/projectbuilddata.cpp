@@ -55,7 +55,6 @@
 #include <logging/categories.h>
 #include <logging/translator.h>
 #include <tools/error.h>
-#include <tools/fileinfo.h>
 #include <tools/qbsassert.h>
 #include <tools/qttools.h>
 #include <tools/stlutils.h>
@@ -98,7 +97,7 @@ QString ProjectBuildData::deriveBuildGraphFilePath(const QString &buildDir, cons
 
 void ProjectBuildData::insertIntoLookupTable(FileResourceBase *fileres)
 {
-    auto &lst = m_artifactLookupTable[{fileres->fileName(), fileres->dirPath()}];
+    auto &lst = m_artifactLookupTable[fileres->pathId()];
     const auto * const artifact = fileres->fileType() == FileResourceBase::FileTypeArtifact
             ? static_cast<Artifact *>(fileres) : nullptr;
     if (artifact && artifact->artifactType == Artifact::Generated) {
@@ -120,32 +119,43 @@ void ProjectBuildData::insertIntoLookupTable(FileResourceBase *fileres)
     }
     QBS_CHECK(!contains(lst, fileres));
     lst.push_back(fileres);
-    m_isDirty = true;
+    if (!artifact)
+        setFileDependencyDirty(static_cast<const FileDependency *>(fileres));
 }
 
 void ProjectBuildData::removeFromLookupTable(FileResourceBase *fileres)
 {
-    removeOne(m_artifactLookupTable[{fileres->fileName(), fileres->dirPath()}], fileres);
+    removeOne(m_artifactLookupTable[fileres->pathId()], fileres);
+}
+
+static const std::vector<FileResourceBase *> &emptyLookupResult()
+{
+    static const std::vector<FileResourceBase *> emptyResult;
+    return emptyResult;
 }
 
 const std::vector<FileResourceBase *> &ProjectBuildData::lookupFiles(const QString &filePath) const
 {
-    QString dirPath, fileName;
-    FileInfo::splitIntoDirectoryAndFileName(filePath, &dirPath, &fileName);
-    return lookupFiles(dirPath, fileName);
+    return lookupFiles(PathTable::instance().find(filePath));
 }
 
 const std::vector<FileResourceBase *> &ProjectBuildData::lookupFiles(const QString &dirPath,
         const QString &fileName) const
 {
-    static const std::vector<FileResourceBase *> emptyResult;
-    const auto it = m_artifactLookupTable.find({fileName, dirPath});
-    return it != m_artifactLookupTable.end() ? it->second : emptyResult;
+    return lookupFiles(PathTable::instance().find(dirPath, fileName));
 }
 
 const std::vector<FileResourceBase *> &ProjectBuildData::lookupFiles(const Artifact *artifact) const
 {
-    return lookupFiles(artifact->dirPath(), artifact->fileName());
+    return lookupFiles(artifact->pathId());
+}
+
+const std::vector<FileResourceBase *> &ProjectBuildData::lookupFiles(PathTable::PathId pathId) const
+{
+    if (pathId == PathTable::invalidPathId)
+        return emptyLookupResult();
+    const auto it = m_artifactLookupTable.find(pathId);
+    return it != m_artifactLookupTable.end() ? it->second : emptyLookupResult();
 }
 
 void ProjectBuildData::insertFileDependency(FileDependency *dependency)
@@ -168,6 +178,7 @@ static void disconnectArtifactParents(Artifact *artifact)
     qCDebug(lcBuildGraph) << "disconnect parents of" << relativeArtifactFileName(artifact);
     for (BuildGraphNode * const parent : std::as_const(artifact->parents)) {
         parent->children.remove(artifact);
+        setProductBuildDataDirty(parent);
         if (parent->type() != BuildGraphNode::ArtifactNodeType)
             continue;
         auto const parentArtifact = static_cast<Artifact *>(parent);
@@ -223,14 +234,17 @@ void ProjectBuildData::removeArtifactAndExclusiveDependents(Artifact *artifact,
 
 static void removeFromRuleNodes(Artifact *artifact)
 {
-    for (RuleNode * const ruleNode : filterByType<RuleNode>(artifact->parents))
+    for (RuleNode * const ruleNode : filterByType<RuleNode>(artifact->parents)) {
         ruleNode->removeOldInputArtifact(artifact);
+        setProductBuildDataDirty(ruleNode);
+    }
 }
 
 void ProjectBuildData::removeArtifact(Artifact *artifact,
         const Logger &logger, bool removeFromDisk, bool removeFromProduct)
 {
     qCDebug(lcBuildGraph) << "remove artifact" << relativeArtifactFileName(artifact);
+    setNodeRemoved(artifact);
     if (removeFromDisk)
         removeGeneratedArtifactFromDisk(artifact, logger);
     removeFromLookupTable(artifact);
@@ -246,12 +260,27 @@ void ProjectBuildData::setDirty()
 {
     qCDebug(lcBuildGraph) << "Marking build graph as dirty";
     m_isDirty = true;
+    storedState.reset();
 }
 
 void ProjectBuildData::setClean()
 {
     qCDebug(lcBuildGraph) << "Marking build graph as clean";
     m_isDirty = false;
+    m_dirtySections.clear();
+    m_rawScanResultsDirty = false;
+}
+
+void ProjectBuildData::setFileDependencyDirty(const FileDependency *dependency)
+{
+    if (storedState)
+        m_dirtySections.insert(storedState->sectionOf(dependency));
+}
+
+void ProjectBuildData::setNodeRemoved(const BuildGraphNode *node)
+{
+    if (storedState)
+        m_dirtySections.insert(storedState->sectionOf(node));
 }
 
 void ProjectBuildData::load(PersistentPool &pool)
@@ -260,6 +289,7 @@ void ProjectBuildData::load(PersistentPool &pool)
     for (FileDependency * const dep : std::as_const(fileDependencies))
         insertIntoLookupTable(dep);
     m_isDirty = false;
+    m_dirtySections.clear();
 }
 
 void ProjectBuildData::store(PersistentPool &pool)
@@ -43,6 +43,7 @@
 #include "rawscanresults.h"
 #include <language/forward_decls.h>
 #include <logging/logger.h>
+#include <tools/pathtable.h>
 #include <tools/persistence.h>
 #include <tools/set.h>
 #include <tools/qttools.h>
@@ -61,7 +62,7 @@ class FileDependency;
 class FileResourceBase;
 class ScriptEngine;
 
-class QBS_AUTOTEST_EXPORT ProjectBuildData
+class QBS_AUTOTEST_EXPORT ProjectBuildData : public PersistentObject
 {
 public:
     ProjectBuildData(const ProjectBuildData *other = nullptr);
@@ -75,16 +76,28 @@ public:
     const std::vector<FileResourceBase *> &lookupFiles(const QString &filePath) const;
     const std::vector<FileResourceBase *> &lookupFiles(const QString &dirPath, const QString &fileName) const;
     const std::vector<FileResourceBase *> &lookupFiles(const Artifact *artifact) const;
+    const std::vector<FileResourceBase *> &lookupFiles(PathTable::PathId pathId) const;
     void insertFileDependency(FileDependency *dependency);
     void removeArtifactAndExclusiveDependents(Artifact *artifact, const Logger &logger,
             bool removeFromProduct = true, ArtifactSet *removedArtifacts = nullptr);
     void removeArtifact(Artifact *artifact, const Logger &logger, bool removeFromDisk = true,
                         bool removeFromProduct = true);
 
+    // Marks the complete build graph as changed. Changes to the build data of a product
+    // are tracked via ProductBuildData::setDirty() instead.
     void setDirty();
     void setClean();
     bool isDirty() const { return m_isDirty; }
 
+    // For data that was stored in the build graph file outside of the products' sections,
+    // and for objects that were removed. The sections of the stored build graph file that
+    // the objects are defined in need to be rewritten; -1 stands for objects that have not
+    // been stored yet.
+    void setFileDependencyDirty(const FileDependency *dependency);
+    void setNodeRemoved(const BuildGraphNode *node);
+    const Set<int> &dirtySections() const { return m_dirtySections; }
+    void setRawScanResultsDirty() { m_rawScanResultsDirty = true; }
+    bool rawScanResultsDirty() const { return m_rawScanResultsDirty; }
 
     Set<FileDependency *> fileDependencies;
     RawScanResults rawScanResults;
@@ -92,6 +105,10 @@ public:
     // do not serialize:
     RulesEvaluationContextPtr evaluationContext;
 
+    // Describes the build graph file as it was last loaded or stored. It is dropped when
+    // the complete file needs to be written anyway.
+    std::shared_ptr<PersistentPool::StoredState> storedState;
+
     void load(PersistentPool &pool);
     void store(PersistentPool &pool);
 
@@ -101,12 +118,14 @@ private:
         pool.serializationOp<opType>(fileDependencies, rawScanResults);
     }
 
-    using ArtifactKey = std::pair<QString /*fileName*/, QString /*dirName*/>;
-    using ArtifactLookupTable = std::unordered_map<ArtifactKey, std::vector<FileResourceBase *>>;
+    using ArtifactLookupTable
+        = std::unordered_map<PathTable::PathId, std::vector<FileResourceBase *>>;
     ArtifactLookupTable m_artifactLookupTable;
 
+    Set<int> m_dirtySections;
     bool m_doCleanupInDestructor = true;
     bool m_isDirty = true;
+    bool m_rawScanResultsDirty = false;
 };
 
 
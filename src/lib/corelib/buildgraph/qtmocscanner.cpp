@@ -142,6 +142,7 @@ static RawScanResult runScannerForArtifact(const Artifact *artifact)
         }
 
         scanData.lastScanTime = FileTime::currentTime();
+        artifact->product->topLevelProject()->buildData->setRawScanResultsDirty();
     }
     return scanData.rawScanResult;
 }
@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "reversedependencyindex.h"
+
+#include "artifact.h"
+#include "productbuilddata.h"
+#include "projectbuilddata.h"
+
+#include <language/language.h>
+
+#include <unordered_set>
+
+namespace qbs {
+namespace Internal {
+
+ReverseDependencyIndex::ReverseDependencyIndex(TopLevelProjectConstPtr project)
+    : m_project(std::move(project))
+{
+    for (const ResolvedProductPtr &product : m_project->allProducts()) {
+        if (!product->buildData)
+            continue;
+        for (Artifact * const artifact : filterByType<Artifact>(product->buildData->allNodes())) {
+            for (const FileDependency * const dependency : artifact->fileDependencies)
+                m_fileDependents[dependency].push_back(artifact);
+        }
+    }
+}
+
+std::vector<Artifact *> ReverseDependencyIndex::dependents(const QStringList &filePaths) const
+{
+    std::vector<Artifact *> result;
+    if (!m_project->buildData)
+        return result;
+
+    std::unordered_set<const BuildGraphNode *> seen;
+    std::vector<BuildGraphNode *> queue;
+    const auto enqueue = [&seen, &queue, &result](BuildGraphNode *node) {
+        if (!seen.insert(node).second)
+            return;
+        queue.push_back(node);
+        if (node->type() == BuildGraphNode::ArtifactNodeType)
+            result.push_back(static_cast<Artifact *>(node));
+    };
+
+    // Mark all given artifacts as seen first, so none of them shows up in the result
+    // just because it also depends on one of the other given files.
+    std::vector<const FileDependency *> fileDependencies;
+    for (const QString &filePath : filePaths) {
+        for (FileResourceBase * const file : m_project->buildData->lookupFiles(filePath)) {
+            if (file->fileType() == FileResourceBase::FileTypeArtifact) {
+                const auto artifact = static_cast<Artifact *>(file);
+                if (seen.insert(artifact).second)
+                    queue.push_back(artifact);
+            } else {
+                fileDependencies.push_back(static_cast<const FileDependency *>(file));
+            }
+        }
+    }
+    for (const FileDependency * const dependency : fileDependencies) {
+        const auto it = m_fileDependents.find(dependency);
+        if (it == m_fileDependents.cend())
+            continue;
+        for (Artifact * const artifact : it->second)
+            enqueue(artifact);
+    }
+
+    // Rule nodes are traversed, but not reported: they sit between a rule's inputs
+    // and its outputs.
+    for (std::size_t i = 0; i < queue.size(); ++i) {
+        for (BuildGraphNode * const parent : std::as_const(queue.at(i)->parents))
+            enqueue(parent);
+    }
+    return result;
+}
+
+} // namespace Internal
+} // namespace qbs
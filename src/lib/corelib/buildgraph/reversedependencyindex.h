@@ -0,0 +1,77 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_REVERSEDEPENDENCYINDEX_H
+#define QBS_REVERSEDEPENDENCYINDEX_H
+
+#include <language/forward_decls.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qstringlist.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class Artifact;
+class FileDependency;
+
+// Answers the question "what needs to be rebuilt if these files change?".
+// Artifact-to-artifact dependencies are available through the nodes' parents, but
+// file dependencies found by scanners are only stored in the forward direction,
+// so those are inverted once when the index is created.
+class QBS_AUTOTEST_EXPORT ReverseDependencyIndex
+{
+public:
+    explicit ReverseDependencyIndex(TopLevelProjectConstPtr project);
+
+    // All artifacts that depend directly or transitively on one of the given files,
+    // in breadth-first order. Artifacts for the given files themselves are not included.
+    std::vector<Artifact *> dependents(const QStringList &filePaths) const;
+
+private:
+    const TopLevelProjectConstPtr m_project;
+    std::unordered_map<const FileDependency *, std::vector<Artifact *>> m_fileDependents;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_REVERSEDEPENDENCYINDEX_H
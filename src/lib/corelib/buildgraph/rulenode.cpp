@@ -200,7 +200,7 @@ RuleNode::ApplicationResult RuleNode::apply(
     }
     m_oldInputArtifacts = allCompatibleInputs;
     m_oldExplicitlyDependsOn = explicitlyDependsOn;
-    product->topLevelProject()->buildData->setDirty();
+    product->buildData->setDirty();
     return result;
 }
 
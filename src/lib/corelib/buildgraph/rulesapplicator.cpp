@@ -99,7 +99,7 @@ void RulesApplicator::applyRule(RuleNode *ruleNode, const ArtifactSet &inputArti
     m_rule = ruleNode->rule();
     QBS_CHECK(!inputArtifacts.empty() || !m_rule->declaresInputs() || !m_rule->requiresInputs);
 
-    m_product->topLevelProject()->buildData->setDirty();
+    m_product->buildData->setDirty();
     m_createdArtifacts.clear();
     m_invalidatedArtifacts.clear();
     m_removedArtifacts.clear();
@@ -88,8 +88,6 @@ void TimestampsUpdater::updateTimestamps(const TopLevelProjectPtr &project,
     TimestampsUpdateVisitor v;
     for (const ResolvedProductPtr &product : products)
         v.visitProduct(product);
-    if (!products.empty())
-        project->buildData->setDirty();
     project->store(logger);
 }
 
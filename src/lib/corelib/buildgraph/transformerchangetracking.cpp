@@ -27,6 +27,7 @@
 ****************************************************************************/
 #include "transformerchangetracking.h"
 
+#include "productbuilddata.h"
 #include "projectbuilddata.h"
 #include "requesteddependencies.h"
 #include "rulecommands.h"
@@ -360,6 +361,7 @@ bool prepareScriptNeedsRerun(
     if (!transformer->prepareScriptNeedsChangeTracking)
         return false;
     transformer->prepareScriptNeedsChangeTracking = false;
+    product->buildData->setDirty();
     return TrafoChangeTracker(transformer, product, productsByName, projectsByName)
             .prepareScriptNeedsRerun();
 }
@@ -371,6 +373,7 @@ bool commandsNeedRerun(Transformer *transformer, const ResolvedProduct *product,
     if (!transformer->commandsNeedChangeTracking)
         return false;
     transformer->commandsNeedChangeTracking = false;
+    product->buildData->setDirty();
     return TrafoChangeTracker(transformer, product, productsByName, projectsByName)
             .commandsNeedRerun();
 }
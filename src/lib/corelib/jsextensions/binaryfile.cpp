@@ -80,6 +80,15 @@ private:
     DEFINE_JS_FORWARDER(jsRead, &BinaryFile::read, "BinaryFile.read")
     DEFINE_JS_FORWARDER(jsWrite, &BinaryFile::write, "BinaryFile.write")
 
+    static JSValue jsReadBuffer(JSContext *ctx, JSValueConst this_val,
+                                int argc, JSValueConst *argv)
+    {
+        try {
+            const auto size = getArgument<qint64>(ctx, "BinaryFile.readBuffer", argc, argv);
+            return fromJsObject(ctx, this_val)->readBuffer(ctx, size);
+        } catch (const QString &error) { return throwError(ctx, error); }
+    }
+
     void close();
     QString filePath();
     bool atEof() const;
@@ -88,6 +97,7 @@ private:
     qint64 pos() const;
     void seek(qint64 pos);
     QByteArray read(qint64 size);
+    JSValue readBuffer(JSContext *ctx, qint64 size);
     void write(const QByteArray &data);
 
     explicit BinaryFile(JSContext *, const QString &filePath, OpenMode mode);
@@ -114,6 +124,7 @@ void BinaryFile::setupMethods(JSContext *ctx, JSValue obj)
     setupMethod(ctx, obj, "pos", &jsPos, 0);
     setupMethod(ctx, obj, "seek", &jsSeek, 0);
     setupMethod(ctx, obj, "read", &jsRead, 0);
+    setupMethod(ctx, obj, "readBuffer", &jsReadBuffer, 1);
     setupMethod(ctx, obj, "write", &jsWrite, 0);
 }
 
@@ -218,6 +229,17 @@ QByteArray BinaryFile::read(qint64 size)
     return bytes;
 }
 
+// The data is copied, so that the array stays valid after the file was closed or changed.
+JSValue BinaryFile::readBuffer(JSContext *ctx, qint64 size)
+{
+    const QByteArray bytes = read(size);
+    ScopedJsValue buffer(ctx, JS_NewArrayBufferCopy(
+                             ctx, reinterpret_cast<const uint8_t *>(bytes.constData()),
+                             bytes.size()));
+    JSValue bufferValue = buffer;
+    return JS_NewTypedArray(ctx, 1, &bufferValue, JS_TYPED_ARRAY_UINT8);
+}
+
 void BinaryFile::write(const QByteArray &data)
 {
     checkForClosed();
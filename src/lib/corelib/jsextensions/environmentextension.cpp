@@ -86,6 +86,7 @@ JSValue EnvironmentExtension::jsGetEnv(JSContext *ctx, JSValueConst, int argc, J
     try {
         const auto name = getArgument<QString>(ctx, "Environment.getEnv", argc, argv);
         ScriptEngine * const engine = ScriptEngine::engineForContext(ctx);
+        engine->addExternalStateQuery();
         const QProcessEnvironment env = engine->environment();
         const QProcessEnvironment *procenv = getProcessEnvironment(engine, QStringLiteral("getEnv"),
                                                                    false);
@@ -119,6 +120,7 @@ JSValue EnvironmentExtension::jsUnsetEnv(JSContext *ctx, JSValue, int argc, JSVa
 JSValue EnvironmentExtension::jsCurrentEnv(JSContext *ctx, JSValue, int, JSValue *)
 {
     ScriptEngine * const engine = ScriptEngine::engineForContext(ctx);
+    engine->addExternalStateQuery();
     const QProcessEnvironment env = engine->environment();
     const QProcessEnvironment *procenv = getProcessEnvironment(engine, QStringLiteral("currentEnv"),
                                                                false);
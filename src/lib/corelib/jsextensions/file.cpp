@@ -42,10 +42,15 @@
 #include <language/scriptengine.h>
 #include <logging/translator.h>
 #include <tools/fileinfo.h>
+#include <tools/threadpool.h>
 
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 
+#include <numeric>
+#include <utility>
+#include <vector>
+
 namespace qbs {
 namespace Internal {
 
@@ -85,6 +90,7 @@ public:
     static void setupStaticMethods(JSContext *ctx, JSValue classObj);
     static void declareEnums(JSContext *ctx, JSValue classObj);
     static JSValue jsCopy(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
+    static JSValue jsCopyFiles(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue jsExists(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue jsDirectoryEntries(JSContext *ctx, JSValueConst,
                                       int argc, JSValueConst *argv);
@@ -93,6 +99,7 @@ public:
     static JSValue jsMakePath(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue jsMove(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue jsRemove(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
+    static JSValue jsStatFiles(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue jsCanonicalFilePath(JSContext *ctx, JSValueConst,
                                        int argc, JSValueConst *argv);
 };
@@ -100,12 +107,14 @@ public:
 void File::setupStaticMethods(JSContext *ctx, JSValue classObj)
 {
     setupMethod(ctx, classObj, "copy", &File::jsCopy, 2);
+    setupMethod(ctx, classObj, "copyFiles", &File::jsCopyFiles, 2);
     setupMethod(ctx, classObj, "exists", &File::jsExists, 1);
     setupMethod(ctx, classObj, "directoryEntries", File::jsDirectoryEntries, 2);
     setupMethod(ctx, classObj, "lastModified", File::jsLastModified, 1);
     setupMethod(ctx, classObj, "makePath", &File::jsMakePath, 1);
     setupMethod(ctx, classObj, "move", &File::jsMove, 3);
     setupMethod(ctx, classObj, "remove", &File::jsRemove, 1);
+    setupMethod(ctx, classObj, "statFiles", &File::jsStatFiles, 1);
     setupMethod(ctx, classObj, "canonicalFilePath", &File::jsCanonicalFilePath, 1);
 }
 
@@ -142,6 +151,7 @@ JSValue File::jsCopy(JSContext *ctx, JSValue, int argc, JSValue *argv)
                 DubiousContext(EvalContext::RuleExecution, DubiousContext::SuggestMoving)
         });
         se->checkContext(QStringLiteral("File.copy()"), dubiousContexts);
+        se->addExternalStateQuery();
 
         const auto args = getArguments<QString, QString>(ctx, "File.copy", argc, argv);
         QString errorMessage;
@@ -153,6 +163,45 @@ JSValue File::jsCopy(JSContext *ctx, JSValue, int argc, JSValue *argv)
     } catch (const QString &error) { return throwError(ctx, error); }
 }
 
+JSValue File::jsCopyFiles(JSContext *ctx, JSValue, int argc, JSValue *argv)
+{
+    try {
+        const auto se = ScriptEngine::engineForContext(ctx);
+        const DubiousContextList dubiousContexts({
+                DubiousContext(EvalContext::PropertyEvaluation),
+                DubiousContext(EvalContext::RuleExecution, DubiousContext::SuggestMoving)
+        });
+        se->checkContext(QStringLiteral("File.copyFiles()"), dubiousContexts);
+        se->addExternalStateQuery();
+
+        const auto args = getArguments<QStringList, QStringList>(ctx, "File.copyFiles",
+                                                                 argc, argv);
+        const QStringList &sourceFilePaths = std::get<0>(args);
+        const QStringList &targetFilePaths = std::get<1>(args);
+        if (Q_UNLIKELY(sourceFilePaths.size() != targetFilePaths.size())) {
+            throw Tr::tr("File.copyFiles() requires the same number of source and "
+                         "target file paths.");
+        }
+        std::vector<int> indexes(sourceFilePaths.size());
+        std::iota(indexes.begin(), indexes.end(), 0);
+        const std::vector<QString> errorMessages = ThreadPool::ioInstance().mapped(
+                    indexes, [&sourceFilePaths, &targetFilePaths](int i) {
+            QString errorMessage;
+            copyFileRecursion(sourceFilePaths.at(i), targetFilePaths.at(i), true, true,
+                              &errorMessage);
+            return errorMessage;
+        });
+        QStringList errors;
+        for (const QString &errorMessage : errorMessages) {
+            if (!errorMessage.isEmpty())
+                errors << errorMessage;
+        }
+        if (Q_UNLIKELY(!errors.empty()))
+            throw errors.join(QLatin1Char('\n'));
+        return JS_TRUE;
+    } catch (const QString &error) { return throwError(ctx, error); }
+}
+
 JSValue File::jsExists(JSContext *ctx, JSValue, int argc, JSValue *argv)
 {
     try {
@@ -189,6 +238,7 @@ JSValue File::jsRemove(JSContext *ctx, JSValue, int argc, JSValue *argv)
         const auto se = ScriptEngine::engineForContext(ctx);
         const DubiousContextList dubiousContexts{DubiousContext(EvalContext::PropertyEvaluation)};
         se->checkContext(QStringLiteral("File.remove()"), dubiousContexts);
+        se->addExternalStateQuery();
         const auto fileName = getArgument<QString>(ctx, "Environment.remove", argc, argv);
         QString errorMessage;
         if (Q_UNLIKELY(!removeFileRecursion(QFileInfo(fileName), &errorMessage)))
@@ -197,6 +247,32 @@ JSValue File::jsRemove(JSContext *ctx, JSValue, int argc, JSValue *argv)
     } catch (const QString &error) { return throwError(ctx, error); }
 }
 
+JSValue File::jsStatFiles(JSContext *ctx, JSValue, int argc, JSValue *argv)
+{
+    try {
+        const auto filePaths = getArgument<QStringList>(ctx, "File.statFiles", argc, argv);
+        const auto stats = ThreadPool::ioInstance().mapped(
+                    filePaths, [](const QString &filePath) {
+            const FileInfo fileInfo(filePath);
+            return std::make_pair(fileInfo.exists(), fileInfo.lastModified());
+        });
+        const auto se = ScriptEngine::engineForContext(ctx);
+        JSValue result = JS_NewArray(ctx);
+        for (int i = 0; i < filePaths.size(); ++i) {
+            const QString &filePath = filePaths.at(i);
+            const auto &[exists, timestamp] = stats.at(i);
+            se->addFileExistsResult(filePath, exists);
+            se->addFileLastModifiedResult(filePath, timestamp);
+            const JSValue entry = JS_NewObject(ctx);
+            JS_SetPropertyStr(ctx, entry, "exists", JS_NewBool(ctx, exists));
+            JS_SetPropertyStr(ctx, entry, "lastModified",
+                              JS_NewFloat64(ctx, timestamp.asDouble()));
+            JS_SetPropertyUint32(ctx, result, i, entry);
+        }
+        return result;
+    } catch (const QString &error) { return throwError(ctx, error); }
+}
+
 JSValue File::jsLastModified(JSContext *ctx, JSValue, int argc, JSValue *argv)
 {
     try {
@@ -214,6 +290,7 @@ JSValue File::jsMakePath(JSContext *ctx, JSValue, int argc, JSValue *argv)
         const auto se = ScriptEngine::engineForContext(ctx);
         const DubiousContextList dubiousContexts{DubiousContext(EvalContext::PropertyEvaluation)};
         se->checkContext(QStringLiteral("File.makePath()"), dubiousContexts);
+        se->addExternalStateQuery();
         const auto path = getArgument<QString>(ctx, "File.makePath", argc, argv);
         return JS_NewBool(ctx, QDir::root().mkpath(path));
     } catch (const QString &error) { return throwError(ctx, error); }
@@ -225,6 +302,7 @@ JSValue File::jsMove(JSContext *ctx, JSValue, int argc, JSValue *argv)
         const auto se = ScriptEngine::engineForContext(ctx);
         const DubiousContextList dubiousContexts{DubiousContext(EvalContext::PropertyEvaluation)};
         se->checkContext(QStringLiteral("File.move()"), dubiousContexts);
+        se->addExternalStateQuery();
 
         const auto args = getArguments<QString, QString>(ctx, "File.move", argc, argv);
         const QString sourceFile = std::get<0>(args);
@@ -264,6 +342,7 @@ JSValue File::jsCanonicalFilePath(JSContext *ctx, JSValue, int argc, JSValue *ar
 {
     try {
         const auto path = getArgument<QString>(ctx, "File.canonicalFilePath", argc, argv);
+        ScriptEngine::engineForContext(ctx)->addExternalStateQuery();
         return makeJsString(ctx, QFileInfo(path).canonicalFilePath());
     } catch (const QString &error) { return throwError(ctx, error); }
 }
@@ -275,8 +275,23 @@ template<> struct FromArgHelper<QByteArray> {
             throw Tr::tr("%1 requires an array of bytes as argument %2")
                     .arg(QLatin1String(funcName)).arg(pos);
         };
-        if (!JS_IsArray(ctx, v))
-            throwError();
+        if (!JS_IsArray(ctx, v)) {
+            size_t size = 0;
+            if (JS_IsArrayBuffer(v)) {
+                const uint8_t * const bytes = JS_GetArrayBuffer(ctx, &size, v);
+                return QByteArray(reinterpret_cast<const char *>(bytes), size);
+            }
+            size_t offset = 0;
+            const ScopedJsValue buffer(ctx, JS_GetTypedArrayBuffer(ctx, v, &offset, &size,
+                                                                   nullptr));
+            if (JS_IsException(buffer)) {
+                JS_FreeValue(ctx, JS_GetException(ctx));
+                throwError();
+            }
+            size_t bufferSize = 0;
+            const uint8_t * const bytes = JS_GetArrayBuffer(ctx, &bufferSize, buffer);
+            return QByteArray(reinterpret_cast<const char *>(bytes) + offset, size);
+        }
         QByteArray data;
         data.resize(getJsIntProperty(ctx, v, QLatin1String("length")));
         for (int i = 0; i < data.size(); ++i) {
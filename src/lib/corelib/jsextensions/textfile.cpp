@@ -48,6 +48,8 @@
 #include <QtCore/qtextstream.h>
 #include <QtCore/qvariant.h>
 
+#include <limits>
+
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 0, 0))
 #include <QtCore5Compat/qtextcodec.h>
 #else
@@ -99,9 +101,17 @@ private:
     TextFile(JSContext *, const QString &filePath, OpenMode mode, const QString &codec);
 
     void checkForClosed() const;
+    QString decodeBuffered(qsizetype start, qsizetype end) const;
 
     std::unique_ptr<QFile> m_file;
     QTextCodec *m_codec = nullptr;
+
+    // Files opened read-only are read completely when they are opened, so that reading line
+    // by line does not go through the device for every call. Files of 2 GiB or more are read
+    // via the device, as the codec takes an int size.
+    bool m_isBuffered = false;
+    QByteArray m_buffer;
+    qsizetype m_bufferPos = 0;
 };
 
 void TextFile::declareEnums(JSContext *ctx, JSValue classObj)
@@ -166,6 +176,12 @@ TextFile::TextFile(JSContext *, const QString &filePath, OpenMode mode, const QS
     m |= QIODevice::Text;
     if (Q_UNLIKELY(!file->open(m)))
         throw Tr::tr("Unable to open file '%1': %2").arg(filePath, file->errorString());
+    if (mode == ReadOnly && file->size() <= std::numeric_limits<int>::max()) {
+        m_buffer = file->readAll(); // Text mode drops the carriage returns.
+        if (Q_UNLIKELY(file->error() != QFile::NoError))
+            throw Tr::tr("Unable to read file '%1': %2").arg(filePath, file->errorString());
+        m_isBuffered = true;
+    }
     m_file = std::move(file);
 }
 
@@ -174,6 +190,8 @@ void TextFile::close()
     checkForClosed();
     m_file->close();
     m_file.reset();
+    m_buffer.clear();
+    m_isBuffered = false;
 }
 
 QString TextFile::filePath()
@@ -193,6 +211,13 @@ void TextFile::setCodec(const QString &codec)
 QString TextFile::readLine()
 {
     checkForClosed();
+    if (m_isBuffered) {
+        const qsizetype start = m_bufferPos;
+        const qsizetype newLine = m_buffer.indexOf('\n', start);
+        const qsizetype end = newLine >= 0 ? newLine : m_buffer.size();
+        m_bufferPos = newLine >= 0 ? end + 1 : end;
+        return decodeBuffered(start, end);
+    }
     auto result = m_codec->toUnicode(m_file->readLine());
     if (!result.isEmpty() && result.back() == QLatin1Char('\n'))
         result.chop(1);
@@ -202,12 +227,24 @@ QString TextFile::readLine()
 QString TextFile::readAll()
 {
     checkForClosed();
+    if (m_isBuffered) {
+        const QString result = decodeBuffered(m_bufferPos, m_buffer.size());
+        m_bufferPos = m_buffer.size();
+        return result;
+    }
     return m_codec->toUnicode(m_file->readAll());
 }
 
+QString TextFile::decodeBuffered(qsizetype start, qsizetype end) const
+{
+    return m_codec->toUnicode(m_buffer.constData() + start, int(end - start));
+}
+
 bool TextFile::atEof() const
 {
     checkForClosed();
+    if (m_isBuffered)
+        return m_bufferPos >= m_buffer.size();
     return m_file->atEnd();
 }
 
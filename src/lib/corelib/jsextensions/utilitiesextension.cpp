@@ -47,6 +47,7 @@
 #include <tools/hostosinfo.h>
 #include <tools/stlutils.h>
 #include <tools/stringconstants.h>
+#include <tools/threadpool.h>
 #include <tools/toolchains.h>
 #include <tools/version.h>
 
@@ -105,6 +106,7 @@ public:
     static JSValue js_canonicalToolchain(JSContext *ctx, JSValueConst, int, JSValueConst *);
     static JSValue js_cStringQuote(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue js_getHash(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
+    static JSValue js_getFileHash(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue js_getNativeSetting(JSContext *ctx, JSValueConst, int argc, JSValueConst *argv);
     static JSValue js_kernelVersion(JSContext *ctx, JSValueConst, int, JSValueConst *);
     static JSValue js_nativeSettingGroups(JSContext *ctx, JSValueConst, int, JSValueConst *);
@@ -176,6 +178,7 @@ void UtilitiesExtension::setupStaticMethods(JSContext *ctx, JSValue classObj)
                       &UtilitiesExtension::js_canonicalToolchain, 1);
     setupMethod(ctx, classObj, "cStringQuote", &UtilitiesExtension::js_cStringQuote, 1);
     setupMethod(ctx, classObj, "getHash", &UtilitiesExtension::js_getHash, 1);
+    setupMethod(ctx, classObj, "getFileHash", &UtilitiesExtension::js_getFileHash, 2);
     setupMethod(ctx, classObj, "getNativeSetting",
                       &UtilitiesExtension::js_getNativeSetting, 3);
     setupMethod(ctx, classObj, "kernelVersion", &UtilitiesExtension::js_kernelVersion, 0);
@@ -384,11 +387,73 @@ JSValue UtilitiesExtension::js_getHash(JSContext *ctx, JSValueConst, int argc, J
     }
 }
 
+static QCryptographicHash::Algorithm hashAlgorithm(const QString &name)
+{
+    if (name == QLatin1String("md5"))
+        return QCryptographicHash::Md5;
+    if (name == QLatin1String("sha1"))
+        return QCryptographicHash::Sha1;
+    if (name == QLatin1String("sha256"))
+        return QCryptographicHash::Sha256;
+    if (name == QLatin1String("sha512"))
+        return QCryptographicHash::Sha512;
+    throw Tr::tr("Utilities.getFileHash: Unsupported hash algorithm '%1'.").arg(name);
+}
+
+// Streams the file contents into the hash, without ever holding the whole file in memory.
+static QString fileHash(const QString &filePath, QCryptographicHash::Algorithm algorithm)
+{
+    QFile file(filePath);
+    if (Q_UNLIKELY(!file.open(QIODevice::ReadOnly))) {
+        throw Tr::tr("Utilities.getFileHash: Cannot open '%1': %2")
+                .arg(filePath, file.errorString());
+    }
+    QCryptographicHash hash(algorithm);
+    QByteArray buffer(256 * 1024, Qt::Uninitialized);
+    while (true) {
+        const qint64 bytesRead = file.read(buffer.data(), buffer.size());
+        if (Q_UNLIKELY(bytesRead < 0)) {
+            throw Tr::tr("Utilities.getFileHash: Cannot read '%1': %2")
+                    .arg(filePath, file.errorString());
+        }
+        if (bytesRead == 0)
+            break;
+        hash.addData(QByteArray::fromRawData(buffer.constData(), int(bytesRead)));
+    }
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+JSValue UtilitiesExtension::js_getFileHash(JSContext *ctx, JSValueConst,
+                                           int argc, JSValueConst *argv)
+{
+    try {
+        if (argc < 1)
+            throw Tr::tr("Utilities.getFileHash requires at least 1 argument.");
+        const QCryptographicHash::Algorithm algorithm = hashAlgorithm(
+                    argc > 1 ? fromArg<QString>(ctx, "Utilities.getFileHash", 2, argv[1])
+                             : QStringLiteral("sha256"));
+        ScriptEngine::engineForContext(ctx)->setUsesIo();
+        if (!JS_IsArray(ctx, argv[0])) {
+            const auto filePath = fromArg<QString>(ctx, "Utilities.getFileHash", 1, argv[0]);
+            return makeJsString(ctx, fileHash(filePath, algorithm));
+        }
+        const auto filePaths = fromArg<QStringList>(ctx, "Utilities.getFileHash", 1, argv[0]);
+        const std::vector<QString> hashes = ThreadPool::ioInstance().mapped(
+                    filePaths, [algorithm](const QString &filePath) {
+            return fileHash(filePath, algorithm);
+        }, 4);
+        return makeJsStringList(ctx, QStringList(hashes.cbegin(), hashes.cend()));
+    } catch (const QString &error) {
+        return throwError(ctx, error);
+    }
+}
+
 JSValue UtilitiesExtension::js_getNativeSetting(JSContext *ctx, JSValueConst,
                                                 int argc, JSValueConst *argv)
 {
     try {
         const auto path = getArgument<QString>(ctx, "Utilities.getNativeSetting", argc, argv);
+        ScriptEngine::engineForContext(ctx)->addExternalStateQuery();
 
         QString key;
         if (argc > 1)
@@ -43,6 +43,7 @@
 #include "filecontext.h"
 #include "filetags.h"
 #include "item.h"
+#include "purebindingcache.h"
 #include "scriptengine.h"
 #include "value.h"
 
@@ -61,6 +62,8 @@
 
 #include <QtCore/qdebug.h>
 
+#include <algorithm>
+
 namespace qbs {
 namespace Internal {
 
@@ -71,6 +74,113 @@ public:
     mutable QHash<QString, JSValue> valueCache;
 };
 
+// Whether converting the value to a QVariant and back yields the same value.
+static bool isRoundTripSafe(JSContext *ctx, JSValue v)
+{
+    if (JS_IsArray(ctx, v)) {
+        const int length = getJsIntProperty(ctx, v, StringConstants::lengthProperty());
+        for (int i = 0; i < length; ++i) {
+            const ScopedJsValue elem(ctx, JS_GetPropertyUint32(ctx, v, i));
+            if (JS_IsUndefined(elem) || !isRoundTripSafe(ctx, elem))
+                return false;
+        }
+        return true;
+    }
+    const int tag = JS_VALUE_GET_TAG(v);
+    return tag == JS_TAG_STRING || tag == JS_TAG_BOOL || tag == JS_TAG_INT
+            || tag == JS_TAG_UNDEFINED;
+}
+
+// Collects the item properties that a binding reads, so that its result can be shared
+// with other evaluations of the binding that read the same values. See PureBindingCache.
+class PropertyReadRecorder
+{
+public:
+    PropertyReadRecorder(JSClassID classId, span<const JSValue> scopes)
+        : m_classId(classId), m_scopes(scopes)
+    {}
+
+    void addRead(JSContext *ctx, JSValue object, const QString &name, JSValue value)
+    {
+        addRead(ctx, object, name, value, true);
+    }
+
+    // The name was looked up in the object, but the object has no such property.
+    void addMiss(JSContext *ctx, JSValue object, const QString &name)
+    {
+        addRead(ctx, object, name, JS_UNDEFINED, false);
+    }
+
+    void invalidate() { m_isValid = false; }
+    bool isValid() const { return m_isValid; }
+    PureBindingCache::PropertyReads takeReads() { return std::move(m_reads); }
+
+private:
+    void addRead(JSContext *ctx, JSValue object, const QString &name, JSValue value, bool found)
+    {
+        if (!m_isValid)
+            return;
+        PureBindingCache::PropertyRead read;
+        read.name = name;
+        read.found = found;
+        const auto isObject = [object](JSValue v) {
+            return JS_IsObject(v) && JS_VALUE_GET_PTR(v) == JS_VALUE_GET_PTR(object);
+        };
+        const auto scope = std::find_if(m_scopes.begin(), m_scopes.end(), isObject);
+        if (scope != m_scopes.end()) {
+            read.scopeIndex = int(scope - m_scopes.begin());
+        } else {
+            const auto itemValue = std::find_if(m_itemValues.cbegin(), m_itemValues.cend(),
+                                                isObject);
+            if (itemValue == m_itemValues.cend()) {
+                invalidate(); // The object cannot be found again by other evaluations.
+                return;
+            }
+            read.readIndex = int(itemValue - m_itemValues.cbegin());
+        }
+        for (const PureBindingCache::PropertyRead &r : m_reads) {
+            if (r.scopeIndex == read.scopeIndex && r.readIndex == read.readIndex
+                    && r.name == name) {
+                return;
+            }
+        }
+        if (!found) {
+            m_itemValues.push_back(JS_UNDEFINED);
+        } else if (attachedPointer<EvaluationData>(value, m_classId)) {
+            m_itemValues.push_back(value);
+        } else if (isRoundTripSafe(ctx, value)) {
+            read.value = getJsVariant(ctx, value);
+            m_itemValues.push_back(JS_UNDEFINED);
+        } else {
+            invalidate();
+            return;
+        }
+        m_reads.push_back(std::move(read));
+    }
+
+    const JSClassID m_classId;
+    const span<const JSValue> m_scopes;
+    std::vector<JSValue> m_itemValues; // Indexed like m_reads.
+    PureBindingCache::PropertyReads m_reads;
+    bool m_isValid = true;
+};
+
+// Makes the property reads in the current scope count for a different binding, or for none.
+class PropertyReadRecorderSwitch
+{
+public:
+    PropertyReadRecorderSwitch(Evaluator &evaluator, PropertyReadRecorder *recorder)
+        : m_evaluator(evaluator), m_previous(evaluator.setPropertyReadRecorder(recorder))
+    {}
+    ~PropertyReadRecorderSwitch() { m_evaluator.setPropertyReadRecorder(m_previous); }
+
+    PropertyReadRecorder *previous() const { return m_previous; }
+
+private:
+    Evaluator &m_evaluator;
+    PropertyReadRecorder * const m_previous;
+};
+
 enum class ConversionType { Full, ElementsOnly };
 static void convertToPropertyType_impl(
     ScriptEngine *engine,
@@ -388,13 +498,16 @@ static void convertToPropertyType_impl(
 
     QString actualBaseDir;
     bool baseDirIsFromExport = false;
+    bool baseDirIsFromEvaluator = false;
     if (decl.type() == PropertyDeclaration::Path || decl.type() == PropertyDeclaration::PathList) {
         actualBaseDir = pathPropertiesBaseDir;
+        baseDirIsFromEvaluator = !actualBaseDir.isEmpty();
         if (const Item * const baseDirItem = value && value->scope() ? value->scope() : item) {
             if (const VariantValueConstPtr v = baseDirItem->variantProperty(
                     StringConstants::qbsSourceDirPropertyInternal())) {
                 actualBaseDir = v->value().toString();
                 baseDirIsFromExport = true;
+                baseDirIsFromEvaluator = false;
             }
             if (actualBaseDir.isEmpty() && baseDirItem->type() == ItemType::Product) {
                 if (const VariantValueConstPtr itemSourceDir = baseDirItem->variantProperty(
@@ -404,6 +517,14 @@ static void convertToPropertyType_impl(
             }
         }
     }
+    const auto notifyBaseDirUse = [&](const QString &rawPath) {
+        if (!baseDirIsFromEvaluator || FileInfo::isAbsolute(rawPath))
+            return;
+        if (PropertyReadObserver * const observer = engine->evaluator()
+                ? engine->evaluator()->propertyReadObserver() : nullptr) {
+            observer->onPathBaseDirUsed(actualBaseDir);
+        }
+    };
 
     switch (decl.type()) {
     case PropertyDeclaration::UnknownType:
@@ -424,6 +545,7 @@ static void convertToPropertyType_impl(
         }
         if (!actualBaseDir.isEmpty()) {
             const QString rawPath = getJsString(ctx, v);
+            notifyBaseDirUse(rawPath);
             if (baseDirIsFromExport && !FileInfo::isAbsolute(rawPath)) {
                 const JSValue error = handleDeprecatedPathResolving(*engine, *value);
                 if (JS_IsError(engine->context(), error)) {
@@ -472,6 +594,7 @@ static void convertToPropertyType_impl(
             if (actualBaseDir.isEmpty())
                 continue;
             const QString rawPath = getJsString(ctx, elem);
+            notifyBaseDirUse(rawPath);
             if (baseDirIsFromExport && !FileInfo::isAbsolute(rawPath)) {
                 const JSValue error = handleDeprecatedPathResolving(*engine, *value);
                 if (JS_IsError(engine->context(), error)) {
@@ -498,10 +621,12 @@ static void convertToPropertyType_impl(
 static int getEvalPropertyNames(JSContext *ctx, JSPropertyEnum **ptab, uint32_t *plen, JSValue obj)
 {
     ScriptEngine * const engine = ScriptEngine::engineForContext(ctx);
-    const Evaluator * const evaluator = engine->evaluator();
+    Evaluator * const evaluator = engine->evaluator();
     const auto data = attachedPointer<EvaluationData>(obj, evaluator->classId());
     if (!data)
         return -1;
+    if (PropertyReadRecorder * const recorder = evaluator->propertyReadRecorder())
+        recorder->invalidate(); // The set of names is not recorded.
     const Item::PropertyMap &map = data->item->properties();
     *plen = map.size();
     if (!map.isEmpty()) {
@@ -545,7 +670,8 @@ class PropertyStackManager
 public:
     PropertyStackManager(const Item *itemOfProperty, const QString &name, const Value *value,
                          std::stack<QualifiedId> &requestedProperties,
-                         PropertyDependencies &propertyDependencies)
+                         PropertyDependencies &propertyDependencies,
+                         PropertyReadObserver *observer)
         : m_requestedProperties(requestedProperties)
     {
         if (value->type() == Value::JSSourceValueType
@@ -559,8 +685,11 @@ public:
             m_stackUpdate = true;
             const QualifiedId fullPropName
                     = QualifiedId::fromString(varValue->value().toString()) << name;
-            if (!requestedProperties.empty())
+            if (!requestedProperties.empty()) {
                 propertyDependencies[fullPropName].insert(requestedProperties.top());
+                if (observer)
+                    observer->onPropertyDependency(fullPropName, requestedProperties.top());
+            }
             m_requestedProperties.push(fullPropName);
         }
     }
@@ -927,12 +1056,124 @@ private:
             if (JS_ToBool(m_engine.context(), sv))
                 elseCaseValue->setIsExclusiveListValue();
         }
-        return m_engine.evaluate(
+        return evaluateBinding(value, scopeChain, JS_IsObject(maybeExtraScope));
+    }
+
+    // A binding is evaluated only once per resolve for all contexts in which the item
+    // properties it reads have the same values, see PureBindingCache.
+    JSValue evaluateBinding(
+        const JSSourceValue *value, const ScopeChain &scopeChain, bool hasExtraScope)
+    {
+        const QString sourceCode = value->sourceCodeForEvaluation();
+        PureBindingCache * const cache
+            = hasExtraScope ? nullptr : m_evaluator.pureBindingCache();
+        QString cacheKey;
+        std::shared_ptr<const PureBindingCache::Results> cachedResults;
+        if (cache) {
+            cacheKey = PureBindingCache::key(*value, sourceCode);
+            cachedResults = cache->lookup(cacheKey);
+            if (cachedResults) {
+                for (const PureBindingCache::Result &cachedResult : *cachedResults) {
+                    if (!readsMatch(cachedResult.reads, scopeChain))
+                        continue;
+                    cache->addHit();
+                    const JSValue result = m_engine.toScriptValue(cachedResult.value);
+                    m_engine.takeOwnership(result);
+                    return result;
+                }
+            }
+        }
+
+        const bool record = cache && (!cachedResults || !cachedResults->empty());
+        PropertyReadRecorder recorder(m_evaluator.classId(), scopeChain.chain());
+        const PropertyReadRecorderSwitch recorderSwitch(m_evaluator, record ? &recorder : nullptr);
+        const int externalStateQueryCount = m_engine.externalStateQueryCount();
+        const JSValue result = m_engine.evaluate(
             JsValueOwner::ScriptEngine,
-            value->sourceCodeForEvaluation(),
+            sourceCode,
             value->file()->filePath(),
             value->line(),
             scopeChain.chain());
+        if (!record)
+            return result;
+        JSContext * const ctx = m_engine.context();
+        if (JS_IsException(result) || JS_IsError(ctx, result) || JS_HasException(ctx))
+            return result;
+        if (recorder.isValid() && m_engine.externalStateQueryCount() == externalStateQueryCount
+                && isRoundTripSafe(ctx, result)) {
+            cache->insert(cacheKey, {recorder.takeReads(), getJsVariant(ctx, result)});
+        } else {
+            cache->setUncacheable(cacheKey);
+        }
+        return result;
+    }
+
+    // Whether the item properties read by an earlier evaluation of the binding have the
+    // same values in the current context.
+    bool readsMatch(const PureBindingCache::PropertyReads &reads, const ScopeChain &scopeChain)
+    {
+        const PropertyReadRecorderSwitch recorderSwitch(m_evaluator, nullptr);
+        JSContext * const ctx = m_engine.context();
+        const auto scopes = scopeChain.chain();
+        std::vector<ScopedJsValue> values;
+        values.reserve(reads.size());
+        for (const PureBindingCache::PropertyRead &read : reads) {
+            if (!read.found) {
+                // The name must still be absent, so that it resolves to the same thing as before,
+                // e.g. an import or a global object.
+                JSValue object = JS_UNDEFINED;
+                if (read.scopeIndex < 0)
+                    object = values.at(read.readIndex);
+                else if (read.scopeIndex < int(scopes.size()))
+                    object = scopes[read.scopeIndex];
+                if (!attachedPointer<EvaluationData>(object, m_evaluator.classId())
+                        || hasItemProperty(object, read.name)) {
+                    return false;
+                }
+                values.emplace_back(ctx, JS_UNDEFINED);
+                continue;
+            }
+            JSValue object = JS_UNDEFINED;
+            if (read.scopeIndex >= 0) {
+                // The name must still be resolved via the same scope.
+                if (read.scopeIndex >= int(scopes.size())
+                        || !hasItemProperty(scopes[read.scopeIndex], read.name)) {
+                    return false;
+                }
+                for (int i = read.scopeIndex + 1; i < int(scopes.size()); ++i) {
+                    if (hasItemProperty(scopes[i], read.name))
+                        return false;
+                }
+                object = scopes[read.scopeIndex];
+            } else {
+                object = values.at(read.readIndex);
+            }
+            values.emplace_back(ctx, JS_GetPropertyStr(ctx, object,
+                                                       read.name.toUtf8().constData()));
+            const JSValue v = values.back();
+            if (JS_IsException(v)) {
+                JS_FreeValue(ctx, JS_GetException(ctx)); // The evaluation will throw again.
+                return false;
+            }
+            if (read.value) {
+                if (!isRoundTripSafe(ctx, v) || getJsVariant(ctx, v) != *read.value)
+                    return false;
+            } else if (!attachedPointer<EvaluationData>(v, m_evaluator.classId())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Whether getEvalProperty() finds the name in the scope.
+    bool hasItemProperty(JSValue scope, const QString &name) const
+    {
+        const auto data = attachedPointer<EvaluationData>(scope, m_evaluator.classId());
+        if (!data)
+            return false;
+        const Item * const item = data->item;
+        return name == QStringLiteral("parent") || item->hasProperty(name)
+                || (item->parent() && item->parent()->hasProperty(name));
     }
 
     JSValue doHandle(ItemValue *value) override
@@ -988,13 +1229,16 @@ static EvalResult getEvalProperty(
         if (!value)
             continue;
         const Item * const itemOfProperty = item;     // The item that owns the property.
+        PropertyReadObserver * const observer = evaluator.propertyReadObserver();
         PropertyStackManager propStackmanager(
             itemOfProperty,
             name,
             value.get(),
             evaluator.requestedProperties(),
-            evaluator.propertyDependencies());
-        if (evaluator.cachingEnabled()) {
+            evaluator.propertyDependencies(),
+            observer);
+        if (evaluator.cachingEnabled()
+            && (!observer || observer->allowsCachedValue(data->item))) {
             evaluator.clearCacheIfInvalidated(*data);
             const auto result = data->valueCache.constFind(name);
             if (result != data->valueCache.constEnd()) {
@@ -1032,6 +1276,38 @@ static EvalResult getEvalProperty(
     return {JS_UNDEFINED, false};
 }
 
+class PropertyReadNotifier
+{
+public:
+    PropertyReadNotifier(PropertyReadObserver *observer, const Item *item, const QString &name)
+        : m_observer(observer), m_item(item), m_name(name)
+    {
+        if (m_observer)
+            m_observer->onPropertyReadStarted(m_item);
+    }
+
+    ~PropertyReadNotifier()
+    {
+        if (m_observer)
+            m_observer->onPropertyReadFinished(m_item, m_name, m_found, m_failed, m_value);
+    }
+
+    void setResult(bool found, JSValue value)
+    {
+        m_found = found;
+        m_failed = false;
+        m_value = value;
+    }
+
+private:
+    PropertyReadObserver * const m_observer;
+    const Item * const m_item;
+    const QString &m_name;
+    bool m_found = false;
+    bool m_failed = true;
+    JSValue m_value = JS_UNDEFINED;
+};
+
 static int getEvalProperty(JSContext *ctx, JSPropertyDescriptor *desc, JSValue obj, JSAtom prop)
 {
     if (desc) {
@@ -1045,12 +1321,16 @@ static int getEvalProperty(JSContext *ctx, JSPropertyDescriptor *desc, JSValue o
     if (debugProperties)
         qDebug() << "[SC] queryProperty " << jsObjectId(obj) << " " << name;
 
+    // Reads done while evaluating the property belong to the property's own binding.
+    const PropertyReadRecorderSwitch recorderSwitch(evaluator, nullptr);
+
     if (name == QStringLiteral("parent")) {
-        if (desc) {
-            Item * const parent = data->item->parent();
-            desc->value = parent ? JS_DupValue(ctx, evaluator.scriptValue(data->item->parent()))
-                                 : JS_UNDEFINED;
-        }
+        Item * const parent = data->item->parent();
+        const JSValue parentValue = parent ? evaluator.scriptValue(parent) : JS_UNDEFINED;
+        if (PropertyReadRecorder * const recorder = recorderSwitch.previous())
+            recorder->addRead(ctx, obj, name, parentValue);
+        if (desc)
+            desc->value = JS_DupValue(ctx, parentValue);
         return 1;
     }
 
@@ -1061,6 +1341,7 @@ static int getEvalProperty(JSContext *ctx, JSPropertyDescriptor *desc, JSValue o
         return -1;
     }
 
+    PropertyReadNotifier readNotifier(evaluator.propertyReadObserver(), data->item, name);
     EvalResult result = getEvalProperty(evaluator, obj, data->item, name, data);
     if (!result.found && data->item->parent()) {
         if (debugProperties)
@@ -1069,13 +1350,19 @@ static int getEvalProperty(JSContext *ctx, JSPropertyDescriptor *desc, JSValue o
         result = getEvalProperty(
             evaluator, evaluator.scriptValue(parentItem), parentItem, name, data);
     }
+    if (!JS_IsException(result.v) && !JS_IsError(ctx, result.v) && !JS_HasException(ctx))
+        readNotifier.setResult(result.found, result.v);
     if (result.found) {
+        if (PropertyReadRecorder * const recorder = recorderSwitch.previous())
+            recorder->addRead(ctx, obj, name, result.v);
         if (desc)
             desc->value = JS_DupValue(ctx, result.v);
         engine.setLastLookupStatus(true);
         return 1;
     }
 
+    if (PropertyReadRecorder * const recorder = recorderSwitch.previous())
+        recorder->addMiss(ctx, obj, name);
     if (debugProperties)
         qDebug() << "[SC] queryProperty: no such property";
     engine.setLastLookupStatus(false);
@@ -52,6 +52,7 @@
 #include <mutex>
 #include <optional>
 #include <stack>
+#include <utility>
 
 namespace qbs {
 namespace Internal {
@@ -59,8 +60,28 @@ class EvaluationData;
 class FileTags;
 class Logger;
 class PropertyDeclaration;
+class PropertyReadRecorder;
+class PureBindingCache;
 class ScriptEngine;
 
+// Gets notified about all item property lookups done by the evaluator,
+// including the ones triggered from inside JavaScript code.
+class PropertyReadObserver
+{
+public:
+    virtual ~PropertyReadObserver() = default;
+    virtual bool allowsCachedValue(const Item *item) const = 0;
+    virtual void onPropertyReadStarted(const Item *item) = 0;
+
+    // The value is only valid if the property was found and the lookup did not fail.
+    virtual void onPropertyReadFinished(const Item *item, const QString &name, bool found,
+                                        bool failed, JSValue value) = 0;
+
+    virtual void onPathBaseDirUsed(const QString &baseDir) = 0;
+    virtual void onPropertyDependency(const QualifiedId &property,
+                                      const QualifiedId &dependentProperty) = 0;
+};
+
 class QBS_AUTOTEST_EXPORT Evaluator : private ItemObserver
 {
     friend class SVConverter;
@@ -111,6 +132,9 @@ public:
 
     std::stack<QualifiedId> &requestedProperties() { return m_requestedProperties; }
 
+    void setPropertyReadObserver(PropertyReadObserver *observer) { m_readObserver = observer; }
+    PropertyReadObserver *propertyReadObserver() const { return m_readObserver; }
+
     void handleEvaluationError(const Item *item, const QString &name);
 
     QString pathPropertiesBaseDir() const { return m_pathPropertiesBaseDir; }
@@ -118,6 +142,18 @@ public:
     void clearPathPropertiesBaseDir() { m_pathPropertiesBaseDir.clear(); }
 
     bool isNonDefaultValue(const Item *item, const QString &name) const;
+
+    void setPureBindingCache(PureBindingCache *cache) { m_pureBindingCache = cache; }
+    PureBindingCache *pureBindingCache() const { return m_pureBindingCache; }
+
+    // Collects the item properties read by the binding that is currently being evaluated,
+    // see PureBindingCache.
+    PropertyReadRecorder *propertyReadRecorder() const { return m_propertyReadRecorder; }
+    PropertyReadRecorder *setPropertyReadRecorder(PropertyReadRecorder *recorder)
+    {
+        return std::exchange(m_propertyReadRecorder, recorder);
+    }
+
 private:
     void onItemPropertyChanged(Item *item) override { invalidateCache(item); }
     JSValue evaluateProperty(const Item *item, const QString &name, bool *propertyWasSet);
@@ -130,6 +166,9 @@ private:
     QString m_pathPropertiesBaseDir;
     PropertyDependencies m_propertyDependencies;
     std::stack<QualifiedId> m_requestedProperties;
+    PropertyReadObserver *m_readObserver = nullptr;
+    PureBindingCache *m_pureBindingCache = nullptr;
+    PropertyReadRecorder *m_propertyReadRecorder = nullptr;
     std::mutex m_cacheInvalidationMutex;
     Set<const Item *> m_invalidatedCaches;
     bool m_valueCacheEnabled = false;
@@ -56,6 +56,7 @@
 #include <logging/categories.h>
 #include <logging/translator.h>
 #include <tools/buildgraphlocker.h>
+#include <tools/directorylistingcache.h>
 #include <tools/hostosinfo.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
@@ -68,12 +69,14 @@
 
 #include <QtCore/qcryptographichash.h>
 #include <QtCore/qdir.h>
-#include <QtCore/qdiriterator.h>
 #include <QtCore/qmap.h>
+#include <QtCore/qregularexpression.h>
 
 #include <algorithm>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 
 namespace qbs {
 namespace Internal {
@@ -550,18 +553,6 @@ std::vector<ResolvedProductPtr> ResolvedProject::allProducts() const
 void ResolvedProject::load(PersistentPool &pool)
 {
     serializationOp<PersistentPool::Load>(pool);
-    std::for_each(products.cbegin(), products.cend(),
-                  [](const ResolvedProductPtr &p) {
-        if (!p->buildData)
-            return;
-        for (BuildGraphNode * const node : std::as_const(p->buildData->allNodes())) {
-            node->product = p;
-
-            // restore parent links
-            for (BuildGraphNode * const child : std::as_const(node->children))
-                child->parents.insert(node);
-        }
-    });
 }
 
 void ResolvedProject::store(PersistentPool &pool)
@@ -626,42 +617,173 @@ QString TopLevelProject::buildGraphFilePath() const
     return ProjectBuildData::deriveBuildGraphFilePath(buildDirectory, id());
 }
 
-void TopLevelProject::store(Logger logger)
+void TopLevelProject::store(Logger logger, bool inBackground)
 {
     // TODO: Use progress observer here.
 
     if (!buildData)
         return;
-    if (!buildData->isDirty()) {
+    const QString fileName = buildGraphFilePath();
+
+    // A failed background write removes the file, so everything has to be written again.
+    const ErrorInfo backgroundWriteError = PersistentPool::waitForBackgroundWrite(fileName);
+    if (backgroundWriteError.hasError()) {
+        logger.printWarning(backgroundWriteError);
+        buildData->setDirty();
+    }
+    const std::vector<ResolvedProduct *> products = productsInStorageOrder();
+    const int firstSection = firstSectionToStore(products);
+    if (firstSection < 0) {
         qCDebug(lcBuildGraph) << "build graph is unchanged in project" << id();
         return;
     }
 
-    makeModuleProvidersNonTransient();
-
-    const QString fileName = buildGraphFilePath();
-    qCDebug(lcBuildGraph) << "storing:" << fileName;
     PersistentPool pool(logger);
     PersistentPool::HeadData headData;
     headData.projectConfig = buildConfiguration();
     pool.setHeadData(headData);
-    pool.setupWriteStream(fileName);
-    store(pool);
-    pool.finalizeWriteStream();
-    buildData->setClean();
-}
-
+    if (firstSection > 0
+            && pool.setupWriteStream(fileName, std::move(*buildData->storedState), firstSection)) {
+        qCDebug(lcBuildGraph) << "storing:" << fileName << "starting at section" << firstSection;
+        storeBuildData(pool, products, firstSection);
+    } else {
+        qCDebug(lcBuildGraph) << "storing:" << fileName;
+        makeModuleProvidersNonTransient();
+        pool.setupWriteStream(fileName);
+        store(pool);
+    }
+    buildData->storedState.reset();
+    if (inBackground)
+        pool.finalizeWriteStreamInBackground();
+    else
+        pool.finalizeWriteStream();
+    buildData->storedState = pool.takeStoredState();
+    setBuildDataClean();
+}
+
+// Layout of the build graph file: The first section contains the resolved project without
+// any build data. It is followed by one section per product holding the product's build data,
+// and a final section with the project's build data.
 void TopLevelProject::load(PersistentPool &pool)
 {
     ResolvedProject::load(pool);
     serializationOp<PersistentPool::Load>(pool);
+
+    const std::vector<ResolvedProductPtr> products = allProducts();
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        pool.beginSection();
+        const ResolvedProductPtr &product = products.at(pool.load<int>());
+        pool.load(product->buildData);
+    }
+    pool.beginSection();
+    pool.load(buildData);
     QBS_CHECK(buildData);
+
+    for (const ResolvedProductPtr &product : products) {
+        if (!product->buildData)
+            continue;
+        for (BuildGraphNode * const node : std::as_const(product->buildData->allNodes())) {
+            node->product = product;
+
+            // restore parent links
+            for (BuildGraphNode * const child : std::as_const(node->children))
+                child->parents.insert(node);
+        }
+    }
+    buildData->storedState = pool.takeStoredState();
+    setBuildDataClean();
 }
 
 void TopLevelProject::store(PersistentPool &pool)
 {
     ResolvedProject::store(pool);
     serializationOp<PersistentPool::Store>(pool);
+    storeBuildData(pool, productsInStorageOrder(), 1);
+}
+
+// Dependencies come first, so that the nodes of a product are normally stored in the product's
+// own section, and changes to a product require rewriting only the sections from there on.
+std::vector<ResolvedProduct *> TopLevelProject::productsInStorageOrder() const
+{
+    const std::vector<ResolvedProductPtr> products = allProducts();
+    Set<const ResolvedProduct *> productSet;
+    for (const ResolvedProductPtr &product : products)
+        productSet.insert(product.get());
+    std::vector<ResolvedProduct *> ordered;
+    ordered.reserve(products.size());
+    Set<const ResolvedProduct *> seen;
+    const auto add = [&](const auto &add, ResolvedProduct *product) -> void {
+        if (!productSet.contains(product) || !seen.insert(product).second)
+            return;
+        for (const ResolvedProductPtr &dependency : product->dependencies)
+            add(add, dependency.get());
+        ordered.push_back(product);
+    };
+    for (const ResolvedProductPtr &product : products)
+        add(add, product.get());
+    return ordered;
+}
+
+void TopLevelProject::storeBuildData(PersistentPool &pool,
+                                     const std::vector<ResolvedProduct *> &products,
+                                     int firstSection)
+{
+    const std::vector<ResolvedProductPtr> productsByIndex = allProducts();
+    for (auto i = std::size_t(firstSection - 1); i < products.size(); ++i) {
+        pool.beginSection();
+        const auto it = std::find_if(productsByIndex.cbegin(), productsByIndex.cend(),
+                [product = products.at(i)](const ResolvedProductPtr &p) {
+            return p.get() == product;
+        });
+        pool.store(int(it - productsByIndex.cbegin()));
+        pool.store(products.at(i)->buildData);
+    }
+    pool.beginSection();
+    pool.store(buildData);
+}
+
+// Returns the first section of the build graph file that needs to be rewritten, 0 if the complete
+// file must be written and -1 if nothing has changed.
+int TopLevelProject::firstSectionToStore(const std::vector<ResolvedProduct *> &products) const
+{
+    const PersistentPool::StoredState * const state = buildData->storedState.get();
+    if (!state || buildData->isDirty() || state->sectionCount() != int(products.size()) + 2)
+        return 0;
+    if (Internal::any_of(moduleProviderInfo.providers, [](const auto &item) {
+            return item.second.transientOutput; })) {
+        return 0;
+    }
+
+    const int lastSection = state->sectionCount() - 1;
+    int firstSection = -1;
+    const auto addSection = [&](int section) {
+        if (section < 0) // A new object.
+            section = lastSection;
+        if (firstSection < 0 || section < firstSection)
+            firstSection = section;
+    };
+    for (std::size_t i = 0; i < products.size(); ++i) {
+        const ProductBuildData * const productData = products.at(i)->buildData.get();
+        if (!productData || !productData->isDirty())
+            continue;
+        addSection(int(i) + 1);
+        for (const BuildGraphNode * const node : productData->allNodes())
+            addSection(state->sectionOf(node));
+    }
+    for (const int section : buildData->dirtySections())
+        addSection(section);
+    if (buildData->rawScanResultsDirty())
+        addSection(lastSection);
+    return firstSection;
+}
+
+void TopLevelProject::setBuildDataClean()
+{
+    buildData->setClean();
+    for (const ResolvedProductPtr &product : allProducts()) {
+        if (product->buildData)
+            product->buildData->setClean();
+    }
 }
 
 void TopLevelProject::cleanupModuleProviderOutput()
@@ -712,108 +834,206 @@ void TopLevelProject::cleanupModuleProviderOutput()
  * \brief The \c SourceArtifacts resulting from the expanded list of matching files.
  */
 
-void SourceWildCards::expandPatterns()
+namespace {
+// Expands the patterns of a SourceWildCards object one directory level at a time, so that
+// all directories of a level are listed in parallel. Every listed directory, including those
+// visited by recursive "**" patterns, is recorded with its timestamp.
+class WildcardExpander
+{
+public:
+    WildcardExpander(const QString &buildDir, DirectoryListingCache &cache,
+                     std::vector<std::pair<QString, FileTime>> &dirTimeStamps)
+        : m_buildDir(buildDir), m_cache(cache), m_dirTimeStamps(dirTimeStamps) {}
+
+    void addPattern(const QStringList &parts, const QString &baseDir, bool exclude);
+    Set<QString> expand();
+
+private:
+    struct Part
+    {
+        QString name;
+        QRegularExpression regExp;
+        bool recursive = false;
+        bool matchesHidden = false;
+    };
+    struct Pattern
+    {
+        std::vector<Part> parts;
+        bool exclude = false;
+    };
+    struct Task
+    {
+        QString dirPath;
+        const Pattern *pattern = nullptr;
+        size_t partIndex = 0;
+    };
+
+    void listDirectories(const std::vector<Task> &tasks);
+    void processTask(const Task &task);
+
+    const QString &m_buildDir;
+    DirectoryListingCache &m_cache;
+    std::vector<std::pair<QString, FileTime>> &m_dirTimeStamps;
+    std::deque<Pattern> m_patterns;
+    std::vector<Task> m_tasks;
+    std::unordered_map<QString, DirectoryListingCache::ListingPtr> m_listings;
+    std::vector<QString> m_files;
+    std::vector<QString> m_excludedFiles;
+};
+
+static QString appendPath(const QString &dirPath, const QString &name)
 {
-    dirTimeStamps.clear();
-    expandedFiles = expandPatterns(patterns) - expandPatterns(excludePatterns);
+    return dirPath.endsWith(QLatin1Char('/')) ? dirPath + name
+                                              : dirPath + QLatin1Char('/') + name;
 }
 
-Set<QString> SourceWildCards::expandPatterns(const QStringList &patterns)
+void WildcardExpander::addPattern(const QStringList &parts, const QString &baseDir, bool exclude)
 {
-    Set<QString> files;
-    QString expandedPrefix = prefix;
-    if (expandedPrefix.startsWith(StringConstants::tildeSlash()))
-        expandedPrefix.replace(0, 1, QDir::homePath());
-    for (QString pattern : patterns) {
-        pattern.prepend(expandedPrefix);
-        pattern.replace(QLatin1Char('\\'), QLatin1Char('/'));
-        QStringList parts = pattern.split(QLatin1Char('/'), Qt::SkipEmptyParts);
-        if (FileInfo::isAbsolute(pattern)) {
-            QString rootDir;
-            if (HostOsInfo::isWindowsHost() && pattern.at(0) != QLatin1Char('/')) {
-                rootDir = parts.takeFirst();
-                if (!rootDir.endsWith(QLatin1Char('/')))
-                    rootDir.append(QLatin1Char('/'));
-            } else {
-                rootDir = QLatin1Char('/');
-            }
-            expandPatterns(files, parts, rootDir);
-        } else {
-            expandPatterns(files, parts, baseDir);
+    Pattern pattern;
+    pattern.exclude = exclude;
+    bool recursive = false;
+    for (int i = 0; i < parts.size(); ++i) {
+        const bool isLast = i == parts.size() - 1;
+        if (parts.at(i) == QStringLiteral("**")) {
+            recursive = true;
+            if (!isLast)
+                continue;
         }
+        Part part;
+        part.name = parts.at(i) == QStringLiteral("**") ? StringConstants::star() : parts.at(i);
+
+        // Same semantics as the name filters of QDir.
+        part.regExp = QRegularExpression(
+                    QRegularExpression::wildcardToRegularExpression(part.name),
+                    QRegularExpression::CaseInsensitiveOption);
+        part.recursive = recursive;
+        part.matchesHidden = !isLast && !FileInfo::isPattern(part.name);
+        pattern.parts.push_back(std::move(part));
+        recursive = false;
     }
-
-    return files;
+    if (pattern.parts.empty())
+        return;
+    m_patterns.push_back(std::move(pattern));
+    m_tasks.push_back({baseDir, &m_patterns.back(), 0});
 }
 
-void SourceWildCards::expandPatterns(Set<QString> &result, const QStringList &parts,
-                                     const QString &baseDir)
+Set<QString> WildcardExpander::expand()
 {
-    // People might build directly in the project source directory. This is okay, since
-    // we keep the build data in a "container" directory. However, we must make sure we don't
-    // match any generated files therein as source files.
-    if (baseDir.startsWith(buildDir))
-        return;
-
-    QStringList changed_parts = parts;
-    bool recursive = false;
-    QString part = changed_parts.takeFirst();
-
-    while (part == QStringLiteral("**")) {
-        recursive = true;
+    while (!m_tasks.empty()) {
+        std::vector<Task> tasks;
+        std::swap(tasks, m_tasks);
 
-        if (changed_parts.empty()) {
-            part = StringConstants::star();
-            break;
-        }
+        // People might build directly in the project source directory. This is okay, since
+        // we keep the build data in a "container" directory. However, we must make sure we don't
+        // match any generated files therein as source files.
+        Internal::removeIf(tasks, [this](const Task &task) {
+            return task.dirPath.startsWith(m_buildDir);
+        });
 
-        part = changed_parts.takeFirst();
+        listDirectories(tasks);
+        for (const Task &task : tasks)
+            processTask(task);
     }
 
-    const bool isDir = !changed_parts.empty();
+    const auto toSet = [](std::vector<QString> &files) {
+        std::sort(files.begin(), files.end());
+        files.erase(std::unique(files.begin(), files.end()), files.end());
+        return Set<QString>(files.cbegin(), files.cend());
+    };
+    return toSet(m_files) - toSet(m_excludedFiles);
+}
 
-    const QString &filePattern = part;
-    const QDirIterator::IteratorFlags itFlags = recursive
-            ? QDirIterator::Subdirectories
-            : QDirIterator::NoIteratorFlags;
-    QDir::Filters itFilters = isDir
-            ? QDir::Dirs
-            : QDir::Files | QDir::System
-              | QDir::Dirs; // This one is needed to get symbolic links to directories
+void WildcardExpander::listDirectories(const std::vector<Task> &tasks)
+{
+    QStringList dirPaths;
+    for (const Task &task : tasks) {
+        if (m_listings.emplace(task.dirPath, nullptr).second)
+            dirPaths << task.dirPath;
+    }
+    const std::vector<DirectoryListingCache::ListingPtr> listings = m_cache.listings(dirPaths);
+    for (const DirectoryListingCache::ListingPtr &listing : listings) {
+        m_listings[listing->dirPath] = listing;
+        m_dirTimeStamps.emplace_back(listing->dirPath, listing->lastModified);
+    }
+}
 
-    if (FileInfo::isPattern(filePattern)) {
-        if (!recursive)
-            dirTimeStamps.emplace_back(baseDir, FileInfo(baseDir).lastModified());
-    } else if (isDir) {
-        itFilters |= QDir::Hidden;
+void WildcardExpander::processTask(const Task &task)
+{
+    const Part &part = task.pattern->parts.at(task.partIndex);
+    const bool isLast = task.partIndex == task.pattern->parts.size() - 1;
+    const DirectoryListingCache::Listing &listing = *m_listings.at(task.dirPath);
+    if (!part.recursive
+            && (part.name == StringConstants::dot() || part.name == StringConstants::dotDot())) {
+        if (!isLast && listing.lastModified.isValid())
+            m_tasks.push_back({appendPath(task.dirPath, part.name), task.pattern,
+                               task.partIndex + 1});
+        return;
     }
-    if (filePattern != StringConstants::dotDot() && filePattern != StringConstants::dot())
-        itFilters |= QDir::NoDotAndDotDot;
 
-    QDirIterator it(baseDir, QStringList(filePattern), itFilters, itFlags);
-    while (it.hasNext()) {
-        const QString filePath = it.next();
-        const QString parentDir = it.fileInfo().dir().path();
-        if (parentDir.startsWith(buildDir))
-            continue; // See above.
-        if (!isDir && it.fileInfo().isDir() && !it.fileInfo().isSymLink())
+    for (const DirectoryListingCache::Entry &entry : listing.entries) {
+        if (entry.isHidden && !part.matchesHidden)
+            continue;
+        const QString entryPath = appendPath(task.dirPath, entry.name);
+        if (part.recursive && entry.isDir && !entry.isSymLink)
+            m_tasks.push_back({entryPath, task.pattern, task.partIndex});
+        if (!part.regExp.match(entry.name).hasMatch())
             continue;
-        if (isDir)
-            expandPatterns(result, changed_parts, filePath);
-        else
-            result += QDir::cleanPath(filePath);
+        if (!isLast) {
+            if (entry.isDir)
+                m_tasks.push_back({entryPath, task.pattern, task.partIndex + 1});
+        } else if (!entry.isDir || entry.isSymLink) {
+            (task.pattern->exclude ? m_excludedFiles : m_files)
+                    .push_back(QDir::cleanPath(entryPath));
+        }
     }
 }
+} // namespace
+
+void SourceWildCards::expandPatterns(DirectoryListingCache *cache)
+{
+    DirectoryListingCache privateCache;
+    dirTimeStamps.clear();
+    WildcardExpander expander(buildDir, cache ? *cache : privateCache, dirTimeStamps);
+
+    QString expandedPrefix = prefix;
+    if (expandedPrefix.startsWith(StringConstants::tildeSlash()))
+        expandedPrefix.replace(0, 1, QDir::homePath());
+    const auto addPatterns = [&](const QStringList &patterns, bool exclude) {
+        for (QString pattern : patterns) {
+            pattern.prepend(expandedPrefix);
+            pattern.replace(QLatin1Char('\\'), QLatin1Char('/'));
+            QStringList parts = pattern.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+            if (FileInfo::isAbsolute(pattern)) {
+                QString rootDir;
+                if (HostOsInfo::isWindowsHost() && pattern.at(0) != QLatin1Char('/')) {
+                    rootDir = parts.takeFirst();
+                    if (!rootDir.endsWith(QLatin1Char('/')))
+                        rootDir.append(QLatin1Char('/'));
+                } else {
+                    rootDir = QLatin1Char('/');
+                }
+                expander.addPattern(parts, rootDir, exclude);
+            } else {
+                expander.addPattern(parts, baseDir, exclude);
+            }
+        }
+    };
+    addPatterns(patterns, false);
+    addPatterns(excludePatterns, true);
+    expandedFiles = expander.expand();
+}
 
 bool SourceWildCards::hasChangedSinceExpansion() const
 {
+    // All directories visited during expansion are recorded, so unchanged timestamps
+    // mean an unchanged result.
     const bool reExpansionRequired =
         Internal::any_of(dirTimeStamps,
                          [](const std::pair<QString, FileTime> &pair) {
-                             return FileInfo(pair.first).lastModified() > pair.second;
+                             return FileInfo(pair.first).lastModified() != pair.second;
                          });
-    if (reExpansionRequired)
-        return true;
+    if (!reExpansionRequired)
+        return false;
 
     auto wc = *this;
     wc.expandPatterns();
@@ -986,8 +1206,9 @@ JSValue PrivateScriptFunction::getFunction(ScriptEngine *engine, const QString &
 {
     if (JS_IsUndefined(scriptFunction)) {
         ScopedJsValue val(engine->context(),
-                          engine->evaluate(JsValueOwner::Caller, sourceCode(),
-                                           location().filePath(), location().line()));
+                          engine->evaluateCached(JsValueOwner::Caller, sourceCode(),
+                                                 location().filePath(),
+                                                 location().line()));
         if (Q_UNLIKELY(!JS_IsFunction(engine->context(), val)))
             throw ErrorInfo(errorMessage, location());
         scriptFunction = val.release();
@@ -77,6 +77,7 @@ namespace Internal {
 class BuildGraphLocker;
 class BuildGraphLoader;
 class BuildGraphVisitor;
+class DirectoryListingCache;
 class ScriptEngine;
 
 class FileTagger
@@ -262,7 +263,8 @@ inline bool operator!=(const SourceArtifactInternal &sa1, const SourceArtifactIn
 class SourceWildCards
 {
 public:
-    void expandPatterns();
+    // The cache is shared by all wildcards of a resolve. If none is given, a private one is used.
+    void expandPatterns(DirectoryListingCache *cache = nullptr);
     bool hasChangedSinceExpansion() const;
 
     // to be restored by the owning class
@@ -280,10 +282,6 @@ public:
     {
         pool.serializationOp<opType>(patterns, excludePatterns, dirTimeStamps);
     }
-
-private:
-    Set<QString> expandPatterns(const QStringList &patterns);
-    void expandPatterns(Set<QString> &result, const QStringList &parts, const QString &baseDir);
 };
 
 class QBS_AUTOTEST_EXPORT ResolvedGroup
@@ -601,6 +599,8 @@ public:
     std::vector<ProbeConstPtr> probes;
     std::vector<ArtifactPropertiesPtr> artifactProperties;
     QStringList missingSourceFiles;
+    Set<QString> buildSystemFiles; // The subset of the project's files this product depends on.
+    qint64 resolveTime = 0; // In ns. Used for scheduling the next resolve.
     std::unique_ptr<ProductBuildData> buildData;
 
     ExportedModule exportedModule;
@@ -650,8 +650,8 @@ private:
                                      missingSourceFiles, location, productProperties,
                                      moduleProperties, rules, dependencies, dependencyParameters,
                                      fileTaggers, modules, moduleParameters, scanners, groups,
-                                     artifactProperties, probes, exportedModule, buildData,
-                                     jobLimits);
+                                     artifactProperties, probes, exportedModule, jobLimits,
+                                     buildSystemFiles, resolveTime);
     }
 
     QHash<QString, QString> m_executablePathCache;
@@ -738,7 +738,7 @@ public:
     QVariantMap overriddenValues;
 
     QString buildGraphFilePath() const;
-    void store(Logger logger);
+    void store(Logger logger, bool inBackground = false);
 
 private:
     TopLevelProject();
@@ -749,10 +749,15 @@ private:
                                      directoryEntriesResults, fileLastModifiedResults, environment,
                                      probes, profileConfigs, overriddenValues, buildSystemFiles,
                                      lastStartResolveTime, lastEndResolveTime, warningsEncountered,
-                                     buildData, moduleProviderInfo, codeLinks);
+                                     moduleProviderInfo, codeLinks);
     }
     void load(PersistentPool &pool) override;
     void store(PersistentPool &pool) override;
+    std::vector<ResolvedProduct *> productsInStorageOrder() const;
+    void storeBuildData(PersistentPool &pool, const std::vector<ResolvedProduct *> &products,
+                        int firstSection);
+    int firstSectionToStore(const std::vector<ResolvedProduct *> &products) const;
+    void setBuildDataClean();
 
     void cleanupModuleProviderOutput();
 
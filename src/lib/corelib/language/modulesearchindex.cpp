@@ -0,0 +1,115 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "modulesearchindex.h"
+
+#include <tools/fileinfo.h>
+#include <tools/stringconstants.h>
+
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+
+#include <algorithm>
+
+namespace qbs {
+namespace Internal {
+
+QString ModuleSearchIndex::findModuleDirectory(const QString &searchPath,
+                                               const QualifiedId &moduleName)
+{
+    QString dirPath = searchPath + QStringLiteral("/modules");
+    for (const QString &moduleNamePart : moduleName) {
+        const auto dir = directory(dirPath);
+        const QStringList &subDirs = dir->subDirectories;
+        if (!std::binary_search(subDirs.cbegin(), subDirs.cend(), moduleNamePart))
+            return {};
+        dirPath = FileInfo::resolvePath(dirPath, moduleNamePart);
+    }
+    return dirPath;
+}
+
+QStringList ModuleSearchIndex::moduleFiles(const QString &moduleDirPath)
+{
+    QStringList filePaths;
+    const auto dir = directory(moduleDirPath);
+    const QStringList &fileNames = dir->qbsFiles;
+    filePaths.reserve(fileNames.size());
+    for (const QString &fileName : fileNames)
+        filePaths << moduleDirPath + QLatin1Char('/') + fileName;
+    return filePaths;
+}
+
+void ModuleSearchIndex::resetVerification(const QString &dirPath)
+{
+    // Look-ups that are in progress keep the old listings.
+    std::lock_guard lock(m_mutex);
+    for (auto it = m_directories.begin(); it != m_directories.end();) {
+        if (it.key() == dirPath || it.key().startsWith(dirPath + QLatin1Char('/')))
+            it = m_directories.erase(it);
+        else
+            ++it;
+    }
+}
+
+std::shared_ptr<const ModuleSearchIndex::Directory> ModuleSearchIndex::directory(
+        const QString &dirPath)
+{
+    std::shared_ptr<Directory> dir;
+    {
+        std::lock_guard lock(m_mutex);
+        std::shared_ptr<Directory> &entry = m_directories[dirPath];
+        if (!entry)
+            entry = std::make_shared<Directory>();
+        dir = entry;
+    }
+    std::call_once(dir->listed, [&dirPath, &listing = *dir] {
+        listing.subDirectories = QDir(dirPath).entryList(QDir::Dirs | QDir::NoDotAndDotDot,
+                                                         QDir::Unsorted);
+        std::sort(listing.subDirectories.begin(), listing.subDirectories.end());
+        QDirIterator dirIter(dirPath, StringConstants::qbsFileWildcards());
+        while (dirIter.hasNext()) {
+            dirIter.next();
+            listing.qbsFiles << dirIter.fileName();
+        }
+    });
+    return dir;
+}
+
+} // namespace Internal
+} // namespace qbs
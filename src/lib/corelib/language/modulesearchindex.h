@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_MODULESEARCHINDEX_H
+#define QBS_MODULESEARCHINDEX_H
+
+#include "qualifiedid.h"
+
+#include <tools/qbs_export.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+#include <mutex>
+
+namespace qbs {
+namespace Internal {
+
+// Index of the directories below the "modules" directories of all search paths, used during
+// one resolve. Each directory is listed at most once, so looking up a module is a sequence of
+// hash look-ups rather than one file system probe per module name and search path.
+// As the listed names are compared exactly, this also checks the case of module directories,
+// which is very expensive to do via the file system on some hosts.
+// The index is not stored, as directory time stamps are too coarse to tell whether
+// a listing is still valid.
+class QBS_AUTOTEST_EXPORT ModuleSearchIndex
+{
+public:
+    // An empty string means that the search path does not provide the module.
+    QString findModuleDirectory(const QString &searchPath, const QualifiedId &moduleName);
+
+    // The absolute paths of the qbs files in a module directory.
+    QStringList moduleFiles(const QString &moduleDirPath);
+
+    // Makes the next look-ups of the given directory and the ones below it consult the
+    // file system again, e.g. after a module provider has generated modules there.
+    void resetVerification(const QString &dirPath);
+
+private:
+    struct Directory
+    {
+        std::once_flag listed;
+        QStringList subDirectories; // Sorted.
+        QStringList qbsFiles;
+    };
+
+    // The directory is listed without holding m_mutex, so that threads looking up other
+    // directories do not have to wait for it.
+    std::shared_ptr<const Directory> directory(const QString &dirPath);
+
+    std::mutex m_mutex;
+    QHash<QString, std::shared_ptr<Directory>> m_directories;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_MODULESEARCHINDEX_H
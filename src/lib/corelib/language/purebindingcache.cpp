@@ -0,0 +1,83 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "purebindingcache.h"
+
+#include "filecontext.h"
+#include "value.h"
+
+namespace qbs {
+namespace Internal {
+
+QString PureBindingCache::key(const JSSourceValue &value, const QString &sourceCode)
+{
+    const QString filePath = value.file() ? value.file()->filePath() : QString();
+    return filePath + QLatin1Char(':') + QString::number(value.line()) + QLatin1Char(':')
+            + QString::number(value.column()) + QLatin1Char('\n') + sourceCode;
+}
+
+std::shared_ptr<const PureBindingCache::Results> PureBindingCache::lookup(
+    const QString &key) const
+{
+    return m_results.lock_shared().get().value(key);
+}
+
+void PureBindingCache::insert(const QString &key, Result result)
+{
+    auto resultsGuard = m_results.lock();
+    std::shared_ptr<const Results> &results = resultsGuard.get()[key];
+    if (results && results->empty())
+        return;
+    if (results && int(results->size()) >= maxResultsPerBinding) {
+        results = std::make_shared<const Results>();
+        return;
+    }
+    auto newResults = results ? std::make_shared<Results>(*results)
+                              : std::make_shared<Results>();
+    newResults->push_back(std::move(result));
+    results = std::move(newResults);
+}
+
+void PureBindingCache::setUncacheable(const QString &key)
+{
+    m_results.lock().get().insert(key, std::make_shared<const Results>());
+}
+
+} // namespace Internal
+} // namespace qbs
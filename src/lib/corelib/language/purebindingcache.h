@@ -0,0 +1,114 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_PUREBINDINGCACHE_H
+#define QBS_PUREBINDINGCACHE_H
+
+#include <tools/mutexdata.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qvariant.h>
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class JSSourceValue;
+
+/*
+ * Results of property bindings, shared by all script engines of a resolve.
+ * Along with each result, the item properties that the binding read are stored with
+ * their values. The result is valid for every module instance and product in which
+ * these properties have the same values, provided the binding did not query the
+ * environment or the file system and did not throw.
+ * Only values that survive the round trip through QVariant unchanged are stored, that is,
+ * strings, booleans, integers and arrays thereof.
+ * Bindings whose results cannot be stored are remembered as well, so they are not examined
+ * again. The same goes for bindings that yielded too many different results.
+ */
+class QBS_AUTOTEST_EXPORT PureBindingCache
+{
+public:
+    // A property is read either from one of the binding's scopes or from the item
+    // that an earlier read yielded. Reads that found nothing are recorded as well, because
+    // the name would resolve differently in a context where the property exists.
+    struct PropertyRead
+    {
+        int scopeIndex = -1;
+        int readIndex = -1;
+        QString name;
+        bool found = true;
+        std::optional<QVariant> value; // Not set if the value is an item or was not found.
+    };
+    using PropertyReads = std::vector<PropertyRead>;
+
+    struct Result
+    {
+        PropertyReads reads;
+        QVariant value;
+    };
+    using Results = std::vector<Result>;
+
+    static QString key(const JSSourceValue &value, const QString &sourceCode);
+
+    // Returns null if the binding has not been evaluated yet, and an empty list if its
+    // results are not stored.
+    std::shared_ptr<const Results> lookup(const QString &key) const;
+    void insert(const QString &key, Result result);
+    void setUncacheable(const QString &key);
+
+    void addHit() { ++m_hitCount; }
+    int hitCount() const { return m_hitCount; }
+
+private:
+    static const int maxResultsPerBinding = 8;
+
+    MutexData<QHash<QString, std::shared_ptr<const Results>>> m_results;
+    std::atomic_int m_hitCount = 0;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PUREBINDINGCACHE_H
@@ -0,0 +1,186 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "scriptcompilationcache.h"
+
+#include <tools/fileinfo.h>
+
+#include <quickjs.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qsysinfo.h>
+
+namespace qbs {
+namespace Internal {
+
+// A cache file consists of the magic, the key, the payload size as a 64-bit little-endian
+// number, a checksum of the payload and the payload itself.
+static QByteArray fileMagic() { return QByteArrayLiteral("QBSJSBC2"); }
+
+static QByteArray checksum(const QByteArray &data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+// Enough for the scripts of large projects, while bounding the memory in long-lived
+// processes that load many of them.
+static const qsizetype maxInMemorySize = 64 * 1024 * 1024;
+
+ScriptCompilationCache::ScriptCompilationCache() : m_byteCode(maxInMemorySize) { }
+
+ScriptCompilationCache &ScriptCompilationCache::instance()
+{
+    static ScriptCompilationCache cache;
+    return cache;
+}
+
+QByteArray ScriptCompilationCache::key(const QString &sourceCode, const QString &filePath,
+                                       int line)
+{
+    // The bytecode format is specific to the QuickJS version and build configuration as well
+    // as to the architecture, and the file path and line end up in the debug information,
+    // so all of these have to be part of the key.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QByteArrayLiteral(QBS_VERSION));
+    hash.addData(QByteArray(byteCodeFormatId()));
+    hash.addData(QSysInfo::buildAbi().toLatin1());
+    hash.addData(QByteArray::number(QT_POINTER_SIZE));
+    hash.addData(filePath.toUtf8());
+    hash.addData(QByteArray::number(line));
+    hash.addData(sourceCode.toUtf8());
+    return hash.result();
+}
+
+QString ScriptCompilationCache::diskCacheDirectory(const QString &buildDirectory)
+{
+    return buildDirectory + QStringLiteral("/jsbytecode");
+}
+
+QByteArray ScriptCompilationCache::byteCode(const QByteArray &key,
+                                            const QString &diskCacheDir) const
+{
+    {
+        const auto guard = m_byteCode.lock();
+        if (const QByteArray * const byteCode = guard.get().object(key))
+            return *byteCode;
+    }
+    if (diskCacheDir.isEmpty())
+        return {};
+    const QByteArray byteCode = readFromDisk(diskCacheDir, key);
+    if (!byteCode.isEmpty())
+        insertInMemory(key, byteCode);
+    return byteCode;
+}
+
+void ScriptCompilationCache::insert(const QByteArray &key, const QByteArray &byteCode,
+                                    const QString &diskCacheDir)
+{
+    // Callers only get here after byteCode() came up empty, so a file that might exist
+    // on disk is unusable and gets replaced.
+    insertInMemory(key, byteCode);
+    if (!diskCacheDir.isEmpty())
+        writeToDisk(diskCacheDir, key, byteCode);
+}
+
+void ScriptCompilationCache::insertInMemory(const QByteArray &key,
+                                            const QByteArray &byteCode) const
+{
+    const auto guard = m_byteCode.lock();
+    if (!guard.get().contains(key))
+        guard.get().insert(key, new QByteArray(byteCode), byteCode.size());
+}
+
+QString ScriptCompilationCache::cacheFilePath(const QString &diskCacheDir, const QByteArray &key)
+{
+    return FileInfo::resolvePath(diskCacheDir, QString::fromLatin1(key.toHex())
+                                 + QStringLiteral(".qjsbc"));
+}
+
+QByteArray ScriptCompilationCache::readFromDisk(const QString &diskCacheDir,
+                                                const QByteArray &key)
+{
+    QFile file(cacheFilePath(diskCacheDir, key));
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    // The file might be truncated or otherwise corrupt, e.g. due to a crash or a bug in some
+    // other qbs version. Nothing that is not exactly what we wrote must reach the engine.
+    const QByteArray header = fileMagic() + key;
+    if (file.read(header.size()) != header)
+        return {};
+    const QByteArray sizeData = file.read(sizeof(quint64));
+    if (sizeData.size() != int(sizeof(quint64)))
+        return {};
+    const quint64 size = qFromLittleEndian<quint64>(sizeData.constData());
+    const int checksumSize = QCryptographicHash::hashLength(QCryptographicHash::Sha1);
+    const QByteArray expectedChecksum = file.read(checksumSize);
+    if (expectedChecksum.size() != checksumSize)
+        return {};
+    if (size == 0 || quint64(file.size() - file.pos()) != size)
+        return {};
+    QByteArray byteCode = file.readAll();
+    if (quint64(byteCode.size()) != size || checksum(byteCode) != expectedChecksum)
+        return {};
+    return byteCode;
+}
+
+void ScriptCompilationCache::writeToDisk(const QString &diskCacheDir, const QByteArray &key,
+                                         const QByteArray &byteCode)
+{
+    // Several processes may write the same entry concurrently, but as QSaveFile
+    // renames atomically, readers only ever see complete files.
+    if (!QDir().mkpath(diskCacheDir))
+        return;
+    QSaveFile file(cacheFilePath(diskCacheDir, key));
+    if (!file.open(QIODevice::WriteOnly))
+        return;
+    char sizeData[sizeof(quint64)];
+    qToLittleEndian<quint64>(quint64(byteCode.size()), sizeData);
+    file.write(fileMagic() + key);
+    file.write(sizeData, sizeof sizeData);
+    file.write(checksum(byteCode));
+    file.write(byteCode);
+    file.commit();
+}
+
+} // namespace Internal
+} // namespace qbs
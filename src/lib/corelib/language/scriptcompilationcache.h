@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SCRIPTCOMPILATIONCACHE_H
+#define QBS_SCRIPTCOMPILATIONCACHE_H
+
+#include <tools/mutexdata.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qstring.h>
+
+#include <mutex>
+
+namespace qbs {
+namespace Internal {
+
+/*
+ * Process-wide store of compiled QuickJS bytecode, shared by all script engines.
+ * Entries are keyed by a hash of the source code and its location, so a changed file
+ * can never be served stale bytecode. The least recently used entries are dropped once
+ * the total size exceeds a fixed limit.
+ * Callers that pass a disk cache directory also get the entries persisted there, so that
+ * later qbs processes can re-use them. Script engines use the directory returned by
+ * diskCacheDirectory() for the build directory of their project, unless they belong to
+ * a dry run.
+ */
+class QBS_AUTOTEST_EXPORT ScriptCompilationCache
+{
+public:
+    static ScriptCompilationCache &instance();
+
+    static QByteArray key(const QString &sourceCode, const QString &filePath, int line);
+    static QString diskCacheDirectory(const QString &buildDirectory);
+
+    QByteArray byteCode(const QByteArray &key, const QString &diskCacheDir = {}) const;
+    void insert(const QByteArray &key, const QByteArray &byteCode,
+                const QString &diskCacheDir = {});
+
+private:
+    ScriptCompilationCache();
+
+    void insertInMemory(const QByteArray &key, const QByteArray &byteCode) const;
+    static QString cacheFilePath(const QString &diskCacheDir, const QByteArray &key);
+    static QByteArray readFromDisk(const QString &diskCacheDir, const QByteArray &key);
+    static void writeToDisk(const QString &diskCacheDir, const QByteArray &key,
+                            const QByteArray &byteCode);
+
+    // The cost of an entry is its size in bytes.
+    mutable MutexData<QCache<QByteArray, QByteArray>, std::mutex> m_byteCode;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SCRIPTCOMPILATIONCACHE_H
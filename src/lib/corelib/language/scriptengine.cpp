@@ -43,6 +43,7 @@
 #include "filecontextbase.h"
 #include "jsimports.h"
 #include "preparescriptobserver.h"
+#include "scriptcompilationcache.h"
 #include "scriptimporter.h"
 
 #include <buildgraph/artifact.h>
@@ -187,6 +188,8 @@ ScriptEngine::~ScriptEngine()
         JS_FreeValue(m_context, ext);
     for (const JSValue &s : std::as_const(m_stringCache))
         JS_FreeValue(m_context, s);
+    for (const JSValue &f : std::as_const(m_compiledScripts))
+        JS_FreeValue(m_context, f);
     for (JSValue * const externalRef : std::as_const(m_externallyCachedValues)) {
         JS_FreeValue(m_context, *externalRef);
         *externalRef = JS_UNDEFINED;
@@ -220,6 +223,9 @@ void ScriptEngine::reset()
     for (const auto &e : std::as_const(m_baseProductScriptValues))
         JS_FreeValue(m_context, e.second);
     m_baseProductScriptValues.clear();
+    for (const JSValue &v : std::as_const(m_productDataScriptValues))
+        JS_FreeValue(m_context, v);
+    m_productDataScriptValues.clear();
     for (const auto &e : std::as_const(m_productArtifactsMapScriptValues))
         JS_FreeValue(m_context, e.second);
     m_productArtifactsMapScriptValues.clear();
@@ -775,12 +781,14 @@ JSValue ScriptEngine::getArtifactProperty(JSValue obj,
 void ScriptEngine::addCanonicalFilePathResult(const QString &filePath,
                                               const QString &resultFilePath)
 {
+    addExternalStateQuery();
     if (gatherFileResults())
         m_canonicalFilePathResult.insert(filePath, resultFilePath);
 }
 
 void ScriptEngine::addFileExistsResult(const QString &filePath, bool exists)
 {
+    addExternalStateQuery();
     if (gatherFileResults())
         m_fileExistsResult.insert(filePath, exists);
 }
@@ -788,6 +796,7 @@ void ScriptEngine::addFileExistsResult(const QString &filePath, bool exists)
 void ScriptEngine::addDirectoryEntriesResult(const QString &path, QDir::Filters filters,
                                              const QStringList &entries)
 {
+    addExternalStateQuery();
     if (gatherFileResults()) {
         m_directoryEntriesResult.insert(
                     std::pair<QString, quint32>(path, static_cast<quint32>(filters)),
@@ -797,6 +806,7 @@ void ScriptEngine::addDirectoryEntriesResult(const QString &path, QDir::Filters
 
 void ScriptEngine::addFileLastModifiedResult(const QString &filePath, const FileTime &fileTime)
 {
+    addExternalStateQuery();
     if (gatherFileResults())
         m_fileLastModifiedResult.insert(filePath, fileTime);
 }
@@ -850,6 +860,80 @@ JSValue ScriptEngine::evaluate(
     return v;
 }
 
+JSValue ScriptEngine::evaluateCached(
+    JsValueOwner resultOwner,
+    const QByteArray &cacheKey,
+    const std::function<QString()> &codeProvider,
+    const QString &filePath,
+    int line,
+    qbs::Internal::span<const JSValue> scopeChain)
+{
+    const JSValue compiled = compiledScript(cacheKey, codeProvider, filePath, line);
+    if (JS_IsException(compiled))
+        return compiled;
+
+    m_scopeChains.emplace_back(scopeChain);
+    m_evalPositions.emplace(filePath, line);
+    const JSValue v = evalFunctionWithThis(m_context, JS_DupValue(m_context, compiled),
+                                           globalObject());
+    m_evalPositions.pop();
+    m_scopeChains.pop_back();
+    if (resultOwner == JsValueOwner::ScriptEngine && JS_VALUE_HAS_REF_COUNT(v))
+        ++m_evalResults[v];
+    return v;
+}
+
+JSValue ScriptEngine::evaluateCached(
+    JsValueOwner resultOwner,
+    const QString &code,
+    const QString &filePath,
+    int line,
+    qbs::Internal::span<const JSValue> scopeChain)
+{
+    return evaluateCached(resultOwner, ScriptCompilationCache::key(code, filePath, line),
+                          [&code] { return code; }, filePath, line, scopeChain);
+}
+
+JSValue ScriptEngine::compiledScript(const QByteArray &cacheKey,
+                                     const std::function<QString()> &codeProvider,
+                                     const QString &filePath, int line)
+{
+    const auto it = m_compiledScripts.constFind(cacheKey);
+    if (it != m_compiledScripts.constEnd())
+        return it.value();
+
+    ScriptCompilationCache &cache = ScriptCompilationCache::instance();
+    const QByteArray byteCode = cache.byteCode(cacheKey, m_byteCodeCacheDir);
+    if (!byteCode.isEmpty()) {
+        const JSValue compiled = JS_ReadObject(
+            m_context, reinterpret_cast<const uint8_t *>(byteCode.constData()), byteCode.size(),
+            JS_READ_OBJ_BYTECODE);
+        if (!JS_IsException(compiled)) {
+            m_compiledScripts.insert(cacheKey, compiled);
+            return compiled;
+        }
+        JS_FreeValue(m_context, JS_GetException(m_context)); // Fall back to compiling.
+    }
+
+    const QByteArray codeStr = codeProvider().toUtf8();
+    const JSValue compiled = JS_EvalThis(m_context, globalObject(), codeStr.constData(),
+                                         codeStr.length(), filePath.toUtf8().constData(), line,
+                                         JS_EVAL_TYPE_GLOBAL | JS_EVAL_FLAG_COMPILE_ONLY);
+    if (JS_IsException(compiled))
+        return compiled;
+    m_compiledScripts.insert(cacheKey, compiled);
+
+    size_t size = 0;
+    if (uint8_t * const buf = JS_WriteObject(m_context, &size, compiled, JS_WRITE_OBJ_BYTECODE)) {
+        cache.insert(cacheKey, QByteArray(reinterpret_cast<const char *>(buf), int(size)),
+                     m_byteCodeCacheDir);
+        js_free(m_context, buf);
+    } else {
+        JS_FreeValue(m_context, JS_GetException(m_context));
+    }
+    return compiled;
+}
+
 void ScriptEngine::handleJsProperties(JSValue obj, const PropertyHandler &handler)
 {
     qbs::Internal::handleJsProperties(m_context, obj, handler);
@@ -175,10 +175,15 @@ public:
 
     void addExternallyCachedValue(JSValue *v) { m_externallyCachedValues.push_back(v); }
 
-    void setUsesIo() { m_usesIo = true; }
+    void setUsesIo() { m_usesIo = true; addExternalStateQuery(); }
     void clearUsesIo() { m_usesIo = false; }
     bool usesIo() const { return m_usesIo; }
 
+    // Counts script queries and modifications of state that is not described by the project
+    // files, such as file system contents or environment variables.
+    void addExternalStateQuery() { ++m_externalStateQueryCount; }
+    int externalStateQueryCount() const { return m_externalStateQueryCount; }
+
     void enableProfiling(bool enable);
 
     void setPropertyCacheEnabled(bool enable) { m_propertyCacheEnabled = enable; }
@@ -220,6 +225,28 @@ public:
         const QString &filePath = QString(),
         int line = 1,
         qbs::Internal::span<const JSValue> scopeChain = {});
+
+    // Like evaluate(), but the compiled form of the code is cached in this engine and,
+    // as bytecode, in the process-wide ScriptCompilationCache. The code provider is only
+    // called if there is no cached bytecode for the key.
+    JSValue evaluateCached(
+        JsValueOwner resultOwner,
+        const QByteArray &cacheKey,
+        const std::function<QString()> &codeProvider,
+        const QString &filePath,
+        int line,
+        qbs::Internal::span<const JSValue> scopeChain = {});
+    JSValue evaluateCached(
+        JsValueOwner resultOwner,
+        const QString &code,
+        const QString &filePath,
+        int line,
+        qbs::Internal::span<const JSValue> scopeChain = {});
+
+    // Where evaluateCached() persists the bytecode. Empty means in memory only.
+    void setByteCodeCacheDirectory(const QString &dir) { m_byteCodeCacheDir = dir; }
+    const QString &byteCodeCacheDirectory() const { return m_byteCodeCacheDir; }
+
     void setLastLookupStatus(bool success) { m_lastLookupWasSuccess = success; }
     JSContext *context() const { return m_context; }
     JSValue globalObject() const { return m_globalObject; }
@@ -275,6 +302,13 @@ public:
         return m_baseProductScriptValues[product];
     }
 
+    // The internal data of the "product" object as seen by scripts of the module
+    // with the given name.
+    JSValue &productDataScriptValue(const ResolvedProduct *product, const QString &moduleName)
+    {
+        return m_productDataScriptValues[std::make_pair(product, moduleName)];
+    }
+
     JSValue &projectScriptValue(const ResolvedProject *project)
     {
         return m_projectScriptValues[project];
@@ -333,6 +367,9 @@ private:
     void import(const JsImport &jsImport, JSValue &targetObject);
     void observeImport(JSValue &jsImport);
     void importFile(const QString &filePath, JSValue targetObject);
+    JSValue compiledScript(const QByteArray &cacheKey,
+                           const std::function<QString()> &codeProvider,
+                           const QString &filePath, int line);
     static JSValue js_require(JSContext *ctx, JSValueConst this_val,
                               int argc, JSValueConst *argv, int magic, JSValue *func_data);
     JSValue mergeExtensionObjects(const JSValueList &lst);
@@ -370,6 +407,8 @@ private:
     Evaluator *m_evaluator = nullptr;
     QHash<JsImport, JSValue> m_jsImportCache;
     std::unordered_map<QString, JSValue> m_jsFileCache;
+    QHash<QByteArray, JSValue> m_compiledScripts;
+    QString m_byteCodeCacheDir;
     bool m_propertyCacheEnabled = true;
     bool m_active = false;
     std::atomic_bool m_canceling = false;
@@ -388,6 +427,7 @@ private:
     JSValue m_qbsObject = JS_UNDEFINED;
     qint64 m_elapsedTimeImporting = -1;
     bool m_usesIo = false;
+    int m_externalStateQueryCount = 0;
     EvalContext m_evalContext;
     const std::unique_ptr<PrepareScriptObserver> m_observer;
     std::vector<std::tuple<JSValue, QString, JSValue>> m_observedProperties;
@@ -399,6 +439,7 @@ private:
     Set<const ResolvedProduct *> m_requestedExports;
     ObserveMode m_observeMode = ObserveMode::Disabled;
     std::unordered_map<const ResolvedProduct *, JSValue> m_baseProductScriptValues;
+    QHash<std::pair<const ResolvedProduct *, QString>, JSValue> m_productDataScriptValues;
     std::unordered_map<const ResolvedProduct *, JSValue> m_productArtifactsMapScriptValues;
     std::unordered_map<const ResolvedModule *, JSValue> m_moduleArtifactsMapScriptValues;
     std::unordered_map<const ResolvedProject *, JSValue> m_projectScriptValues;
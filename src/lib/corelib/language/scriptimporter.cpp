@@ -40,6 +40,7 @@
 #include "scriptimporter.h"
 
 #include "evaluator.h"
+#include "scriptcompilationcache.h"
 #include "scriptengine.h"
 
 #include <parser/qmljsastfwd_p.h>
@@ -126,24 +127,33 @@ JSValue ScriptImporter::importSourceCode(const QString &sourceCode, const QStrin
     // The targetObject doesn't get overwritten but enhanced by the contents of the .js file.
     // This is necessary for library imports that consist of multiple js files.
 
-    QString &code = m_sourceCodeCache[filePath];
-    if (code.isEmpty()) {
-        QbsQmlJS::Engine engine;
-        QbsQmlJS::Lexer lexer(&engine);
-        lexer.setCode(sourceCode, 1, false);
-        QbsQmlJS::Parser parser(&engine);
-        if (!parser.parseProgram()) {
-            throw ErrorInfo(parser.errorMessage(), CodeLocation(filePath, parser.errorLineNumber(),
-                                                                parser.errorColumnNumber()));
+    // The wrapped code is only needed if there is no bytecode for the file yet,
+    // so the extra parsing step is skipped for files that were compiled before.
+    const auto wrappedCode = [&] {
+        QString &code = m_sourceCodeCache[filePath];
+        if (code.isEmpty()) {
+            QbsQmlJS::Engine engine;
+            QbsQmlJS::Lexer lexer(&engine);
+            lexer.setCode(sourceCode, 1, false);
+            QbsQmlJS::Parser parser(&engine);
+            if (!parser.parseProgram()) {
+                throw ErrorInfo(parser.errorMessage(),
+                                CodeLocation(filePath, parser.errorLineNumber(),
+                                             parser.errorColumnNumber()));
+            }
+
+            IdentifierExtractor extractor;
+            extractor.start(parser.rootNode());
+            code = QLatin1String("(function(){\n") + sourceCode + extractor.suffix();
         }
-
-        IdentifierExtractor extractor;
-        extractor.start(parser.rootNode());
-        code = QLatin1String("(function(){\n") + sourceCode + extractor.suffix();
-    }
+        return code;
+    };
 
     ScopedJsValue result(m_engine->context(),
-                         m_engine->evaluate(JsValueOwner::Caller, code, filePath, 0));
+                         m_engine->evaluateCached(
+                             JsValueOwner::Caller,
+                             ScriptCompilationCache::key(sourceCode, filePath, 0),
+                             wrappedCode, filePath, 0));
     throwOnEvaluationError(m_engine, [&filePath] () { return CodeLocation(filePath, 0); });
     copyProperties(m_engine->context(), result, targetObject);
     return result.release();
@@ -134,16 +134,18 @@ const QStringList &ItemReader::allSearchPaths() const
     return m_allSearchPaths;
 }
 
-Item *ItemReader::readFile(const QString &filePath)
+Item *ItemReader::readFile(const QString &filePath, AstRetention astRetention)
 {
     AccumulatingTimer readFileTimer(m_elapsedTime != -1 ? &m_elapsedTime : nullptr);
-    return m_visitorState->readFile(filePath, allSearchPaths(), &m_loaderState.itemPool());
+    return m_visitorState->readFile(filePath, allSearchPaths(), &m_loaderState.itemPool(),
+                                    astRetention);
 }
 
-Item *ItemReader::readFile(const QString &filePath, const CodeLocation &referencingLocation)
+Item *ItemReader::readFile(const QString &filePath, const CodeLocation &referencingLocation,
+                           AstRetention astRetention)
 {
     try {
-        return readFile(filePath);
+        return readFile(filePath, astRetention);
     } catch (const ErrorInfo &e) {
         if (e.hasLocation())
             throw;
@@ -211,9 +213,10 @@ void ItemReader::handleAllPropertyOptionsItems(Item *item)
     item->setChildren(childItems);
 }
 
-Item *ItemReader::setupItemFromFile(const QString &filePath, const CodeLocation &referencingLocation)
+Item *ItemReader::setupItemFromFile(const QString &filePath, const CodeLocation &referencingLocation,
+                                    AstRetention astRetention)
 {
-    Item *item = readFile(filePath, referencingLocation);
+    Item *item = readFile(filePath, referencingLocation, astRetention);
 
     // This is technically not needed, because files are only set up once and then served
     // from a cache. But it simplifies the checks in item.cpp if we require the locking invariant
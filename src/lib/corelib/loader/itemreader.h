@@ -40,6 +40,8 @@
 #ifndef QBS_ITEMREADER_H
 #define QBS_ITEMREADER_H
 
+#include "itemreadervisitorstate.h"
+
 #include <logging/logger.h>
 #include <tools/deprecationwarningmode.h>
 #include <tools/set.h>
@@ -54,7 +56,6 @@ namespace Internal {
 class Evaluator;
 class Item;
 class ItemPool;
-class ItemReaderVisitorState;
 class LoaderState;
 
 /*
@@ -82,7 +83,8 @@ public:
 
     // Parses a file, creates an item for it, generates PropertyDeclarations from
     // PropertyOptions items and removes said items from the item tree.
-    Item *setupItemFromFile(const QString &filePath, const CodeLocation &referencingLocation);
+    Item *setupItemFromFile(const QString &filePath, const CodeLocation &referencingLocation,
+                            AstRetention astRetention = AstRetention::Keep);
 
     Item *wrapInProjectIfNecessary(Item *item);
     QStringList readExtraSearchPaths(Item *item, bool *wasSet = nullptr);
@@ -91,8 +93,9 @@ public:
 
 private:
     void setSearchPaths(const QStringList &searchPaths);
-    Item *readFile(const QString &filePath);
-    Item *readFile(const QString &filePath, const CodeLocation &referencingLocation);
+    Item *readFile(const QString &filePath, AstRetention astRetention);
+    Item *readFile(const QString &filePath, const CodeLocation &referencingLocation,
+                   AstRetention astRetention);
     void handlePropertyOptions(Item *optionsItem);
     void handleAllPropertyOptionsItems(Item *item);
 
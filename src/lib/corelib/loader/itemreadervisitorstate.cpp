@@ -58,22 +58,45 @@
 namespace qbs {
 namespace Internal {
 
+static QString readCode(QFile &file)
+{
+    // Decode straight from a mapping of the file. Only files starting with a byte that
+    // could belong to a UTF-16 or UTF-32 byte order mark take the slower stream-based route,
+    // which detects the encoding.
+    const qint64 size = file.size();
+    uchar * const data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data || data[0] == 0x00 || data[0] == 0xfe || data[0] == 0xff) {
+        if (data)
+            file.unmap(data);
+        QTextStream stream(&file);
+        setupDefaultCodec(stream);
+        return stream.readAll();
+    }
+    const char *code = reinterpret_cast<const char *>(data);
+    qint64 codeSize = size;
+    if (codeSize >= 3 && data[0] == 0xef && data[1] == 0xbb && data[2] == 0xbf) {
+        code += 3;
+        codeSize -= 3;
+    }
+    QString result = QString::fromUtf8(code, int(codeSize));
+    file.unmap(data);
+    return result;
+}
+
 ItemReaderVisitorState::ItemReaderVisitorState(ItemReaderCache &cache, Logger &logger)
     : m_cache(cache), m_logger(logger)
 {
 }
 
 Item *ItemReaderVisitorState::readFile(const QString &filePath, const QStringList &searchPaths,
-                                  ItemPool *itemPool)
+                                       ItemPool *itemPool, AstRetention astRetention)
 {
     const auto setupCacheEntry = [&](ItemReaderCache::AstCacheEntry &entry) {
         QFile file(filePath);
         if (Q_UNLIKELY(!file.open(QFile::ReadOnly)))
             throw ErrorInfo(Tr::tr("Cannot open '%1'.").arg(filePath));
 
-        QTextStream stream(&file);
-        setupDefaultCodec(stream);
-        const QString &code = stream.readAll();
+        const QString code = readCode(file);
         QbsQmlJS::Lexer lexer(&entry.engine);
         lexer.setCode(code, 1);
         QbsQmlJS::Parser parser(&entry.engine);
@@ -93,29 +116,34 @@ Item *ItemReaderVisitorState::readFile(const QString &filePath, const QStringLis
         entry.ast = parser.ast();
     };
 
-    ItemReaderCache::AstCacheEntry &cacheEntry = m_cache.retrieveOrSetupCacheEntry(
+    const ItemReaderCache::AstCacheEntryPtr cacheEntry = m_cache.retrieveOrSetupCacheEntry(
         filePath, setupCacheEntry);
+    if (astRetention == AstRetention::Release)
+        m_cache.releaseCacheEntry(filePath);
     const FileContextPtr file = FileContext::create();
     file->setFilePath(QFileInfo(filePath).absoluteFilePath());
-    file->setContent(cacheEntry.code);
+    file->setContent(cacheEntry->code);
     file->setSearchPaths(searchPaths);
 
     ItemReaderASTVisitor astVisitor(*this, file, itemPool, m_logger);
     {
+        // A visitor state is only ever used by one thread at a time, so unlike the cache,
+        // the set of files in process needs no synchronization.
         class ProcessingFlagManager {
         public:
-            ProcessingFlagManager(ItemReaderCache::AstCacheEntry &e, const QString &filePath)
-                : m_cacheEntry(e)
+            ProcessingFlagManager(Set<QString> &filesInProcess, const QString &filePath)
+                : m_filesInProcess(filesInProcess), m_filePath(filePath)
             {
-                if (!e.addProcessingThread())
+                if (!m_filesInProcess.insert(filePath).second)
                     throw ErrorInfo(Tr::tr("Loop detected when importing '%1'.").arg(filePath));
             }
-            ~ProcessingFlagManager() { m_cacheEntry.removeProcessingThread(); }
+            ~ProcessingFlagManager() { m_filesInProcess.remove(m_filePath); }
 
         private:
-            ItemReaderCache::AstCacheEntry &m_cacheEntry;
-        } processingFlagManager(cacheEntry, filePath);
-        cacheEntry.ast->accept(&astVisitor);
+            Set<QString> &m_filesInProcess;
+            const QString &m_filePath;
+        } processingFlagManager(m_filesInProcess, filePath);
+        cacheEntry->ast->accept(&astVisitor);
     }
     astVisitor.checkItemTypes();
     return astVisitor.rootItem();
@@ -53,6 +53,10 @@ class ItemPool;
 class ItemReaderCache;
 class Logger;
 
+// Files that are known to be read only once, such as project and product files, do not need
+// to keep their AST around after the items have been created from it.
+enum class AstRetention { Keep, Release };
+
 class ItemReaderVisitorState
 {
 public:
@@ -60,7 +64,8 @@ public:
 
     Logger &logger() { return m_logger; }
 
-    Item *readFile(const QString &filePath, const QStringList &searchPaths, ItemPool *itemPool);
+    Item *readFile(const QString &filePath, const QStringList &searchPaths, ItemPool *itemPool,
+                   AstRetention astRetention = AstRetention::Keep);
 
     void findDirectoryEntries(const QString &dirPath, QStringList *entries) const;
 
@@ -75,6 +80,7 @@ private:
     ItemReaderCache &m_cache;
     Logger &m_logger;
     Item *m_mostDerivingItem = nullptr;
+    Set<QString> m_filesInProcess;
 };
 
 } // namespace Internal
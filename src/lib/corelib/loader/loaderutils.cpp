@@ -408,24 +408,28 @@ void TopLevelProjectContext::addCodeLink(const QString &sourceFile, const CodeRa
         links << target;
 }
 
-QString TopLevelProjectContext::findModuleDirectory(
-        const QualifiedId &module, const QString &searchPath,
-        const std::function<QString()> &findOnDisk)
+QString TopLevelProjectContext::findModuleDirectory(const QualifiedId &module,
+                                                   const QString &searchPath)
 {
-    const auto modulePathCacheGuard = m_modulePathCache.lock();
-    auto &path = modulePathCacheGuard.get()[{searchPath, module}];
-    if (!path)
-        path = findOnDisk();
-    return *path;
+    return m_moduleSearchIndex.findModuleDirectory(searchPath, module);
 }
 
-QStringList TopLevelProjectContext::getModuleFilesForDirectory(
-        const QString &dir, const std::function<QStringList ()> &findOnDisk)
+QStringList TopLevelProjectContext::getModuleFilesForDirectory(const QString &dir)
 {
+    {
+        const auto moduleFilesGuard = m_moduleFilesPerDirectory.lock();
+        const auto &moduleFiles = moduleFilesGuard.get();
+        if (const auto it = moduleFiles.find(dir); it != moduleFiles.end() && it->second)
+            return *it->second;
+    }
+
+    // The directory is listed without holding the lock. If another thread got here first,
+    // its list wins, as it might already have been modified.
+    QStringList files = m_moduleSearchIndex.moduleFiles(dir);
     const auto moduleFilesGuard = m_moduleFilesPerDirectory.lock();
     auto &list = moduleFilesGuard.get()[dir];
     if (!list)
-        list = findOnDisk();
+        list = std::move(files);
     return *list;
 }
 
@@ -440,6 +444,11 @@ void TopLevelProjectContext::removeModuleFileFromDirectoryCache(const QString &f
     files->removeOne(filePath);
 }
 
+void TopLevelProjectContext::invalidateModuleSearchIndex(const QString &dirPath)
+{
+    m_moduleSearchIndex.resetVerification(dirPath);
+}
+
 void TopLevelProjectContext::addUnknownProfilePropertyError(const Item *moduleProto,
                                                             const ErrorInfo &error)
 {
@@ -473,6 +482,17 @@ Item *TopLevelProjectContext::getModulePrototype(const QString &filePath, const
     return module;
 }
 
+FileTime TopLevelProjectContext::fileLastModified(const QString &filePath)
+{
+    const auto fileTimesGuard = m_fileTimes.lock();
+    const auto it = fileTimesGuard.get().find(filePath);
+    if (it != fileTimesGuard.get().end())
+        return it->second;
+    const FileTime fileTime = FileInfo(filePath).lastModified();
+    fileTimesGuard.get().emplace(filePath, fileTime);
+    return fileTime;
+}
+
 void TopLevelProjectContext::addLocalProfile(const QString &name, const QVariantMap &values,
                                              const CodeLocation &location)
 {
@@ -535,6 +555,29 @@ ProbeConstPtr TopLevelProjectContext::findOldProductProbe(const QString &product
     return {};
 }
 
+void TopLevelProjectContext::setReusableProducts(
+        const QHash<QString, ResolvedProductPtr> &products,
+        const TopLevelProjectConstPtr &earlierProject)
+{
+    m_reusableProducts = products;
+    m_earlierProject = earlierProject;
+}
+
+ResolvedProductPtr TopLevelProjectContext::reusableProduct(const QString &uniqueName) const
+{
+    return m_reusableProducts.value(uniqueName);
+}
+
+void TopLevelProjectContext::setOldProductResolveTimes(const QHash<QString, qint64> &resolveTimes)
+{
+    m_oldProductResolveTimes = resolveTimes;
+}
+
+qint64 TopLevelProjectContext::oldProductResolveTime(const QString &uniqueName) const
+{
+    return m_oldProductResolveTimes.value(uniqueName);
+}
+
 void TopLevelProjectContext::addNewlyResolvedProbe(const ProbeConstPtr &probe)
 {
     m_probesInfo.currentProbes[probe->location()] << probe;
@@ -560,6 +603,37 @@ void TopLevelProjectContext::collectDataFromEngine(const ScriptEngine &engine)
     project->fileLastModifiedResults.insert(engine.fileLastModifiedResults());
     project->environment.insert(engine.environment());
     project->buildSystemFiles.unite(engine.imports());
+
+    // Re-used products were not evaluated again, so their file system and environment queries
+    // did not reach the engine. We must not lose them, or later changes in what they queried
+    // would go unnoticed. The earlier results are still valid, because products are only
+    // re-used if none of them has changed.
+    const std::vector<ResolvedProductPtr> reusedProducts = m_reusedProducts.lock().get();
+    if (reusedProducts.empty())
+        return;
+    QBS_CHECK(m_earlierProject);
+    const auto insertMissing = [](auto &results, const auto &earlierResults) {
+        for (auto it = earlierResults.cbegin(); it != earlierResults.cend(); ++it) {
+            if (!results.contains(it.key()))
+                results.insert(it.key(), it.value());
+        }
+    };
+    insertMissing(project->canonicalFilePathResults, m_earlierProject->canonicalFilePathResults);
+    insertMissing(project->fileExistsResults, m_earlierProject->fileExistsResults);
+    insertMissing(project->directoryEntriesResults, m_earlierProject->directoryEntriesResults);
+    insertMissing(project->fileLastModifiedResults, m_earlierProject->fileLastModifiedResults);
+    const QStringList earlierVariables = m_earlierProject->environment.keys();
+    for (const QString &variable : earlierVariables) {
+        if (!project->environment.contains(variable))
+            project->environment.insert(variable, m_earlierProject->environment.value(variable));
+    }
+    for (const ResolvedProductPtr &product : reusedProducts)
+        project->buildSystemFiles.unite(product->buildSystemFiles);
+}
+
+void TopLevelProjectContext::addReusedProduct(const ResolvedProductPtr &product)
+{
+    m_reusedProducts.lock().get().push_back(product);
 }
 
 ItemPool &TopLevelProjectContext::createItemPool()
@@ -596,6 +670,7 @@ LoaderState::LoaderState(const SetupProjectParameters &parameters,
     : d(makePimpl<Private>(*this, parameters, topLevelProject, itemPool, engine, std::move(logger)))
 {
     d->itemReader.init();
+    d->evaluator.setPureBindingCache(&topLevelProject.pureBindingCache());
 }
 
 LoaderState::~LoaderState() = default;
@@ -846,36 +921,39 @@ TimingData &TimingData::operator+=(const TimingData &other)
 
 DependenciesContext::~DependenciesContext() = default;
 
-ItemReaderCache::AstCacheEntry &ItemReaderCache::retrieveOrSetupCacheEntry(
+ItemReaderCache::AstCacheEntryPtr ItemReaderCache::retrieveOrSetupCacheEntry(
     const QString &filePath, const std::function<void (AstCacheEntry &)> &setup)
 {
-    const auto astCacheGuard = m_astCache.lock();
-    AstCacheEntry &entry = astCacheGuard.get()[filePath];
-    if (!entry.ast) {
-        setup(entry);
-        m_filesRead << filePath;
+    AstCacheSlot &slot = m_astCache[filePath];
+    std::lock_guard slotLock(slot.mutex);
+    if (!slot.entry) {
+        const auto entry = std::make_shared<AstCacheEntry>();
+        setup(*entry);
+        m_filesRead.lock().get() << filePath;
+        slot.entry = entry;
     }
-    return entry;
+    return slot.entry;
 }
 
-const QStringList &ItemReaderCache::retrieveOrSetDirectoryEntries(
-    const QString &dir, const std::function<QStringList ()> &findOnDisk)
-{
-    const auto directoryEntriesGuard = m_directoryEntries.lock();
-    auto &entries = directoryEntriesGuard.get()[dir];
-    if (!entries)
-        entries = findOnDisk();
-    return *entries;
-}
-
-bool ItemReaderCache::AstCacheEntry::addProcessingThread()
+void ItemReaderCache::releaseCacheEntry(const QString &filePath)
 {
-    return m_processingThreads.lock().get().insert(std::this_thread::get_id()).second;
+    AstCacheSlot &slot = m_astCache[filePath];
+    std::lock_guard slotLock(slot.mutex);
+    slot.entry.reset();
 }
 
-void ItemReaderCache::AstCacheEntry::removeProcessingThread()
+const QStringList &ItemReaderCache::retrieveOrSetDirectoryEntries(
+    const QString &dir, const std::function<QStringList ()> &findOnDisk)
 {
-    m_processingThreads.lock().get().remove(std::this_thread::get_id());
+    DirectoryEntries &entries = m_directoryEntries[dir];
+    if (!entries.isSetUp.load(std::memory_order_acquire)) {
+        std::lock_guard setupLock(entries.setupMutex);
+        if (!entries.isSetUp.load(std::memory_order_relaxed)) {
+            entries.entries = findOnDisk();
+            entries.isSetUp.store(true, std::memory_order_release);
+        }
+    }
+    return entries.entries;
 }
 
 class DependencyParametersMerger
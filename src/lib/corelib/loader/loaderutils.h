@@ -43,15 +43,19 @@
 #include <language/forward_decls.h>
 #include <language/item.h>
 #include <language/moduleproviderinfo.h>
+#include <language/modulesearchindex.h>
 #include <language/propertydeclaration.h>
+#include <language/purebindingcache.h>
 #include <language/qualifiedid.h>
 #include <parser/qmljsengine_p.h>
 #include <tools/codelocation.h>
+#include <tools/directorylistingcache.h>
 #include <tools/filetime.h>
 #include <tools/mutexdata.h>
 #include <tools/joblimits.h>
 #include <tools/pimpl.h>
 #include <tools/set.h>
+#include <tools/shardedmap.h>
 #include <tools/version.h>
 
 #include <QHash>
@@ -64,7 +68,6 @@
 #include <mutex>
 #include <optional>
 #include <shared_mutex>
-#include <thread>
 #include <utility>
 #include <vector>
 
@@ -113,6 +116,8 @@ public:
     qint64 propertyChecking = 0;
 };
 
+// Entries are set up exactly once and are immutable afterwards, so look-ups of existing
+// entries only need a shared lock on one shard of the respective map.
 class ItemReaderCache
 {
 public:
@@ -122,24 +127,38 @@ public:
         QString code;
         QbsQmlJS::Engine engine;
         QbsQmlJS::AST::UiProgram *ast = nullptr;
+    };
+    using AstCacheEntryPtr = std::shared_ptr<const AstCacheEntry>;
 
-        bool addProcessingThread();
-        void removeProcessingThread();
+    Set<QString> filesRead() const { return m_filesRead.lock().get(); }
+    AstCacheEntryPtr retrieveOrSetupCacheEntry(const QString &filePath,
+                                               const std::function<void(AstCacheEntry &)> &setup);
 
-    private:
-        MutexData<Set<std::thread::id>, std::recursive_mutex> m_processingThreads;
-    };
+    // For files that are not going to be read again. Readers still holding the entry
+    // keep it alive; should the file get requested anyway, it is simply parsed again.
+    void releaseCacheEntry(const QString &filePath);
 
-    const Set<QString> &filesRead() const { return m_filesRead; }
-    AstCacheEntry &retrieveOrSetupCacheEntry(const QString &filePath,
-                                             const std::function<void(AstCacheEntry &)> &setup);
     const QStringList &retrieveOrSetDirectoryEntries(
         const QString &dir, const std::function<QStringList()> &findOnDisk);
 
 private:
-    Set<QString> m_filesRead;
-    MutexData<std::unordered_map<QString, std::optional<QStringList>>, std::mutex> m_directoryEntries; // TODO: Merge with module dir entries cache?
-    MutexData<std::unordered_map<QString, AstCacheEntry>, std::mutex> m_astCache;
+    struct AstCacheSlot
+    {
+        std::shared_ptr<AstCacheEntry> entry;
+        std::mutex mutex;
+    };
+
+    struct DirectoryEntries
+    {
+        QStringList entries;
+        std::mutex setupMutex;
+        std::atomic_bool isSetUp = false;
+    };
+
+    MutexData<Set<QString>, std::mutex> m_filesRead;
+    // TODO: Merge with module dir entries cache?
+    ShardedMap<QString, DirectoryEntries> m_directoryEntries;
+    ShardedMap<QString, AstCacheSlot> m_astCache;
 };
 
 class DependenciesContext
@@ -179,7 +198,9 @@ public:
     QVariantMap defaultParameters; // In Export item.
     QStringList searchPaths;
     ResolvedProductPtr product;
+    bool productReused = false; // Taken over unchanged from the previous resolve.
     TimingData timingData;
+    qint64 resolveTime = 0; // In ns, always measured, unlike timingData.
     std::unique_ptr<DependenciesContext> dependenciesContext;
 
     // This is needed because complex cyclic dependencies that involve Depends.productTypes
@@ -284,19 +305,28 @@ public:
     CodeLinks codeLinks() const { return m_codeLinks.lock().get(); }
 
     // An empty string means no matching module directory was found.
-    QString findModuleDirectory(const QualifiedId &module, const QString &searchPath,
-                                const std::function<QString()> &findOnDisk);
+    QString findModuleDirectory(const QualifiedId &module, const QString &searchPath);
 
-    QStringList getModuleFilesForDirectory(const QString &dir,
-                                           const std::function<QStringList()> &findOnDisk);
+    QStringList getModuleFilesForDirectory(const QString &dir);
     void removeModuleFileFromDirectoryCache(const QString &filePath);
 
+    void invalidateModuleSearchIndex(const QString &dirPath);
+
     void addUnknownProfilePropertyError(const Item *moduleProto, const ErrorInfo &error);
     const std::vector<ErrorInfo> &unknownProfilePropertyErrors(const Item *moduleProto) const;
 
     Item *getModulePrototype(const QString &filePath, const QString &profile,
                              const std::function<Item *()> &produce);
 
+    // Looks at the file system only once per file and resolve.
+    FileTime fileLastModified(const QString &filePath);
+
+    // Shared by the wildcard expansion of all groups in all products.
+    DirectoryListingCache &directoryListingCache() { return m_directoryListingCache; }
+
+    // Shared by the evaluators of all loader states.
+    PureBindingCache &pureBindingCache() { return m_pureBindingCache; }
+
     void addLocalProfile(const QString &name, const QVariantMap &values,
                          const CodeLocation &location);
     const QVariantMap localProfiles() { return m_localProfiles; }
@@ -321,6 +351,16 @@ public:
     int reusedOldProbesCount() const { return m_probesInfo.probesCachedOld; }
     int reusedCurrentProbesCount() const { return m_probesInfo.probesCachedCurrent; }
 
+    // Products from an earlier resolve that are known not to be affected by any change.
+    // The keys are unique product names.
+    void setReusableProducts(const QHash<QString, ResolvedProductPtr> &products,
+                             const TopLevelProjectConstPtr &earlierProject);
+    ResolvedProductPtr reusableProduct(const QString &uniqueName) const;
+    void setOldProductResolveTimes(const QHash<QString, qint64> &resolveTimes);
+    qint64 oldProductResolveTime(const QString &uniqueName) const;
+    void addReusedProduct(const ResolvedProductPtr &product);
+    int reusedProductsCount() const { return int(m_reusedProducts.lock().get().size()); }
+
     TimingData &timingData() { return m_timingData; }
     ItemReaderCache &itemReaderCache() { return m_itemReaderCache; }
 
@@ -368,9 +408,7 @@ private:
     MutexData<std::unordered_map<const Item *,
                                    std::vector<ErrorInfo>>> m_unknownProfilePropertyErrors;
 
-    // The keys are search path + module name, the values are directories.
-    MutexData<QHash<std::pair<QString, QualifiedId>, std::optional<QString>>,
-                std::mutex> m_modulePathCache;
+    ModuleSearchIndex m_moduleSearchIndex;
 
     // The keys are file paths, the values are module prototype items accompanied by a profile.
     MutexData<std::unordered_map<QString, std::vector<std::pair<Item *, QString>>>,
@@ -378,6 +416,9 @@ private:
 
     MutexData<std::map<QString, std::optional<QStringList>>,
                 std::mutex> m_moduleFilesPerDirectory;
+    MutexData<std::unordered_map<QString, FileTime>, std::mutex> m_fileTimes;
+    DirectoryListingCache m_directoryListingCache;
+    PureBindingCache m_pureBindingCache;
     MutexData<CodeLinks> m_codeLinks;
 
     struct {
@@ -395,6 +436,11 @@ private:
 
     std::vector<std::unique_ptr<ItemPool>> m_itemPools;
 
+    QHash<QString, ResolvedProductPtr> m_reusableProducts;
+    QHash<QString, qint64> m_oldProductResolveTimes;
+    TopLevelProjectConstPtr m_earlierProject;
+    mutable MutexData<std::vector<ResolvedProductPtr>, std::mutex> m_reusedProducts;
+
     FileTime m_lastResolveTime;
 
     std::atomic_bool m_canceled = false;
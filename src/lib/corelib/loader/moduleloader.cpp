@@ -51,13 +51,11 @@
 #include <logging/translator.h>
 #include <tools/codelocation.h>
 #include <tools/error.h>
-#include <tools/fileinfo.h>
 #include <tools/hostosinfo.h>
 #include <tools/profiling.h>
 #include <tools/setupprojectparameters.h>
 #include <tools/stringconstants.h>
 
-#include <QDirIterator>
 #include <QHash>
 
 #include <unordered_map>
@@ -87,9 +85,7 @@ private:
     Item *createAndInitModuleItem(const QString &moduleName, const QString &filePath);
     bool evaluateModuleCondition(Item *module, const QString &fullModuleName);
     void checkForUnknownProfileProperties(const Item *module);
-    QString findModuleDirectory(const QString &searchPath);
     QStringList findModuleDirectories();
-    QStringList getModuleFilePaths(const QString &dir);
 
     LoaderState &m_loaderState;
     ProductContext &m_product;
@@ -166,6 +162,9 @@ Item *ModuleLoader::load()
         if (result.searchPaths) {
             qCDebug(lcModuleLoader) << "Re-checking for module" << m_moduleName.toString()
                                     << "with newly added search paths from module provider";
+            // The provider might just have generated these, so don't trust the index.
+            for (const QString &searchPath : std::as_const(*result.searchPaths))
+                m_loaderState.topLevelProject().invalidateModuleSearchIndex(searchPath);
             m_loaderState.itemReader().pushExtraSearchPaths(*result.searchPaths);
             existingPaths = findModuleDirectories();
         }
@@ -176,7 +175,8 @@ Item *ModuleLoader::load()
     std::vector<PrioritizedItem> candidates;
     candidates.reserve(size_t(existingPaths.size()));
     for (int i = 0; i < existingPaths.size(); ++i) {
-        const QStringList &moduleFileNames = getModuleFilePaths(existingPaths.at(i));
+        const QStringList &moduleFileNames
+            = m_loaderState.topLevelProject().getModuleFilesForDirectory(existingPaths.at(i));
         for (const QString &filePath : moduleFileNames) {
             const auto [module, triedToLoad] = loadModuleFile(fullName, filePath);
             if (module)
@@ -367,44 +367,18 @@ void ModuleLoader::checkForUnknownProfileProperties(const Item *module)
     handlePropertyError(error, m_loaderState.parameters(), m_loaderState.logger());
 }
 
-QString ModuleLoader::findModuleDirectory(const QString &searchPath)
-{
-    // isFileCaseCorrect is a very expensive call on macOS, so we cache the value for the
-    // modules and search paths we've already processed
-    return m_loaderState.topLevelProject().findModuleDirectory(m_moduleName, searchPath,
-                                                             [&] {
-        QString dirPath = searchPath + QStringLiteral("/modules");
-        for (const QString &moduleNamePart : m_moduleName) {
-            dirPath = FileInfo::resolvePath(dirPath, moduleNamePart);
-            if (!FileInfo::exists(dirPath) || !FileInfo::isFileCaseCorrect(dirPath))
-                return QString();
-        }
-        return dirPath;
-    });
-}
-
 QStringList ModuleLoader::findModuleDirectories()
 {
     const QStringList &searchPaths = m_loaderState.itemReader().allSearchPaths();
     QStringList result;
     result.reserve(searchPaths.size());
     for (const auto &path: searchPaths) {
-        const QString dirPath = findModuleDirectory(path);
+        const QString dirPath
+            = m_loaderState.topLevelProject().findModuleDirectory(m_moduleName, path);
         if (!dirPath.isEmpty())
             result.append(dirPath);
     }
     return result;
 }
 
-QStringList ModuleLoader::getModuleFilePaths(const QString &dir)
-{
-    return m_loaderState.topLevelProject().getModuleFilesForDirectory(dir, [&] {
-        QStringList moduleFiles;
-        QDirIterator dirIter(dir, StringConstants::qbsFileWildcards());
-        while (dirIter.hasNext())
-            moduleFiles += dirIter.next();
-        return moduleFiles;
-    });
-}
-
 } // namespace qbs::Internal
@@ -0,0 +1,458 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "modulesnapshotcache.h"
+
+#include "loaderutils.h"
+
+#include <language/evaluator.h>
+#include <language/filecontext.h>
+#include <language/scriptengine.h>
+#include <language/value.h>
+#include <logging/logger.h>
+#include <tools/scripttools.h>
+#include <tools/set.h>
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdatastream.h>
+
+#include <optional>
+#include <utility>
+
+namespace qbs {
+namespace Internal {
+
+// The number of snapshots kept for one key, i.e. for different results of the external look-ups.
+static const int maxSnapshotsPerKey = 16;
+
+// The number of keys, i.e. roughly the number of distinct module configurations, that we keep
+// around in a long-running session.
+static const int maxKeyCount = 4096;
+
+class ModuleSnapshot
+{
+public:
+    struct PropertyRead
+    {
+        enum class Kind { NotFound, ItemReference, PlainValue };
+
+        QStringList itemPath;
+        QString name;
+        Kind kind = Kind::NotFound;
+        QVariant value;
+    };
+
+    QVariantMap values;
+    std::vector<PropertyRead> reads;
+    std::optional<QString> pathBaseDir;
+    std::vector<std::pair<QualifiedId, QualifiedId>> propertyDependencies;
+};
+
+// Mirrors the look-up done by the evaluator's property getter.
+static ValuePtr lookUpValue(const Item *item, const QString &name)
+{
+    const auto lookUp = [&name](const Item *item) -> ValuePtr {
+        const bool isModuleInstance = item->type() == ItemType::ModuleInstance
+                || item->type() == ItemType::ModuleInstancePlaceholder;
+        for (; item; item = item->prototype()) {
+            if (isModuleInstance
+                && (item->type() == ItemType::Module || item->type() == ItemType::Export)) {
+                break;
+            }
+            if (const ValuePtr value = item->ownProperty(name))
+                return value;
+        }
+        return {};
+    };
+    if (const ValuePtr value = lookUp(item))
+        return value;
+    return item->parent() ? lookUp(item->parent()) : ValuePtr();
+}
+
+static QString scopeStep() { return QStringLiteral("<scope>"); }
+static QString idScopeStep() { return QStringLiteral("<idscope>"); }
+
+// Items that are not referred to via item values, but are part of the scope chain
+// when evaluating a binding, are reachable via special path steps.
+static void addItemPath(QHash<const Item *, QStringList> &itemPaths, const QStringList &path,
+                        const Item *item)
+{
+    if (!item || itemPaths.contains(item))
+        return;
+    itemPaths.insert(item, path);
+    addItemPath(itemPaths, path + QStringList(scopeStep()), item->scope());
+    if (item->file())
+        addItemPath(itemPaths, path + QStringList(idScopeStep()), item->file()->idScope());
+}
+
+static QVariant toVariant(JSContext *ctx, const JSValue &value)
+{
+    if (JS_IsFunction(ctx, value))
+        return getJsString(ctx, value);
+    return getJsVariant(ctx, value);
+}
+
+class ModuleSnapshotRecorder : public PropertyReadObserver
+{
+public:
+    ModuleSnapshotRecorder(JSContext *ctx, const Item *moduleItem,
+                           QHash<const Item *, QStringList> &itemPaths)
+        : m_ctx(ctx), m_moduleItem(moduleItem), m_itemPaths(itemPaths) {}
+
+    bool isValid() const { return m_valid && m_externalReadStack.empty(); }
+    ModuleSnapshot &snapshot() { return m_snapshot; }
+
+private:
+    // The module's own values must really be evaluated, or we would miss their look-ups.
+    bool allowsCachedValue(const Item *item) const override { return item != m_moduleItem; }
+
+    void onPropertyReadStarted(const Item *item) override
+    {
+        const bool isExternal = item != m_moduleItem;
+        m_externalReadStack.push_back(isExternal);
+        if (isExternal)
+            ++m_externalReadDepth;
+    }
+
+    void onPropertyReadFinished(const Item *item, const QString &name, bool found, bool failed,
+                                JSValue value) override
+    {
+        if (m_externalReadStack.empty()) {
+            m_valid = false;
+            return;
+        }
+        const bool isExternal = m_externalReadStack.back();
+        m_externalReadStack.pop_back();
+        if (!isExternal || --m_externalReadDepth > 0 || !m_valid)
+            return;
+        if (failed) {
+            m_valid = false;
+            return;
+        }
+        if (!m_seenReads.insert(std::make_pair(item, name)).second)
+            return;
+        const auto path = m_itemPaths.constFind(item);
+        if (path == m_itemPaths.constEnd()) {
+            m_valid = false;
+            return;
+        }
+
+        ModuleSnapshot::PropertyRead read;
+        read.itemPath = path.value();
+        read.name = name;
+        if (found) {
+            const ValuePtr v = lookUpValue(item, name);
+            if (v && v->type() == Value::ItemValueType) {
+                read.kind = ModuleSnapshot::PropertyRead::Kind::ItemReference;
+                addItemPath(m_itemPaths, read.itemPath + QStringList(name),
+                            std::static_pointer_cast<ItemValue>(v)->item());
+            } else {
+                read.kind = ModuleSnapshot::PropertyRead::Kind::PlainValue;
+                read.value = toVariant(m_ctx, value);
+            }
+        }
+        m_snapshot.reads.push_back(std::move(read));
+    }
+
+    void onPathBaseDirUsed(const QString &baseDir) override
+    {
+        if (m_externalReadDepth > 0)
+            return;
+        if (m_snapshot.pathBaseDir && *m_snapshot.pathBaseDir != baseDir)
+            m_valid = false;
+        m_snapshot.pathBaseDir = baseDir;
+    }
+
+    void onPropertyDependency(const QualifiedId &property,
+                              const QualifiedId &dependentProperty) override
+    {
+        m_snapshot.propertyDependencies.emplace_back(property, dependentProperty);
+    }
+
+    JSContext * const m_ctx;
+    const Item * const m_moduleItem;
+    QHash<const Item *, QStringList> &m_itemPaths;
+    ModuleSnapshot m_snapshot;
+    std::vector<bool> m_externalReadStack;
+    int m_externalReadDepth = 0;
+    Set<std::pair<const Item *, QString>> m_seenReads;
+    bool m_valid = true;
+};
+
+ModuleSnapshotCache &ModuleSnapshotCache::instance()
+{
+    static ModuleSnapshotCache cache;
+    return cache;
+}
+
+std::vector<std::shared_ptr<const ModuleSnapshot>> ModuleSnapshotCache::snapshots(
+    const QByteArray &key) const
+{
+    return m_snapshots.lock().get().byKey.value(key);
+}
+
+void ModuleSnapshotCache::insert(const QByteArray &key,
+                                 const std::shared_ptr<const ModuleSnapshot> &snapshot)
+{
+    const auto guard = m_snapshots.lock();
+    Snapshots &snapshots = guard.get();
+    if (!snapshots.byKey.contains(key)) {
+        if (int(snapshots.keysInInsertionOrder.size()) >= maxKeyCount) {
+            snapshots.byKey.remove(snapshots.keysInInsertionOrder.front());
+            snapshots.keysInInsertionOrder.pop_front();
+        }
+        snapshots.keysInInsertionOrder.push_back(key);
+    }
+    auto &snapshotsForKey = snapshots.byKey[key];
+    if (int(snapshotsForKey.size()) >= maxSnapshotsPerKey)
+        snapshotsForKey.erase(snapshotsForKey.begin());
+    snapshotsForKey.push_back(snapshot);
+}
+
+void ModuleSnapshotCache::clear()
+{
+    m_snapshots.lock().get() = {};
+    m_hitCount = 0;
+}
+
+ProductModuleSnapshots::ProductModuleSnapshots(ProductContext &product, LoaderState &loaderState)
+    : m_product(product), m_loaderState(loaderState)
+{
+    // The items that bindings in modules can refer to. Everything else
+    // needs to be reachable from them.
+    const auto addRootItem = [this](const QString &path, const Item *item) {
+        if (!item || m_itemPaths.contains(item))
+            return;
+        m_rootItems.insert(path, item);
+        addItemPath(m_itemPaths, QStringList(path), item);
+    };
+    addRootItem(QStringLiteral("product"), product.item);
+    addRootItem(QStringLiteral("project"), product.project ? product.project->item : nullptr);
+    for (const Item::Module &module : product.item->modules()) {
+        const QString name = module.name.toString();
+        addRootItem(QStringLiteral("module:") + name, module.item);
+        const QList<Item *> &children = module.item->children();
+        for (int i = 0; i < children.size(); ++i)
+            addRootItem(QStringLiteral("child:%1:%2").arg(name).arg(i), children.at(i));
+    }
+}
+
+ProductModuleSnapshots::~ProductModuleSnapshots() = default;
+
+QVariantMap ProductModuleSnapshots::moduleValues(const Item::Module &module,
+                                                 const std::function<QVariantMap()> &evaluate)
+{
+    // Product modules come from Export items, whose values are specific to the exporting
+    // product, so only "real" modules are considered.
+    if (module.product || !module.item->prototype()
+            || module.item->prototype()->type() != ItemType::Module) {
+        return evaluate();
+    }
+
+    Evaluator &evaluator = m_loaderState.evaluator();
+    const QByteArray key = snapshotKey(module);
+    ModuleSnapshotCache &cache = ModuleSnapshotCache::instance();
+    for (const auto &snapshot : cache.snapshots(key)) {
+        if (!matches(*snapshot))
+            continue;
+        for (const auto &dependency : snapshot->propertyDependencies)
+            evaluator.propertyDependencies()[dependency.first].insert(dependency.second);
+        cache.addHit();
+        return snapshot->values;
+    }
+
+    if (evaluator.propertyReadObserver())
+        return evaluate();
+    ScriptEngine * const engine = evaluator.engine();
+    ModuleSnapshotRecorder recorder(engine->context(), module.item, m_itemPaths);
+    const int externalStateQueryCount = engine->externalStateQueryCount();
+    const int warningCount = m_loaderState.logger().warnings().size();
+    evaluator.setPropertyReadObserver(&recorder);
+    QVariantMap values;
+    try {
+        values = evaluate();
+    } catch (...) {
+        evaluator.setPropertyReadObserver(nullptr);
+        throw;
+    }
+    evaluator.setPropertyReadObserver(nullptr);
+
+    // Warnings would get lost when re-using the values, so we do not cache in that case.
+    if (recorder.isValid() && engine->externalStateQueryCount() == externalStateQueryCount
+            && m_loaderState.logger().warnings().size() == warningCount) {
+        recorder.snapshot().values = values;
+        cache.insert(key, std::make_shared<ModuleSnapshot>(std::move(recorder.snapshot())));
+    }
+    return values;
+}
+
+QByteArray ProductModuleSnapshots::snapshotKey(const Item::Module &module) const
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    Set<const FileContextBase *> seenFiles;
+    const std::function<void(const ValuePtr &)> addValue = [&](const ValuePtr &value) {
+        if (!value) {
+            stream << -1;
+            return;
+        }
+        stream << int(value->type()) << value->sourceUsesBase() << value->sourceUsesOuter()
+               << value->sourceUsesOriginal() << value->isFallback() << value->setByProfile()
+               << value->setByCommandLine() << value->createdByPropertiesBlock();
+        switch (value->type()) {
+        case Value::JSSourceValueType: {
+            const auto sourceValue = std::static_pointer_cast<JSSourceValue>(value);
+            const FileContextConstPtr &file = sourceValue->file();
+            stream << (file ? file->filePath() : QString()) << sourceValue->line()
+                   << sourceValue->column() << sourceValue->sourceCode().toString();
+
+            // JavaScript files imported by module files can change between two resolves.
+            if (file && seenFiles.insert(file.get()).second) {
+                for (const JsImport &jsImport : file->jsImports()) {
+                    for (const QString &filePath : jsImport.filePaths) {
+                        stream << filePath << m_loaderState.topLevelProject()
+                                                  .fileLastModified(filePath).toString();
+                    }
+                }
+            }
+            addValue(sourceValue->baseValue());
+            for (const JSSourceValue::Alternative &alternative : sourceValue->alternatives()) {
+                stream << alternative.condition.value
+                       << alternative.overrideListProperties.value;
+                addValue(alternative.value);
+            }
+            break;
+        }
+        case Value::ItemValueType:
+            stream << int(std::static_pointer_cast<ItemValue>(value)->item()->type());
+            break;
+        case Value::VariantValueType:
+            stream << std::static_pointer_cast<VariantValue>(value)->value();
+            break;
+        }
+        stream << int(value->candidates().size());
+        for (const ValuePtr &candidate : value->candidates())
+            addValue(candidate);
+    };
+
+    stream << module.name.toString() << module.item->prototype()->location().filePath()
+           << m_product.profileName;
+
+    // The declarations, including their types and allowed values, determine how the values
+    // get converted. The default values live in the module files, which can change between
+    // two resolves, as can the files of modules that the module inherits from.
+    for (const Item *item = module.item; item; item = item->prototype()) {
+        if (item != module.item) {
+            const QString filePath = item->location().filePath();
+            stream << filePath
+                   << m_loaderState.topLevelProject().fileLastModified(filePath).toString();
+        }
+        const Item::PropertyDeclarationMap &declarations = item->propertyDeclarations();
+        stream << int(declarations.size());
+        for (const PropertyDeclaration &declaration : declarations) {
+            stream << declaration.name() << int(declaration.type()) << int(declaration.flags())
+                   << declaration.allowedValues() << declaration.initialValueSource()
+                   << declaration.functionArgumentNames();
+        }
+    }
+    for (auto it = module.item->properties().cbegin(); it != module.item->properties().cend();
+         ++it) {
+        stream << it.key();
+        addValue(it.value());
+    }
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+}
+
+const Item *ProductModuleSnapshots::resolveItemPath(const QStringList &path) const
+{
+    const Item *item = m_rootItems.value(path.first());
+    for (int i = 1; item && i < path.size(); ++i) {
+        if (path.at(i) == scopeStep()) {
+            item = item->scope();
+            continue;
+        }
+        if (path.at(i) == idScopeStep()) {
+            item = item->file() ? item->file()->idScope() : nullptr;
+            continue;
+        }
+        const ValuePtr value = lookUpValue(item, path.at(i));
+        if (!value || value->type() != Value::ItemValueType)
+            return nullptr;
+        item = std::static_pointer_cast<ItemValue>(value)->item();
+    }
+    return item;
+}
+
+bool ProductModuleSnapshots::matches(const ModuleSnapshot &snapshot) const
+{
+    Evaluator &evaluator = m_loaderState.evaluator();
+    if (snapshot.pathBaseDir && *snapshot.pathBaseDir != evaluator.pathPropertiesBaseDir())
+        return false;
+    JSContext * const ctx = evaluator.engine()->context();
+    for (const ModuleSnapshot::PropertyRead &read : snapshot.reads) {
+        const Item * const item = resolveItemPath(read.itemPath);
+        if (!item)
+            return false;
+        const ValuePtr value = lookUpValue(item, read.name);
+        switch (read.kind) {
+        case ModuleSnapshot::PropertyRead::Kind::NotFound:
+            if (value)
+                return false;
+            break;
+        case ModuleSnapshot::PropertyRead::Kind::ItemReference:
+            if (!value || value->type() != Value::ItemValueType)
+                return false;
+            break;
+        case ModuleSnapshot::PropertyRead::Kind::PlainValue: {
+            if (!value || value->type() == Value::ItemValueType)
+                return false;
+            const ScopedJsValue v(ctx, evaluator.property(item, read.name));
+            if (evaluator.engine()->checkAndClearException({}))
+                return false;
+            if (toVariant(ctx, v) != read.value)
+                return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,125 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_MODULESNAPSHOTCACHE_H
+#define QBS_MODULESNAPSHOTCACHE_H
+
+#include <language/item.h>
+#include <tools/mutexdata.h>
+#include <tools/qbs_export.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qvariant.h>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+class LoaderState;
+class ModuleSnapshot;
+class ProductContext;
+
+/*
+ * Process-wide store of the evaluated property values of module instances, shared by
+ * all products and all resolves.
+ * Entries are keyed on the module, the profile and all values attached to the module instance,
+ * that is, the module's own bindings as well as everything set by products, profiles and
+ * the command line. The property declarations and the time stamps of the module files
+ * are part of the key as well. As bindings can also refer to other items (the product, the project or
+ * other modules), each entry additionally carries the results of all such look-ups done
+ * during the original evaluation. An entry is only re-used if these look-ups yield the
+ * same results in the new context. Evaluations that query the environment or the file system
+ * are never cached. The number of keys is bounded; the oldest ones get evicted first.
+ */
+class QBS_AUTOTEST_EXPORT ModuleSnapshotCache
+{
+public:
+    static ModuleSnapshotCache &instance();
+
+    std::vector<std::shared_ptr<const ModuleSnapshot>> snapshots(const QByteArray &key) const;
+    void insert(const QByteArray &key, const std::shared_ptr<const ModuleSnapshot> &snapshot);
+    void clear();
+
+    int hitCount() const { return m_hitCount; }
+    void addHit() { ++m_hitCount; }
+
+private:
+    ModuleSnapshotCache() = default;
+
+    struct Snapshots
+    {
+        QHash<QByteArray, std::vector<std::shared_ptr<const ModuleSnapshot>>> byKey;
+        std::deque<QByteArray> keysInInsertionOrder;
+    };
+    mutable MutexData<Snapshots, std::mutex> m_snapshots;
+    std::atomic_int m_hitCount = 0;
+};
+
+// Evaluates the module values of one product, with the help of the snapshot cache.
+class ProductModuleSnapshots
+{
+public:
+    ProductModuleSnapshots(ProductContext &product, LoaderState &loaderState);
+    ~ProductModuleSnapshots();
+
+    QVariantMap moduleValues(const Item::Module &module,
+                             const std::function<QVariantMap()> &evaluate);
+
+private:
+    QByteArray snapshotKey(const Item::Module &module) const;
+    const Item *resolveItemPath(const QStringList &path) const;
+    bool matches(const ModuleSnapshot &snapshot) const;
+
+    ProductContext &m_product;
+    LoaderState &m_loaderState;
+    QHash<QString, const Item *> m_rootItems;
+    QHash<const Item *, QStringList> m_itemPaths;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_MODULESNAPSHOTCACHE_H
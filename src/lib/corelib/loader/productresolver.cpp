@@ -43,6 +43,7 @@
 #include "groupshandler.h"
 #include "loaderutils.h"
 #include "modulepropertymerger.h"
+#include "modulesnapshotcache.h"
 #include "probesresolver.h"
 
 #include <jsextensions/jsextensions.h>
@@ -65,6 +66,7 @@
 #include <tools/stringconstants.h>
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace qbs::Internal {
 
@@ -123,6 +125,7 @@ public:
     void start();
 
 private:
+    bool reuseProductFromEarlierResolve();
     void resolveProductFully();
     void createProductConfig();
     void resolveGroup(Item *item, ModuleContext *moduleContext);
@@ -146,6 +149,7 @@ private:
     void applyFileTaggers();
     void finalizeArtifactProperties();
     void collectProductDependencies();
+    void collectBuildSystemFiles();
 
     ProductContext &m_product;
     LoaderState &m_loaderState;
@@ -530,6 +534,9 @@ void ProductResolverStage1::collectCodeLinks()
 
 void ProductResolverStage2::start()
 {
+    if (reuseProductFromEarlierResolve())
+        return;
+
     m_loaderState.evaluator().clearPropertyDependencies();
 
     ResolvedProductPtr product = ResolvedProduct::create();
@@ -582,6 +589,41 @@ void ProductResolverStage2::start()
     }
 }
 
+// The caller has verified that none of the files the product was set up from have changed.
+// As the product's dependencies and probes were resolved anew in stage 1, we can
+// double-check here that they are the same ones as before.
+bool ProductResolverStage2::reuseProductFromEarlierResolve()
+{
+    if (m_product.delayedError.hasError())
+        return false;
+    const ResolvedProductPtr product
+            = m_loaderState.topLevelProject().reusableProduct(m_product.uniqueName());
+    if (!product)
+        return false;
+    if (m_product.probes != product->probes)
+        return false;
+    std::vector<ResolvedProductPtr> dependencies;
+    for (const Item::Module &module : m_product.item->modules()) {
+        if (module.product)
+            dependencies.push_back(module.product->product);
+    }
+    if (dependencies.size() != product->dependencies.size())
+        return false;
+    for (const ResolvedProductPtr &dep : dependencies) {
+        if (!contains(product->dependencies, dep))
+            return false;
+    }
+
+    qCDebug(lcProjectResolver) << "re-using product" << product->uniqueName()
+                               << "from earlier resolve";
+    product->project = m_product.project->project;
+    m_product.product = product;
+    m_product.buildDirectory = product->buildDirectory();
+    m_product.productReused = true;
+    m_loaderState.topLevelProject().addReusedProduct(product);
+    return true;
+}
+
 void ProductResolverStage2::resolveProductFully()
 {
     Item * const item = m_product.item;
@@ -678,6 +720,7 @@ void ProductResolverStage2::resolveProductFully()
     }
 
     collectProductDependencies();
+    collectBuildSystemFiles();
 }
 
 void ProductResolverStage2::createProductConfig()
@@ -818,7 +861,7 @@ void ProductResolverStage2::resolveGroupFully(
         wildcards->prefix = group->prefix;
         wildcards->baseDir = FileInfo::path(item->file()->filePath());
         wildcards->buildDir = m_product.project->project->topLevelProject()->buildDirectory;
-        wildcards->expandPatterns();
+        wildcards->expandPatterns(&m_loaderState.topLevelProject().directoryListingCache());
         for (const QString &fileName : wildcards->expandedFiles)
             createSourceArtifact(fileName, group, true, filesLocation, &fileError);
     }
@@ -1119,12 +1162,14 @@ void ProductResolverStage2::setupExportedProperties(const Item *item, const QStr
 QVariantMap ProductResolverStage2::evaluateModuleValues(Item *item, bool lookupPrototype)
 {
     QVariantMap moduleValues;
+    ProductModuleSnapshots snapshots(m_product, m_loaderState);
     for (const Item::Module &module : item->modules()) {
         if (!module.item->isPresentModule())
             continue;
         const QString fullName = module.name.toString();
-        moduleValues[fullName] = m_propertiesEvaluator.evaluateProperties(
-            module.item, lookupPrototype, true);
+        moduleValues[fullName] = snapshots.moduleValues(module, [&] {
+            return m_propertiesEvaluator.evaluateProperties(module.item, lookupPrototype, true);
+        });
     }
     return moduleValues;
 }
@@ -1275,8 +1320,41 @@ void ProductResolverStage2::collectProductDependencies()
     });
 }
 
+static void collectBuildSystemFiles(const Item *item, std::unordered_set<const Item *> &seenItems,
+                                    Set<QString> &files)
+{
+    if (!item || !seenItems.insert(item).second)
+        return;
+    if (const FileContextPtr &file = item->file()) {
+        files.insert(file->filePath());
+        for (const JsImport &jsImport : file->jsImports()) {
+            for (const QString &filePath : jsImport.filePaths)
+                files.insert(filePath);
+        }
+    }
+    collectBuildSystemFiles(item->prototype(), seenItems, files);
+    collectBuildSystemFiles(item->scope(), seenItems, files);
+    for (const Item * const child : item->children())
+        collectBuildSystemFiles(child, seenItems, files);
+    for (const Item::Module &module : item->modules())
+        collectBuildSystemFiles(module.item, seenItems, files);
+}
+
+// Used for finding out which products need to be re-resolved when project files change.
+void ProductResolverStage2::collectBuildSystemFiles()
+{
+    std::unordered_set<const Item *> seenItems;
+    Set<QString> files;
+    Internal::collectBuildSystemFiles(m_product.item, seenItems, files);
+    for (const ProjectContext *p = m_product.project; p; p = p->parent)
+        Internal::collectBuildSystemFiles(p->item, seenItems, files);
+    m_product.product->buildSystemFiles = files;
+}
+
 void ExportsResolver::start()
 {
+    if (m_product.productReused)
+        return;
     resolveShadowProduct();
     collectExportedProductDependencies();
 }
@@ -422,7 +422,8 @@ void ProductsCollector::Private::handleSubProject(
         if (referencedFilePaths.contains(subProjectFilePath))
             throw ErrorInfo(Tr::tr("Cycle detected while loading subproject file '%1'.")
                                 .arg(relativeFilePath), projectItem->location());
-        loadedItem = itemReader.setupItemFromFile(subProjectFilePath, projectItem->location());
+        loadedItem = itemReader.setupItemFromFile(subProjectFilePath, projectItem->location(),
+                                                  AstRetention::Release);
     } catch (const ErrorInfo &error) {
         if (parameters.productErrorMode() == ErrorHandlingMode::Strict)
             throw;
@@ -512,7 +513,7 @@ QList<Item *> ProductsCollector::Private::loadReferencedFile(
         throw ErrorInfo(Tr::tr("Cycle detected while referencing file '%1'.").arg(relativePath),
                         referencingLocation);
     Item * const subItem = loaderState.itemReader().setupItemFromFile(
-                absReferencePath, referencingLocation);
+                absReferencePath, referencingLocation, AstRetention::Release);
     if (subItem->type() != ItemType::Project && subItem->type() != ItemType::Product) {
         ErrorInfo error(Tr::tr("Item type should be 'Product' or 'Project', but is '%1'.")
                             .arg(subItem->typeName()));
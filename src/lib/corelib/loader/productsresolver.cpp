@@ -44,19 +44,25 @@
 #include "productresolver.h"
 
 #include <language/evaluator.h>
+#include <language/item.h>
 #include <language/language.h>
 #include <language/scriptengine.h>
+#include <language/value.h>
 #include <logging/categories.h>
 #include <logging/translator.h>
+#include <tools/buildoptions.h>
 #include <tools/profiling.h>
 #include <tools/progressobserver.h>
+#include <tools/set.h>
 #include <tools/setupprojectparameters.h>
 #include <tools/stringconstants.h>
+#include <tools/threadpool.h>
 
 #include <algorithm>
 #include <condition_variable>
 #include <future>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <system_error>
 #include <thread>
@@ -77,10 +83,36 @@ struct ThreadInfo {
 struct ProductWithLoaderState {
     ProductWithLoaderState(ProductContext &product, LoaderState *loaderState)
         : product(&product), loaderState(loaderState) {}
-    ProductContext * const product;
+    ProductContext *product;
     LoaderState *loaderState;
 };
 
+struct QueuedProduct {
+    ProductWithLoaderState product;
+    int toHandleCountOnInsert;
+    double priority;
+    quint64 sequenceNumber;
+};
+
+// Higher priorities first, FIFO among equal priorities.
+struct QueuedProductOrder {
+    bool operator()(const QueuedProduct &p1, const QueuedProduct &p2) const
+    {
+        if (p1.priority != p2.priority)
+            return p1.priority < p2.priority;
+        return p1.sequenceNumber > p2.sequenceNumber;
+    }
+};
+
+// The dependencies between products that can be seen without evaluating anything,
+// that is, Depends items whose name is a string literal referring to a product.
+struct SchedulingInfo {
+    std::vector<ProductContext *> dependents;
+    int pendingDependencyCount = 0;
+    double priority = 0;
+    bool blocked = false;
+};
+
 class ThreadsLocker {
 public:
     ThreadsLocker(std::launch mode, std::mutex &mutex) {
@@ -100,6 +132,7 @@ public:
 private:
     void initialize();
     void initializeProductQueue();
+    void initializeSchedulingGraph(const std::vector<ProductContext *> &products);
     void initializeLoaderStatePool();
     void runScheduler();
     void scheduleNext();
@@ -113,14 +146,22 @@ private:
     void waitForSingleDependency(const ProductWithLoaderState &product, ProductContext &dependency);
     void waitForBulkDependency(const ProductWithLoaderState &product);
     void unblockProductsWaitingForDependency(ProductContext &finishedProduct);
+    void unblockStaticDependents(const ProductContext &finishedProduct);
+    void releaseBlockedProducts();
     void postProcess();
     void checkForMissedBulkDependencies(const ProductContext &product);
 
     static int dependsItemCount(const Item *item);
     static int dependsItemCount(ProductContext &product);
+    static std::optional<QString> literalDependencyName(const Item *dependsItem);
 
     LoaderState &m_loaderState;
-    std::queue<std::pair<ProductWithLoaderState, int>> m_productsToSchedule;
+    std::priority_queue<QueuedProduct, std::vector<QueuedProduct>, QueuedProductOrder>
+        m_productsToSchedule;
+    quint64 m_queueSequenceNumber = 0;
+    std::unordered_map<const ProductContext *, SchedulingInfo> m_schedulingInfo;
+    std::vector<ProductContext *> m_blockedProducts; // Skip the ones no longer flagged as blocked.
+    int m_blockedProductCount = 0;
     std::vector<ProductContext *> m_finishedProducts;
     std::unordered_map<ProductContext *,
     std::vector<ProductWithLoaderState>> m_waitingForSingleDependency;
@@ -177,20 +218,144 @@ void ProductsResolver::initializeProductQueue()
         }
     }
 
+    std::vector<ProductContext *> allProducts;
     for (ProductContext * const product : sortedProducts) {
-        queueProductForScheduling(ProductWithLoaderState(*product, nullptr), Deferral::Allowed);
+        allProducts.push_back(product);
         if (product->shadowProduct) {
             topLevelProject.addProductToHandle(*product->shadowProduct);
-            queueProductForScheduling(ProductWithLoaderState(*product->shadowProduct, nullptr),
-                                      Deferral::Allowed);
+            allProducts.push_back(product->shadowProduct.get());
+        }
+    }
+    initializeSchedulingGraph(allProducts);
+
+    // Products with unfinished dependencies are not queued until these have finished,
+    // so they do not occupy a thread just to find out that they have to be deferred.
+    for (ProductContext * const product : allProducts) {
+        SchedulingInfo &info = m_schedulingInfo[product];
+        if (info.pendingDependencyCount == 0) {
+            queueProductForScheduling(ProductWithLoaderState(*product, nullptr), Deferral::Allowed);
+        } else {
+            info.blocked = true;
+            m_blockedProducts.push_back(product);
+            ++m_blockedProductCount;
+        }
+    }
+}
+
+// A product's priority is its expected resolve time plus the highest priority among the
+// products depending on it, i.e. the length of the longest chain of products that cannot
+// start before it has finished. Working on the long chains first keeps the threads busy.
+// The expected resolve times come from the previous resolve; products without such
+// information are assumed to take as long as the average product.
+void ProductsResolver::initializeSchedulingGraph(const std::vector<ProductContext *> &products)
+{
+    TopLevelProjectContext &topLevelProject = m_loaderState.topLevelProject();
+    std::unordered_map<QString, std::vector<ProductContext *>> productsByName;
+    for (ProductContext * const product : products)
+        productsByName[product->name].push_back(product);
+
+    std::unordered_map<const ProductContext *, double> resolveTimes;
+    double knownResolveTimeSum = 0;
+    int knownResolveTimeCount = 0;
+    for (ProductContext * const product : products) {
+        SchedulingInfo &info = m_schedulingInfo[product];
+        if (const qint64 time = topLevelProject.oldProductResolveTime(product->uniqueName());
+                time > 0) {
+            resolveTimes[product] = time;
+            knownResolveTimeSum += time;
+            ++knownResolveTimeCount;
+        }
+        if (product->name.startsWith(StringConstants::shadowProductPrefix()))
+            continue;
+        Set<const ProductContext *> dependencies;
+        for (const Item * const child : product->item->children()) {
+            if (child->type() != ItemType::Depends)
+                continue;
+            const std::optional<QString> name = literalDependencyName(child);
+            if (!name)
+                continue;
+            const auto it = productsByName.find(*name);
+            if (it == productsByName.end())
+                continue;
+            for (ProductContext * const dependency : it->second) {
+                if (dependency != product && dependencies.insert(dependency).second) {
+                    m_schedulingInfo[dependency].dependents.push_back(product);
+                    ++info.pendingDependencyCount;
+                }
+            }
+        }
+    }
+    const double defaultResolveTime = knownResolveTimeCount > 0
+            ? knownResolveTimeSum / knownResolveTimeCount : 1;
+
+    // Iterative post-order traversal along the dependents. Edges closing a cycle are ignored;
+    // products on a cycle get released by the scheduler once nothing else can run.
+    enum class State { Unvisited, InProgress, Done };
+    std::unordered_map<const ProductContext *, State> states;
+    for (ProductContext * const root : products) {
+        if (states[root] != State::Unvisited)
+            continue;
+        std::vector<std::pair<ProductContext *, std::size_t>> stack{{root, 0}};
+        states[root] = State::InProgress;
+        while (!stack.empty()) {
+            auto &[product, nextDependent] = stack.back();
+            SchedulingInfo &info = m_schedulingInfo[product];
+            if (nextDependent < info.dependents.size()) {
+                ProductContext * const dependent = info.dependents.at(nextDependent++);
+                if (states[dependent] == State::Unvisited) {
+                    states[dependent] = State::InProgress;
+                    stack.emplace_back(dependent, 0);
+                }
+                continue;
+            }
+            double maxDependentPriority = 0;
+            for (const ProductContext * const dependent : info.dependents) {
+                if (states[dependent] == State::Done) {
+                    maxDependentPriority = std::max(maxDependentPriority,
+                                                    m_schedulingInfo[dependent].priority);
+                }
+            }
+            const auto resolveTime = resolveTimes.find(product);
+            info.priority = maxDependentPriority + (resolveTime != resolveTimes.end()
+                                                    ? resolveTime->second : defaultResolveTime);
+            states[product] = State::Done;
+            stack.pop_back();
         }
     }
 }
 
+std::optional<QString> ProductsResolver::literalDependencyName(const Item *dependsItem)
+{
+    const ValueConstPtr value = dependsItem->property(StringConstants::nameProperty());
+    if (!value || value->type() != Value::JSSourceValueType)
+        return {};
+    const auto sourceValue = std::static_pointer_cast<const JSSourceValue>(value);
+    if (!sourceValue->alternatives().empty())
+        return {};
+    const QStringView code = sourceValue->sourceCode().trimmed();
+    if (code.size() < 2)
+        return {};
+    const QChar quote = code.front();
+    if ((quote != QLatin1Char('"') && quote != QLatin1Char('\''))
+            || code.back() != quote) {
+        return {};
+    }
+    const QStringView name = code.mid(1, code.size() - 2);
+    if (name.contains(quote) || name.contains(QLatin1Char('\\')))
+        return {};
+    return name.toString();
+}
+
 void ProductsResolver::initializeLoaderStatePool()
 {
     TopLevelProjectContext &topLevelProject = m_loaderState.topLevelProject();
 
+    // Besides the products, the pool runs helper tasks such as directory listings, which
+    // must not exceed the job count either.
+    if (m_maxJobCount <= 0)
+        m_maxJobCount = BuildOptions::defaultMaxJobCount();
+    ThreadPool::globalInstance().setMaxThreadCount(m_maxJobCount);
+
     // Adapt max job count: It makes no sense to have it be higher than the number of products
     // or what can actually be run concurrently. In both cases, we would simply waste resources.
     const int maxConcurrency = std::thread::hardware_concurrency();
@@ -212,6 +377,8 @@ void ProductsResolver::initializeLoaderStatePool()
             ScriptEngine::create(m_loaderState.logger(), EvalContext::PropertyEvaluation));
         ItemPool &itemPool = topLevelProject.createItemPool();
         engine.setEnvironment(m_loaderState.parameters().adjustedEnvironment());
+        engine.setByteCodeCacheDirectory(
+                    m_loaderState.evaluator().engine()->byteCodeCacheDirectory());
         auto loaderState = std::make_unique<LoaderState>(
                     m_loaderState.parameters(), topLevelProject, itemPool, engine,
                     m_loaderState.logger());
@@ -246,6 +413,7 @@ void ProductsResolver::runScheduler()
     }
 
     QBS_CHECK(m_productsToSchedule.empty());
+    QBS_CHECK(m_blockedProductCount == 0);
     QBS_CHECK(m_loaderState.topLevelProject().productsToHandleCount() == 0);
     QBS_CHECK(m_runningThreads.empty());
     QBS_CHECK(m_waitingForSingleDependency.empty());
@@ -258,11 +426,13 @@ void ProductsResolver::scheduleNext()
     AccumulatingTimer timer(m_loaderState.parameters().logElapsedTime()
                             ? &topLevelProject.timingData().schedulingProducts : nullptr);
     while (m_maxJobCount > int(m_runningThreads.size()) && !m_productsToSchedule.empty()) {
-        auto [product, toHandleCountOnInsert] = m_productsToSchedule.front();
+        auto [product, toHandleCountOnInsert, priority, sequenceNumber]
+                = m_productsToSchedule.top();
         m_productsToSchedule.pop();
 
         qCDebug(lcLoaderScheduling) << "potentially scheduling product"
                                     << product.product->displayName()
+                                    << "with priority" << priority
                                     << "unhandled product count on queue insertion"
                                     << toHandleCountOnInsert << "current unhandled product count"
                                     << topLevelProject.productsToHandleCount();
@@ -287,16 +457,27 @@ void ProductsResolver::scheduleNext()
 
     // If we end up here, nothing was scheduled in the loop above, which means that either ...
     //  a) ... we are done or
-    //  b) ... we finally need to schedule our bulk dependencies or
-    //  c) ... we need to schedule products waiting for an unhandled dependency.
+    //  b) ... some products are still blocked on statically known dependencies, which
+    //         can happen if these form a cycle or are not active in the end or
+    //  c) ... we finally need to schedule our bulk dependencies or
+    //  d) ... we need to schedule products waiting for an unhandled dependency.
     // In the latter case, the project has at least one dependency cycle, and the
     // DependencyResolver will emit an error.
 
     // a)
-    if (m_waitingForBulkDependency.empty() && m_waitingForSingleDependency.empty())
+    if (m_blockedProductCount == 0 && m_waitingForBulkDependency.empty()
+            && m_waitingForSingleDependency.empty()) {
         return;
+    }
 
     // b)
+    if (m_blockedProductCount > 0) {
+        releaseBlockedProducts();
+        scheduleNext();
+        return;
+    }
+
+    // c)
     for (const ProductWithLoaderState &product : m_waitingForBulkDependency)
         queueProductForScheduling(product, Deferral::NotAllowed);
     if (!m_productsToSchedule.empty()) {
@@ -305,7 +486,7 @@ void ProductsResolver::scheduleNext()
         return;
     }
 
-    // c)
+    // d)
     for (const auto &e : m_waitingForSingleDependency) {
         for (const ProductWithLoaderState &p : e.second)
             queueProductForScheduling(p, Deferral::NotAllowed);
@@ -354,30 +535,38 @@ void ProductsResolver::startJob(const ProductWithLoaderState &product, Deferral
                                 << "with loader state" << product.loaderState
                                 << "and deferral mode" << int(deferral);
     try {
-        const auto it = m_runningThreads.emplace(product.product, ThreadInfo(std::async(m_asyncMode,
-            [this, product, deferral] {
-                product.loaderState->itemReader().setExtraSearchPathsStack(
+        const auto job = [this, product, deferral] {
+            AccumulatingTimer resolveTimer(&product.product->resolveTime);
+            product.loaderState->itemReader().setExtraSearchPathsStack(
                 product.product->project->searchPathsStack);
-                resolveProduct(*product.product, deferral, *product.loaderState);
-
-                // The search paths stack can change during dependency resolution
-                // (due to module providers); check that we've rolled back all the changes
-                QBS_CHECK(product.loaderState->itemReader().extraSearchPathsStack()
-                          == product.product->project->searchPathsStack);
-
-                std::lock_guard cancelingLock(m_cancelingMutex);
-                if (m_canceling)
-                    return;
-                ThreadsLocker threadsLock(m_asyncMode, m_threadsMutex);
-                if (const auto it = m_runningThreads.find(product.product);
-                    it != m_runningThreads.end()) {
-                    it->second.done = true;
-                    qCDebug(lcLoaderScheduling) << "thread for product"
-                                                << product.product->displayName()
-                                                << "finished, waking up scheduler";
-                    m_threadsNotifier.notify_one();
-                }
-            }), *product.loaderState));
+            resolveProduct(*product.product, deferral, *product.loaderState);
+            resolveTimer.stop();
+
+            // The search paths stack can change during dependency resolution
+            // (due to module providers); check that we've rolled back all the changes
+            QBS_CHECK(product.loaderState->itemReader().extraSearchPathsStack()
+                      == product.product->project->searchPathsStack);
+
+            std::lock_guard cancelingLock(m_cancelingMutex);
+            if (m_canceling)
+                return;
+            ThreadsLocker threadsLock(m_asyncMode, m_threadsMutex);
+            if (const auto it = m_runningThreads.find(product.product);
+                it != m_runningThreads.end()) {
+                it->second.done = true;
+                qCDebug(lcLoaderScheduling) << "thread for product"
+                                            << product.product->displayName()
+                                            << "finished, waking up scheduler";
+                m_threadsNotifier.notify_one();
+            }
+        };
+
+        // Products are resolved in the shared thread pool, so consecutive resolves
+        // in the same process do not have to create new threads.
+        const auto it = m_runningThreads.emplace(product.product, ThreadInfo(
+            m_asyncMode == std::launch::async ? ThreadPool::globalInstance().run(job)
+                                              : std::async(std::launch::deferred, job),
+            *product.loaderState));
 
         // With just one worker thread, the notify/wait overhead would be excessive, so
         // we run the task synchronously.
@@ -475,9 +664,12 @@ void ProductsResolver::handleFinishedThreads()
             if (!product.name.startsWith(StringConstants::shadowProductPrefix()))
                 m_finishedProducts.push_back(&product);
             topLevelProject.timingData() += product.timingData;
+            if (product.product && !product.productReused)
+                product.product->resolveTime = product.resolveTime;
             checkForMissedBulkDependencies(product);
             topLevelProject.registerBulkDependencies(product);
             unblockProductsWaitingForDependency(product);
+            unblockStaticDependents(product);
         }
     }
 
@@ -490,8 +682,10 @@ void ProductsResolver::queueProductForScheduling(const ProductWithLoaderState &p
 {
     qCDebug(lcLoaderScheduling) << "queueing product" << product.product->displayName()
                                 << "with deferral mode" << int(deferral);
-    m_productsToSchedule.emplace(product, deferral == Deferral::Allowed
-            ? -1 : m_loaderState.topLevelProject().productsToHandleCount());
+    m_productsToSchedule.push({product, deferral == Deferral::Allowed
+                               ? -1 : m_loaderState.topLevelProject().productsToHandleCount(),
+                               m_schedulingInfo[product.product].priority,
+                               m_queueSequenceNumber++});
 }
 
 void ProductsResolver::waitForSingleDependency(const ProductWithLoaderState &product,
@@ -525,6 +719,35 @@ void ProductsResolver::unblockProductsWaitingForDependency(ProductContext &finis
     m_waitingForSingleDependency.erase(it);
 }
 
+void ProductsResolver::unblockStaticDependents(const ProductContext &finishedProduct)
+{
+    for (ProductContext * const dependent : m_schedulingInfo[&finishedProduct].dependents) {
+        SchedulingInfo &dependentInfo = m_schedulingInfo[dependent];
+        if (--dependentInfo.pendingDependencyCount != 0 || !dependentInfo.blocked)
+            continue;
+        qCDebug(lcLoaderScheduling) << "all known dependencies of product"
+                                    << dependent->displayName() << "have finished";
+        dependentInfo.blocked = false;
+        --m_blockedProductCount;
+        queueProductForScheduling(ProductWithLoaderState(*dependent, nullptr), Deferral::Allowed);
+    }
+}
+
+void ProductsResolver::releaseBlockedProducts()
+{
+    qCDebug(lcLoaderScheduling) << "releasing" << m_blockedProductCount
+                                << "products blocked on known dependencies";
+    for (ProductContext * const product : m_blockedProducts) {
+        SchedulingInfo &info = m_schedulingInfo[product];
+        if (!info.blocked)
+            continue;
+        info.blocked = false;
+        queueProductForScheduling(ProductWithLoaderState(*product, nullptr), Deferral::Allowed);
+    }
+    m_blockedProducts.clear();
+    m_blockedProductCount = 0;
+}
+
 void ProductsResolver::postProcess()
 {
     for (ProductContext * const product : m_finishedProducts) {
@@ -165,6 +165,17 @@ void ProjectResolver::setOldProductProbes(
     d->state.topLevelProject().setOldProductProbes(oldProbes);
 }
 
+void ProjectResolver::setReusableProducts(const QHash<QString, ResolvedProductPtr> &products,
+                                          const TopLevelProjectConstPtr &earlierProject)
+{
+    d->state.topLevelProject().setReusableProducts(products, earlierProject);
+}
+
+void ProjectResolver::setOldProductResolveTimes(const QHash<QString, qint64> &resolveTimes)
+{
+    d->state.topLevelProject().setOldProductResolveTimes(resolveTimes);
+}
+
 void ProjectResolver::setLastResolveTime(const FileTime &time)
 {
     d->state.topLevelProject().setLastResolveTime(time);
@@ -476,7 +487,7 @@ void ProjectResolver::Private::loadTopLevelProjectItem()
               .value(StringConstants::qbsSearchPathsProperty()).toStringList();
     SearchPathsManager searchPathsManager(state.itemReader(), topLevelSearchPaths);
     Item * const root = state.itemReader().setupItemFromFile(
-                state.parameters().projectFilePath(), {});
+                state.parameters().projectFilePath(), {}, AstRetention::Release);
     if (!root)
         return;
 
@@ -554,6 +565,10 @@ void ProjectResolver::Private::printProfilingInfo()
            .arg(state.topLevelProject().probesRunCount())
            .arg(state.topLevelProject().reusedCurrentProbesCount())
            .arg(state.topLevelProject().reusedOldProbesCount());
+    state.logger().qbsLog(LoggerInfo, true)
+        << "    "
+        << Tr::tr("%1 products re-used from earlier run.")
+           .arg(state.topLevelProject().reusedProductsCount());
     print(2, Tr::tr("Property checking took %1."),
           state.topLevelProject().timingData().propertyChecking);
 }
@@ -68,6 +68,9 @@ public:
     void setProgressObserver(ProgressObserver *observer);
     void setOldProjectProbes(const std::vector<ProbeConstPtr> &oldProbes);
     void setOldProductProbes(const QHash<QString, std::vector<ProbeConstPtr>> &oldProbes);
+    void setReusableProducts(const QHash<QString, ResolvedProductPtr> &products,
+                             const TopLevelProjectConstPtr &earlierProject);
+    void setOldProductResolveTimes(const QHash<QString, qint64> &resolveTimes);
     void setLastResolveTime(const FileTime &time);
     void setStoredProfiles(const QVariantMap &profiles);
     void setStoredModuleProviderInfo(const StoredModuleProviderInfo &providerInfo);
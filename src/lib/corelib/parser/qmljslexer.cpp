@@ -74,6 +74,12 @@ static unsigned char convertHex(ushort c)
     return (c - 'A' + 10);
 }
 
+static bool isAsciiIdentifierPart(ushort c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+            || c == '$' || c == '_';
+}
+
 static QChar convertHex(QChar c1, QChar c2)
 {
     return QChar{(convertHex(c1.unicode()) << 4) + convertHex(c2.unicode())};
@@ -701,6 +707,12 @@ again:
                 }
             }
             while (true) {
+                if (! identifierWithEscapeChars) {
+                    // Fast path for the bulk of identifiers, which are plain ASCII. Such a run
+                    // cannot contain a line terminator, so scanChar()'s bookkeeping is not needed.
+                    while (isAsciiIdentifierPart(_char.unicode()))
+                        _char = *_codePtr++;
+                }
                 if (_char.isLetterOrNumber() || _char == QLatin1Char('$') || _char == QLatin1Char('_')) {
                     if (identifierWithEscapeChars)
                         _tokenText += _char;
@@ -41,6 +41,7 @@
 
 #include "error.h"
 #include "hostosinfo.h"
+#include "persistence.h"
 #include "processutils.h"
 #include "progressobserver.h"
 #include "stringconstants.h"
@@ -107,7 +108,8 @@ static bool appNamesAreEqual(const QString &app1, const QString &app2)
 
 BuildGraphLocker::BuildGraphLocker(const QString &buildGraphFilePath, const Logger &logger,
                                    bool waitIndefinitely, ProgressObserver *observer)
-    : m_lockFile(buildGraphFilePath + QStringLiteral(".lock"))
+    : m_buildGraphFilePath(buildGraphFilePath)
+    , m_lockFile(buildGraphFilePath + QStringLiteral(".lock"))
     , m_logger(logger)
     , m_dirManager(QFileInfo(buildGraphFilePath).absolutePath(), logger)
 {
@@ -159,6 +161,10 @@ BuildGraphLocker::BuildGraphLocker(const QString &buildGraphFilePath, const Logg
 
 BuildGraphLocker::~BuildGraphLocker()
 {
+    // Other processes must not see the build graph before it has been written completely.
+    const ErrorInfo error = PersistentPool::waitForBackgroundWrite(m_buildGraphFilePath);
+    if (error.hasError())
+        m_logger.printWarning(error);
     m_lockFile.unlock();
 }
 
@@ -76,6 +76,7 @@ public:
     ~BuildGraphLocker();
 
 private:
+    const QString m_buildGraphFilePath;
     QLockFile m_lockFile;
     Logger m_logger;
     DirectoryManager m_dirManager;
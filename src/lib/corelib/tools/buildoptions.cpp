@@ -74,6 +74,7 @@ public:
     bool removeExistingInstallation;
     bool onlyExecuteRules;
     bool jobLimitsFromProjectTakePrecedence = false;
+    bool storeBuildGraphInBackground = false;
 };
 
 } // namespace Internal
@@ -395,6 +396,27 @@ void BuildOptions::setExecuteRulesOnly(bool onlyRules)
     d->onlyExecuteRules = onlyRules;
 }
 
+/*!
+ * \brief Returns true iff the build graph is written to disk in a background thread.
+ * The default is false.
+ */
+bool BuildOptions::storeBuildGraphInBackground() const
+{
+    return d->storeBuildGraphInBackground;
+}
+
+/*!
+ * If \a inBackground is \c true, the build job finishes as soon as the build graph data
+ * has been serialized in memory, while the file is written in a background thread.
+ * The build graph stays locked until the file has been written.
+ * If writing the file fails, the failure is reported as a warning when the project gets
+ * stored again or released, and the next store writes the complete build graph.
+ */
+void BuildOptions::setStoreBuildGraphInBackground(bool inBackground)
+{
+    d->storeBuildGraphInBackground = inBackground;
+}
+
 
 bool operator==(const BuildOptions &bo1, const BuildOptions &bo2)
 {
@@ -457,6 +479,7 @@ qbs::BuildOptions qbs::BuildOptions::fromJson(const QJsonObject &data)
     setValueFromJson(opt.d->removeExistingInstallation, data, "clean-install-root");
     setValueFromJson(opt.d->onlyExecuteRules, data, "only-execute-rules");
     setValueFromJson(opt.d->jobLimitsFromProjectTakePrecedence, data, "enforce-project-job-limits");
+    setValueFromJson(opt.d->storeBuildGraphInBackground, data, "store-build-graph-in-background");
     return opt;
 }
 
@@ -113,6 +113,9 @@ public:
     bool executeRulesOnly() const;
     void setExecuteRulesOnly(bool onlyRules);
 
+    bool storeBuildGraphInBackground() const;
+    void setStoreBuildGraphInBackground(bool inBackground);
+
 private:
     QSharedDataPointer<Internal::BuildOptionsPrivate> d;
 };
@@ -0,0 +1,376 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_CHUNKEDVECTOR_H
+#define QBS_CHUNKEDVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// A random-access sequence with the interface of std::vector as far as Set needs it.
+// Small sequences live in a single contiguous buffer. Once the size exceeds smallSizeLimit,
+// the elements are distributed over chunks of bounded size, so that inserting or erasing
+// in the middle costs O(chunk size) instead of O(n). Random access then needs a binary
+// search over the chunk offsets; sequential iteration stays cheap.
+template<typename T> class ChunkedVector
+{
+    template<bool IsConst> class Iterator;
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type smallSizeLimit = 1024;
+    static constexpr size_type chunkSize = 512;
+
+    ChunkedVector() = default;
+    ChunkedVector(std::initializer_list<T> list) { setElements(std::vector<T>(list)); }
+    ChunkedVector(const ChunkedVector &other) { *this = other; }
+    ChunkedVector(ChunkedVector &&other) noexcept = default;
+    ChunkedVector &operator=(const ChunkedVector &other);
+    ChunkedVector &operator=(ChunkedVector &&other) noexcept = default;
+
+    iterator begin() { return iterator(this, 0, 0); }
+    iterator end() { return endIterator<iterator>(this); }
+    const_iterator begin() const { return const_iterator(this, 0, 0); }
+    const_iterator end() const { return endIterator<const_iterator>(this); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crbegin() const { return rbegin(); }
+    const_reverse_iterator crend() const { return rend(); }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return m_chunks ? m_chunks->size : m_small.size(); }
+    size_type capacity() const { return m_chunks ? m_chunks->size : m_small.capacity(); }
+    bool isChunked() const { return bool(m_chunks); }
+
+    void reserve(size_type size);
+    void clear() { m_small.clear(); m_chunks.reset(); }
+    void swap(ChunkedVector &other) noexcept;
+    void push_back(const T &v) { insert(cend(), v); }
+    iterator insert(const_iterator pos, const T &v);
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    bool operator==(const ChunkedVector &other) const
+    {
+        return size() == other.size() && std::equal(cbegin(), cend(), other.cbegin());
+    }
+    bool operator!=(const ChunkedVector &other) const { return !(*this == other); }
+
+private:
+    struct Chunks
+    {
+        std::vector<std::vector<T>> chunks; // Never empty, and no chunk is empty.
+        std::vector<size_type> offsets; // Index of the first element of each chunk.
+        size_type size = 0;
+    };
+
+    size_type chunkCount() const { return m_chunks ? m_chunks->chunks.size() : 1; }
+    std::vector<T> &chunkAt(size_type i) { return m_chunks ? m_chunks->chunks[i] : m_small; }
+    const std::vector<T> &chunkAt(size_type i) const
+    {
+        return m_chunks ? m_chunks->chunks[i] : m_small;
+    }
+    size_type offsetOf(size_type chunk) const { return m_chunks ? m_chunks->offsets[chunk] : 0; }
+    void locate(size_type index, size_type *chunk, size_type *pos) const;
+    void updateOffsets(size_type firstChunk);
+    std::vector<T> takeElements();
+    void setElements(std::vector<T> &&elements);
+
+    template<typename It, typename Container> static It endIterator(Container *c)
+    {
+        const size_type last = c->chunkCount() - 1;
+        return It(c, last, c->chunkAt(last).size());
+    }
+
+    std::vector<T> m_small;
+    std::unique_ptr<Chunks> m_chunks;
+};
+
+template<typename T> template<bool IsConst> class ChunkedVector<T>::Iterator
+{
+    friend class ChunkedVector;
+    template<bool> friend class Iterator;
+    using Container = std::conditional_t<IsConst, const ChunkedVector, ChunkedVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T *, T *>;
+    using reference = std::conditional_t<IsConst, const T &, T &>;
+
+    Iterator() = default;
+    template<bool OtherIsConst, typename = std::enable_if_t<IsConst || !OtherIsConst>>
+    Iterator(const Iterator<OtherIsConst> &other)
+        : m_container(other.m_container), m_chunk(other.m_chunk), m_pos(other.m_pos) {}
+
+    reference operator*() const { return m_container->chunkAt(m_chunk)[m_pos]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    Iterator &operator++()
+    {
+        if (++m_pos == m_container->chunkAt(m_chunk).size()
+                && m_chunk + 1 < m_container->chunkCount()) {
+            ++m_chunk;
+            m_pos = 0;
+        }
+        return *this;
+    }
+    Iterator operator++(int) { Iterator it = *this; ++*this; return it; }
+    Iterator &operator--()
+    {
+        if (m_pos == 0)
+            m_pos = m_container->chunkAt(--m_chunk).size();
+        --m_pos;
+        return *this;
+    }
+    Iterator operator--(int) { Iterator it = *this; --*this; return it; }
+
+    Iterator &operator+=(difference_type n)
+    {
+        if (!m_container->m_chunks) {
+            m_pos += n;
+            return *this;
+        }
+        m_container->locate(index() + n, &m_chunk, &m_pos);
+        return *this;
+    }
+    Iterator &operator-=(difference_type n) { return *this += -n; }
+    friend Iterator operator+(Iterator it, difference_type n) { return it += n; }
+    friend Iterator operator+(difference_type n, Iterator it) { return it += n; }
+    friend Iterator operator-(Iterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const Iterator &it1, const Iterator &it2)
+    {
+        return difference_type(it1.index()) - difference_type(it2.index());
+    }
+
+    friend bool operator==(const Iterator &it1, const Iterator &it2)
+    {
+        return it1.m_chunk == it2.m_chunk && it1.m_pos == it2.m_pos;
+    }
+    friend bool operator!=(const Iterator &it1, const Iterator &it2) { return !(it1 == it2); }
+    friend bool operator<(const Iterator &it1, const Iterator &it2)
+    {
+        return it1.m_chunk < it2.m_chunk || (it1.m_chunk == it2.m_chunk && it1.m_pos < it2.m_pos);
+    }
+    friend bool operator>(const Iterator &it1, const Iterator &it2) { return it2 < it1; }
+    friend bool operator<=(const Iterator &it1, const Iterator &it2) { return !(it2 < it1); }
+    friend bool operator>=(const Iterator &it1, const Iterator &it2) { return !(it1 < it2); }
+
+private:
+    Iterator(Container *container, size_type chunk, size_type pos)
+        : m_container(container), m_chunk(chunk), m_pos(pos) {}
+
+    size_type index() const { return m_container->offsetOf(m_chunk) + m_pos; }
+
+    Container *m_container = nullptr;
+    size_type m_chunk = 0;
+    size_type m_pos = 0;
+};
+
+template<typename T>
+ChunkedVector<T> &ChunkedVector<T>::operator=(const ChunkedVector<T> &other)
+{
+    if (this == &other)
+        return *this;
+    m_small = other.m_small;
+    m_chunks = other.m_chunks ? std::make_unique<Chunks>(*other.m_chunks) : nullptr;
+    return *this;
+}
+
+template<typename T> void ChunkedVector<T>::reserve(size_type size)
+{
+    if (!m_chunks)
+        m_small.reserve(std::min(size, smallSizeLimit));
+}
+
+template<typename T> void ChunkedVector<T>::swap(ChunkedVector<T> &other) noexcept
+{
+    m_small.swap(other.m_small);
+    m_chunks.swap(other.m_chunks);
+}
+
+template<typename T>
+typename ChunkedVector<T>::iterator ChunkedVector<T>::insert(const_iterator pos, const T &v)
+{
+    const size_type index = pos.index();
+    if (!m_chunks) {
+        m_small.insert(m_small.begin() + index, v);
+        if (m_small.size() > smallSizeLimit)
+            setElements(takeElements());
+        return begin() + index;
+    }
+
+    std::vector<T> &chunk = m_chunks->chunks[pos.m_chunk];
+    chunk.insert(chunk.begin() + pos.m_pos, v);
+    if (chunk.size() >= 2 * chunkSize) {
+        std::vector<T> tail(chunk.begin() + chunkSize, chunk.end());
+        chunk.resize(chunkSize);
+        m_chunks->chunks.insert(m_chunks->chunks.begin() + pos.m_chunk + 1, std::move(tail));
+        m_chunks->offsets.insert(m_chunks->offsets.begin() + pos.m_chunk + 1, 0);
+    }
+    updateOffsets(pos.m_chunk);
+    return begin() + index;
+}
+
+template<typename T>
+typename ChunkedVector<T>::iterator ChunkedVector<T>::erase(const_iterator pos)
+{
+    const size_type index = pos.index();
+    if (!m_chunks) {
+        m_small.erase(m_small.begin() + index);
+        return begin() + index;
+    }
+
+    std::vector<T> &chunk = m_chunks->chunks[pos.m_chunk];
+    chunk.erase(chunk.begin() + pos.m_pos);
+    if (chunk.empty()) {
+        m_chunks->chunks.erase(m_chunks->chunks.begin() + pos.m_chunk);
+        m_chunks->offsets.erase(m_chunks->offsets.begin() + pos.m_chunk);
+    }
+    updateOffsets(pos.m_chunk);
+    if (m_chunks && m_chunks->size <= smallSizeLimit / 2)
+        setElements(takeElements());
+    return begin() + index;
+}
+
+template<typename T> typename ChunkedVector<T>::iterator
+ChunkedVector<T>::erase(const_iterator first, const_iterator last)
+{
+    const size_type firstIndex = first.index();
+    const size_type lastIndex = last.index();
+    if (firstIndex == lastIndex)
+        return begin() + firstIndex;
+    if (!m_chunks) {
+        m_small.erase(m_small.begin() + firstIndex, m_small.begin() + lastIndex);
+        return begin() + firstIndex;
+    }
+    std::vector<T> elements = takeElements();
+    elements.erase(elements.begin() + firstIndex, elements.begin() + lastIndex);
+    setElements(std::move(elements));
+    return begin() + firstIndex;
+}
+
+template<typename T>
+void ChunkedVector<T>::locate(size_type index, size_type *chunk, size_type *pos) const
+{
+    if (index >= m_chunks->size) {
+        *chunk = m_chunks->chunks.size() - 1;
+        *pos = m_chunks->chunks.back().size();
+        return;
+    }
+    const auto it = std::upper_bound(m_chunks->offsets.cbegin(), m_chunks->offsets.cend(), index);
+    *chunk = std::distance(m_chunks->offsets.cbegin(), it) - 1;
+    *pos = index - m_chunks->offsets[*chunk];
+}
+
+template<typename T> void ChunkedVector<T>::updateOffsets(size_type firstChunk)
+{
+    auto &chunks = m_chunks->chunks;
+    auto &offsets = m_chunks->offsets;
+    if (chunks.empty()) {
+        m_chunks.reset();
+        return;
+    }
+    offsets.front() = 0;
+    for (size_type i = std::max<size_type>(firstChunk, 1); i < chunks.size(); ++i)
+        offsets[i] = offsets[i - 1] + chunks[i - 1].size();
+    m_chunks->size = offsets.back() + chunks.back().size();
+}
+
+template<typename T> std::vector<T> ChunkedVector<T>::takeElements()
+{
+    if (!m_chunks)
+        return std::move(m_small);
+    std::vector<T> elements;
+    elements.reserve(m_chunks->size);
+    for (std::vector<T> &chunk : m_chunks->chunks)
+        std::move(chunk.begin(), chunk.end(), std::back_inserter(elements));
+    m_chunks.reset();
+    return elements;
+}
+
+template<typename T> void ChunkedVector<T>::setElements(std::vector<T> &&elements)
+{
+    m_small.clear();
+    m_chunks.reset();
+    if (elements.size() <= smallSizeLimit) {
+        m_small = std::move(elements);
+        return;
+    }
+    m_chunks = std::make_unique<Chunks>();
+    for (size_type i = 0; i < elements.size(); i += chunkSize) {
+        const auto chunkEnd = elements.begin() + std::min(i + chunkSize, elements.size());
+        m_chunks->offsets.push_back(i);
+        m_chunks->chunks.emplace_back(std::make_move_iterator(elements.begin() + i),
+                                      std::make_move_iterator(chunkEnd));
+    }
+    m_chunks->size = elements.size();
+    m_small.shrink_to_fit();
+}
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_CHUNKEDVECTOR_H
@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "directorylistingcache.h"
+
+#include "fileinfo.h"
+#include "threadpool.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+
+
+namespace qbs {
+namespace Internal {
+
+std::vector<DirectoryListingCache::ListingPtr> DirectoryListingCache::listings(
+        const QStringList &dirPaths)
+{
+    if (dirPaths.size() == 1)
+        return {fetch(dirPaths.front())};
+
+    // Even the cache hits need a stat() call, so all directories go to the pool.
+    // This is called from product resolving tasks, which must not get other products'
+    // resolves nested into them, so the calling thread only helps with the listings.
+    return ThreadPool::globalInstance().mapped(dirPaths, [this](const QString &dirPath) {
+        return fetch(dirPath);
+    });
+}
+
+DirectoryListingCache::ListingPtr DirectoryListingCache::fetch(const QString &dirPath)
+{
+    const FileTime lastModified = FileInfo(dirPath).lastModified();
+    {
+        const auto listingsGuard = m_listings.lock();
+        const auto it = listingsGuard.get().find(dirPath);
+        if (it != listingsGuard.get().end() && it->second->lastModified == lastModified)
+            return it->second;
+    }
+
+    // Another thread might read the same directory concurrently; both results are equivalent.
+    ListingPtr listing = readDirectory(dirPath, lastModified);
+    m_listings.lock().get()[dirPath] = listing;
+    return listing;
+}
+
+DirectoryListingCache::ListingPtr DirectoryListingCache::readDirectory(
+        const QString &dirPath, const FileTime &lastModified)
+{
+    const auto listing = std::make_shared<Listing>();
+    listing->dirPath = dirPath;
+    listing->lastModified = lastModified;
+    QDirIterator it(dirPath, QDir::AllEntries | QDir::Hidden | QDir::System
+                    | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        listing->entries.push_back({fi.fileName(), fi.isDir(), fi.isSymLink(), fi.isHidden()});
+    }
+    return listing;
+}
+
+} // namespace Internal
+} // namespace qbs
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_DIRECTORYLISTINGCACHE_H
+#define QBS_DIRECTORYLISTINGCACHE_H
+
+#include "filetime.h"
+#include "mutexdata.h"
+#include "qbs_export.h"
+
+#include <QtCore/qstring.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// Caches the contents of directories for the duration of a resolve, so that wildcard patterns
+// of different groups and products share the file system accesses. A cached listing is only
+// handed out as long as the directory's modification time has not changed, which keeps the
+// cache valid if files get created during the resolve, e.g. by probes.
+class QBS_AUTOTEST_EXPORT DirectoryListingCache
+{
+public:
+    struct Entry
+    {
+        QString name;
+        bool isDir = false; // Follows symbolic links.
+        bool isSymLink = false;
+        bool isHidden = false;
+    };
+
+    struct Listing
+    {
+        QString dirPath;
+        FileTime lastModified; // As reported by FileInfo; invalid for non-existing directories.
+        std::vector<Entry> entries;
+    };
+    using ListingPtr = std::shared_ptr<const Listing>;
+
+    // The result has the same order as dirPaths. The directories are processed in parallel,
+    // with the calling thread taking part.
+    std::vector<ListingPtr> listings(const QStringList &dirPaths);
+    ListingPtr listing(const QString &dirPath) { return listings({dirPath}).front(); }
+
+private:
+    ListingPtr fetch(const QString &dirPath);
+    static ListingPtr readDirectory(const QString &dirPath, const FileTime &lastModified);
+
+    MutexData<std::unordered_map<QString, ListingPtr>, std::mutex> m_listings;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_DIRECTORYLISTINGCACHE_H
@@ -0,0 +1,180 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "pathtable.h"
+
+#include <QtCore/qalgorithms.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace qbs {
+namespace Internal {
+
+QString PathTable::Entry::filePath() const
+{
+    if (dirId == 0) // No directory part.
+        return fileName;
+    QString path;
+    path.reserve(dirPath.size() + 1 + fileName.size());
+    path.append(dirPath).append(QLatin1Char('/')).append(fileName);
+    return path;
+}
+
+PathTable::~PathTable()
+{
+    qDeleteAll(m_relativePaths.files);
+    for (DirectoryNode * const dirNode : std::as_const(m_directories)) {
+        qDeleteAll(dirNode->files);
+        delete dirNode;
+    }
+}
+
+PathTable &PathTable::instance()
+{
+    static PathTable table;
+    return table;
+}
+
+const PathTable::Entry *PathTable::intern(const QString &filePath)
+{
+    QStringView dirPath;
+    QStringView fileName;
+    const bool hasDirectory = splitPath(filePath, &dirPath, &fileName);
+
+    // The common case of an already known path only needs the shared lock. Adding the
+    // reference while holding it keeps release() from removing the entry in the meantime.
+    {
+        std::shared_lock lock(m_mutex);
+        if (Entry * const entry = findEntry(hasDirectory, dirPath, fileName)) {
+            ++entry->refCount;
+            return entry;
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    DirectoryNode *dirNode = &m_relativePaths;
+    if (hasDirectory) {
+        dirNode = m_directories.value(dirPath);
+        if (!dirNode) {
+            dirNode = new DirectoryNode;
+            dirNode->id = m_nextDirId++;
+            dirNode->path = dirPath.toString();
+            m_directories.insert(QStringView(dirNode->path), dirNode);
+        }
+    }
+
+    // Another thread might have inserted the path while we were waiting for the lock.
+    Entry *entry = dirNode->files.value(fileName);
+    if (!entry) {
+        entry = new Entry;
+        entry->id = m_nextPathId++;
+        entry->dirId = dirNode->id;
+        entry->dirPath = QStringView(dirNode->path);
+        entry->fileName = fileName.toString();
+        dirNode->files.insert(QStringView(entry->fileName), entry);
+        ++m_pathCount;
+    }
+    ++entry->refCount;
+    return entry;
+}
+
+void PathTable::release(const Entry *entry)
+{
+    std::unique_lock lock(m_mutex);
+    if (--entry->refCount > 0)
+        return;
+    DirectoryNode * const dirNode = entry->dirId == m_relativePaths.id
+            ? &m_relativePaths : m_directories.value(entry->dirPath);
+    dirNode->files.remove(QStringView(entry->fileName));
+    delete entry;
+    --m_pathCount;
+    if (dirNode != &m_relativePaths && dirNode->files.isEmpty()) {
+        m_directories.remove(QStringView(dirNode->path));
+        delete dirNode;
+    }
+}
+
+PathTable::PathId PathTable::find(const QString &filePath) const
+{
+    QStringView dirPath;
+    QStringView fileName;
+    const bool hasDirectory = splitPath(filePath, &dirPath, &fileName);
+    std::shared_lock lock(m_mutex);
+    const Entry * const entry = findEntry(hasDirectory, dirPath, fileName);
+    return entry ? entry->id : invalidPathId;
+}
+
+PathTable::PathId PathTable::find(QStringView dirPath, QStringView fileName) const
+{
+    std::shared_lock lock(m_mutex);
+    const Entry * const entry = findEntry(true, dirPath, fileName);
+    return entry ? entry->id : invalidPathId;
+}
+
+int PathTable::pathCount() const
+{
+    std::shared_lock lock(m_mutex);
+    return m_pathCount;
+}
+
+int PathTable::directoryCount() const
+{
+    std::shared_lock lock(m_mutex);
+    return int(m_directories.size());
+}
+
+bool PathTable::splitPath(const QString &filePath, QStringView *dirPath, QStringView *fileName)
+{
+    const qsizetype idx = filePath.lastIndexOf(QLatin1Char('/'));
+    *dirPath = QStringView(filePath).left(std::max<qsizetype>(idx, 0));
+    *fileName = QStringView(filePath).mid(idx + 1);
+    return idx >= 0;
+}
+
+PathTable::Entry *PathTable::findEntry(bool hasDirectory, QStringView dirPath,
+                                       QStringView fileName) const
+{
+    const DirectoryNode * const dirNode = hasDirectory ? m_directories.value(dirPath)
+                                                       : &m_relativePaths;
+    return dirNode ? dirNode->files.value(fileName) : nullptr;
+}
+
+} // namespace Internal
+} // namespace qbs
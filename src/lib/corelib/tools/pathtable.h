@@ -0,0 +1,128 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_PATHTABLE_H
+#define QBS_PATHTABLE_H
+
+#include "qbs_export.h"
+
+#include <QtCore/qhash.h>
+#include <QtCore/qstring.h>
+
+#include <atomic>
+#include <shared_mutex>
+
+namespace qbs {
+namespace Internal {
+
+// A process-wide store of interned file paths. Every distinct path is kept exactly once,
+// as the id of its directory plus the file name, and all paths in the same directory share
+// one directory node. Entries are reference-counted: intern() adds a reference, release()
+// drops it, and the entry is removed with its last reference, as is its directory node once
+// it is empty. Ids are never reused, so they are suitable as hash keys even after the path
+// they denote has been removed.
+class QBS_AUTOTEST_EXPORT PathTable
+{
+public:
+    using PathId = quint32;
+    using DirId = quint32;
+    static constexpr PathId invalidPathId = 0;
+
+    struct Entry
+    {
+        PathId id = invalidPathId;
+        DirId dirId = 0;
+        QStringView dirPath; // Points into the shared directory node.
+        QString fileName;
+
+        // Assembled on every call.
+        QString filePath() const;
+
+    private:
+        friend class PathTable;
+        mutable std::atomic<int> refCount = 0;
+    };
+
+    PathTable() = default;
+    ~PathTable();
+
+    PathTable(const PathTable &) = delete;
+    PathTable &operator=(const PathTable &) = delete;
+
+    static PathTable &instance();
+
+    // The directory part is everything before the last slash, as in
+    // FileInfo::splitIntoDirectoryAndFileName(). The returned entry stays valid until
+    // the reference is released.
+    const Entry *intern(const QString &filePath);
+    void release(const Entry *entry);
+
+    // These return invalidPathId for paths that are not in the table. The second overload
+    // only considers paths that have a directory part.
+    PathId find(const QString &filePath) const;
+    PathId find(QStringView dirPath, QStringView fileName) const;
+
+    int pathCount() const;
+    int directoryCount() const;
+
+private:
+    struct DirectoryNode
+    {
+        DirId id = 0;
+        QString path;
+        QHash<QStringView, Entry *> files;
+    };
+
+    static bool splitPath(const QString &filePath, QStringView *dirPath, QStringView *fileName);
+    Entry *findEntry(bool hasDirectory, QStringView dirPath, QStringView fileName) const;
+
+    // File names without any directory part. This keeps "foo" apart from "/foo",
+    // whose directory part is empty as well.
+    DirectoryNode m_relativePaths;
+    QHash<QStringView, DirectoryNode *> m_directories;
+    DirId m_nextDirId = 1;
+    PathId m_nextPathId = 1;
+    int m_pathCount = 0;
+    mutable std::shared_mutex m_mutex;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_PATHTABLE_H
@@ -40,15 +40,27 @@
 #include "persistence.h"
 
 #include "fileinfo.h"
+#include <logging/categories.h>
 #include <logging/translator.h>
 #include <tools/error.h>
 
 #include <QtCore/qdir.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qsavefile.h>
+
+#include <atomic>
+#include <future>
+#include <mutex>
 
 namespace qbs {
 namespace Internal {
 
-static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-135";
+static const char QBS_PERSISTENCE_MAGIC[] = "QBSPERSISTENCE-143";
+
+// File layout: magic token, sections. The first section starts with the head data.
+// Each section starts with a table of the strings that are first used in it: The number of
+// strings, their UTF-8 sizes and then all their UTF-8 data in one block.
 
 NoBuildGraphError::NoBuildGraphError(const QString &filePath)
     : ErrorInfo(Tr::tr("Build graph not found for configuration '%1'. Expected location was '%2'.")
@@ -56,16 +68,36 @@ NoBuildGraphError::NoBuildGraphError(const QString &filePath)
 {
 }
 
+int PersistentPool::StoredState::sectionOf(const PersistentObject *object) const
+{
+    if (object->m_persistenceGeneration != m_generation || object->m_persistentId < 0)
+        return -1;
+    const auto section = std::upper_bound(m_sections.cbegin(), m_sections.cend(),
+            object->m_persistentId,
+            [](PersistentObjectId id, const Section &s) { return id < s.firstObjectId; });
+    return int(section - m_sections.cbegin()) - 1;
+}
+
+// Identifies one complete load or write of a build graph file and all partial rewrites
+// following it.
+quint32 PersistentPool::nextGeneration()
+{
+    static std::atomic<quint32> lastGeneration = 0;
+    quint32 generation = ++lastGeneration;
+    if (generation == 0) // 0 is the value of objects that were never loaded or stored.
+        generation = ++lastGeneration;
+    return generation;
+}
+
 PersistentPool::PersistentPool(Logger &logger) : m_logger(logger)
 {
-    Q_UNUSED(m_logger);
-    m_stream.setVersion(QDataStream::Qt_4_8);
 }
 
 PersistentPool::~PersistentPool() = default;
 
 void PersistentPool::load(const QString &filePath)
 {
+    finishBackgroundWrite(filePath);
     std::unique_ptr<QFile> file(new QFile(filePath));
     if (!file->exists())
         throw NoBuildGraphError(filePath);
@@ -74,80 +106,425 @@ void PersistentPool::load(const QString &filePath)
                     .arg(filePath, file->errorString()));
     }
 
-    m_stream.setDevice(file.get());
-    QByteArray magic;
-    m_stream >> magic;
+    m_buffer = file->readAll();
+    m_readPos = m_buffer.constData();
+    m_readEnd = m_readPos + m_buffer.size();
+    const qsizetype magicSize = qstrlen(QBS_PERSISTENCE_MAGIC);
+    const QByteArray magic = m_buffer.left(magicSize);
     if (magic != QBS_PERSISTENCE_MAGIC) {
-        m_stream.setDevice(nullptr);
+        m_buffer.clear();
         throw ErrorInfo(Tr::tr("Cannot use stored build graph at '%1': Incompatible file format. "
                            "Expected magic token '%2', got '%3'.")
                     .arg(filePath, QLatin1String(QBS_PERSISTENCE_MAGIC),
                          QString::fromLatin1(magic)));
     }
+    m_readPos += magicSize;
 
-    m_stream >> m_headData.projectConfig;
-    m_file = std::move(file);
+    m_filePath = filePath;
+    m_loading = true;
+    m_fileSize = m_buffer.size();
+    m_generation = nextGeneration();
+    m_sections.clear();
     m_loadedRaw.clear();
     m_loaded.clear();
     m_storageIndices.clear();
+    m_firstStoredObjectId = 0;
     m_stringStorage.clear();
     m_inverseStringStorage.clear();
+    m_envStorage.clear();
+    m_inverseEnvStorage.clear();
+    m_stringListStorage.clear();
+    m_inverseStringListStorage.clear();
+    m_lastStoredObjectId = 0;
+    m_lastStoredStringId = 0;
+    m_lastStoredEnvId = 0;
+    m_lastStoredStringListId = 0;
+    beginSection();
+    load(m_headData.projectConfig);
 }
 
 void PersistentPool::setupWriteStream(const QString &filePath)
 {
+    finishBackgroundWrite(filePath);
     QString dirPath = FileInfo::path(filePath);
     if (!FileInfo::exists(dirPath) && !QDir().mkpath(dirPath)) {
         throw ErrorInfo(Tr::tr("Failure storing build graph: Cannot create directory '%1'.")
                         .arg(dirPath));
     }
 
-    if (QFile::exists(filePath) && !QFile::remove(filePath)) {
-        throw ErrorInfo(Tr::tr("Failure storing build graph: Cannot remove old file '%1'")
-                        .arg(filePath));
-    }
-    QBS_CHECK(!QFile::exists(filePath));
-    std::unique_ptr<QFile> file(new QFile(filePath));
-    if (!file->open(QFile::WriteOnly)) {
-        throw ErrorInfo(Tr::tr("Failure storing build graph: "
-                "Cannot open file '%1' for writing: %2").arg(filePath, file->errorString()));
-    }
-
-    m_stream.setDevice(file.get());
-    m_file = std::move(file);
-    m_stream << QByteArray(qstrlen(QBS_PERSISTENCE_MAGIC), 0) << m_headData.projectConfig;
+    m_filePath = filePath;
+    m_loading = false;
+    m_buffer.clear();
+    m_sections.clear();
+    m_sectionBodyOffsets.clear();
+    m_firstStoredSection = 0;
+    m_rewriteOffset = -1;
+    m_generation = nextGeneration();
+    m_storedSharedObjects.clear();
+    m_storageIndices.clear();
+    m_storedPersistentObjects.clear();
+    m_firstStoredObjectId = 0;
+    m_stringStorage.clear();
+    m_inverseStringStorage.clear();
+    m_inverseEnvStorage.clear();
+    m_inverseStringListStorage.clear();
     m_lastStoredObjectId = 0;
     m_lastStoredStringId = 0;
     m_lastStoredEnvId = 0;
     m_lastStoredStringListId = 0;
+    beginSection();
+    store(m_headData.projectConfig);
+}
+
+template<typename T> static QHash<T, int> lookUpTable(const std::vector<T> &values, int endId)
+{
+    QHash<T, int> table;
+    table.reserve(endId);
+    for (int id = 0; id < endId; ++id)
+        table.insert(values.at(id), id);
+    return table;
+}
+
+template<typename T> static std::vector<T> valuesById(const QHash<T, int> &lookUpTable,
+                                                      int endId)
+{
+    std::vector<T> values(endId);
+    for (auto it = lookUpTable.cbegin(); it != lookUpTable.cend(); ++it)
+        values[it.value()] = it.key();
+    return values;
+}
+
+bool PersistentPool::setupWriteStream(const QString &filePath, StoredState &&state,
+                                      int firstSection)
+{
+    finishBackgroundWrite(filePath);
+    if (firstSection <= 0 || firstSection >= state.sectionCount()
+            || state.m_filePath != filePath) {
+        return false;
+    }
+    const QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || fileInfo.size() != state.m_fileSize)
+        return false;
+
+    const StoredState::Section section = state.m_sections.at(firstSection);
+    if (int(state.m_strings.size()) < section.firstStringId
+            || int(state.m_envs.size()) < section.firstEnvId
+            || int(state.m_stringLists.size()) < section.firstStringListId) {
+        return false;
+    }
+    m_filePath = filePath;
+    m_loading = false;
+    m_buffer.clear();
+    m_sections = std::move(state.m_sections);
+    m_sections.resize(firstSection);
+    m_sectionBodyOffsets.clear();
+    m_firstStoredSection = firstSection;
+    m_rewriteOffset = section.fileOffset;
+    m_fileSize = state.m_fileSize;
+    m_generation = state.m_generation;
+
+    // Everything that is defined in the sections to be rewritten gets stored anew.
+    // Objects from the other sections carry their ids, see storeSharedObject().
+    m_storedSharedObjects = std::move(state.m_sharedObjects);
+    m_storageIndices = std::move(state.m_sharedObjectIds);
+    for (auto it = m_storageIndices.begin(); it != m_storageIndices.end();) {
+        if (it->second >= section.firstObjectId)
+            it = m_storageIndices.erase(it);
+        else
+            ++it;
+    }
+    m_storedPersistentObjects.clear();
+    m_firstStoredObjectId = section.firstObjectId;
+    m_stringStorage.clear();
+    m_inverseStringStorage = lookUpTable(state.m_strings, section.firstStringId);
+    m_inverseEnvStorage = lookUpTable(state.m_envs, section.firstEnvId);
+    m_inverseStringListStorage = lookUpTable(state.m_stringLists, section.firstStringListId);
+    m_lastStoredObjectId = section.firstObjectId;
+    m_lastStoredStringId = section.firstStringId;
+    m_lastStoredEnvId = section.firstEnvId;
+    m_lastStoredStringListId = section.firstStringListId;
+    return true;
+}
+
+void PersistentPool::beginSection()
+{
+    StoredState::Section section;
+    section.firstObjectId = m_lastStoredObjectId;
+    section.firstStringId = m_lastStoredStringId;
+    section.firstEnvId = m_lastStoredEnvId;
+    section.firstStringListId = m_lastStoredStringListId;
+    if (m_loading) {
+        section.fileOffset = m_readPos - m_buffer.constData();
+        m_sections.push_back(section);
+        readStringTable();
+    } else {
+        m_sections.push_back(section);
+        m_sectionBodyOffsets.push_back(m_buffer.size());
+    }
+}
+
+// Puts the string tables in front of the respective sections.
+QByteArray PersistentPool::takeSections()
+{
+    QByteArray data;
+    data.reserve(m_buffer.size() + m_buffer.size() / 4);
+    const qint64 startOffset = m_firstStoredSection == 0 ? qint64(qstrlen(QBS_PERSISTENCE_MAGIC))
+                                                         : m_rewriteOffset;
+    const PersistentObjectId stringBase = m_sections.at(m_firstStoredSection).firstStringId;
+    for (std::size_t i = m_firstStoredSection; i < m_sections.size(); ++i) {
+        const bool isLast = i + 1 == m_sections.size();
+        const PersistentObjectId firstStringId = m_sections.at(i).firstStringId;
+        const PersistentObjectId endStringId = isLast ? m_lastStoredStringId
+                                                      : m_sections.at(i + 1).firstStringId;
+        const std::size_t bodyIndex = i - m_firstStoredSection;
+        const qsizetype bodyBegin = m_sectionBodyOffsets.at(bodyIndex);
+        const qsizetype bodyEnd = isLast ? m_buffer.size()
+                                         : m_sectionBodyOffsets.at(bodyIndex + 1);
+
+        m_sections[i].fileOffset = startOffset + data.size();
+        QByteArray stringData;
+        appendVarint(data, endStringId - firstStringId);
+        for (PersistentObjectId id = firstStringId; id < endStringId; ++id) {
+            const QByteArray utf8 = m_stringStorage.at(id - stringBase).toUtf8();
+            appendVarint(data, utf8.size());
+            stringData += utf8;
+        }
+        data += stringData;
+        data.append(m_buffer.constData() + bodyBegin, bodyEnd - bodyBegin);
+    }
+    m_buffer.clear();
+    m_stringStorage.clear();
+    m_sectionBodyOffsets.clear();
+    return data;
+}
+
+class PersistentPool::BuildGraphFileWrite
+{
+public:
+    QString filePath;
+    QByteArray sections;
+    qint64 rewriteOffset = -1;
+    qint64 existingFileSize = 0;
+
+    ErrorInfo execute() const
+    {
+        return rewriteOffset < 0 ? writeFile() : rewriteSections();
+    }
+
+private:
+    // The file is replaced atomically, so that neither a concurrent reader nor a crash
+    // can ever see an incompletely written build graph.
+    ErrorInfo writeFile() const
+    {
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return ErrorInfo(Tr::tr("Failure storing build graph: "
+                    "Cannot open file '%1' for writing: %2").arg(filePath, file.errorString()));
+        }
+        file.write(QBS_PERSISTENCE_MAGIC, qstrlen(QBS_PERSISTENCE_MAGIC));
+        file.write(sections);
+        if (!file.commit())
+            return failure(file.errorString());
+        return {};
+    }
+
+    // The unchanged leading part of the existing file is copied, and the copy replaces
+    // the file atomically, as in writeFile().
+    ErrorInfo rewriteSections() const
+    {
+        QFile oldFile(filePath);
+        if (!oldFile.open(QIODevice::ReadOnly))
+            return failure(oldFile.errorString());
+        if (oldFile.size() != existingFileSize)
+            return failure(Tr::tr("The file was changed by someone else."));
+        const qsizetype magicSize = qstrlen(QBS_PERSISTENCE_MAGIC);
+        if (oldFile.read(magicSize) != QBS_PERSISTENCE_MAGIC)
+            return failure(Tr::tr("The file was changed by someone else."));
+
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return ErrorInfo(Tr::tr("Failure storing build graph: "
+                    "Cannot open file '%1' for writing: %2").arg(filePath, file.errorString()));
+        }
+        file.write(QBS_PERSISTENCE_MAGIC, magicSize);
+        static const qint64 chunkSize = 1024 * 1024;
+        for (qint64 remaining = rewriteOffset - magicSize; remaining > 0;) {
+            const QByteArray chunk = oldFile.read(std::min(remaining, chunkSize));
+            if (chunk.isEmpty())
+                return failure(oldFile.errorString());
+            file.write(chunk);
+            remaining -= chunk.size();
+        }
+        oldFile.close();
+        file.write(sections);
+        if (!file.commit())
+            return failure(file.errorString());
+        return {};
+    }
+
+    ErrorInfo failure(const QString &reason) const
+    {
+        // Do not leave an outdated build graph behind.
+        QFile::remove(filePath);
+        return ErrorInfo(Tr::tr("Failure serializing build graph: %1").arg(reason));
+    }
+};
+
+PersistentPool::BuildGraphFileWrite PersistentPool::prepareFileWrite()
+{
+    BuildGraphFileWrite write;
+    write.filePath = m_filePath;
+    write.rewriteOffset = m_firstStoredSection == 0 ? -1 : m_rewriteOffset;
+    write.existingFileSize = m_fileSize;
+    write.sections = takeSections();
+    m_fileSize = m_sections.at(m_firstStoredSection).fileOffset + write.sections.size();
+    return write;
 }
 
 void PersistentPool::finalizeWriteStream()
 {
-    if (m_stream.status() != QDataStream::Ok)
-        throw ErrorInfo(Tr::tr("Failure serializing build graph."));
-    m_stream.device()->seek(0);
-    m_stream << QByteArray(QBS_PERSISTENCE_MAGIC);
-    if (m_stream.status() != QDataStream::Ok)
-        throw ErrorInfo(Tr::tr("Failure serializing build graph."));
-    const auto file = static_cast<QFile *>(m_stream.device());
-    if (!file->flush()) {
-        file->close();
-        file->remove();
-        throw ErrorInfo(Tr::tr("Failure serializing build graph: %1").arg(file->errorString()));
+    const ErrorInfo error = prepareFileWrite().execute();
+    if (error.hasError())
+        throw error;
+}
+
+namespace {
+class BackgroundWrites
+{
+public:
+    static BackgroundWrites &instance()
+    {
+        static BackgroundWrites writes;
+        return writes;
+    }
+
+    void add(const QString &filePath, std::future<ErrorInfo> &&write)
+    {
+        std::lock_guard lock(m_mutex);
+        m_writes.insert(filePath, std::make_shared<std::shared_future<ErrorInfo>>(write.share()));
+    }
+
+    // The entry stays in place until the write has finished, so that all concurrent waiters
+    // block on it. Only the waiter that removes it gets to see the error.
+    ErrorInfo wait(const QString &filePath)
+    {
+        std::unique_lock lock(m_mutex);
+        const WritePtr write = m_writes.value(filePath);
+        if (!write)
+            return {};
+        lock.unlock();
+        write->wait();
+        lock.lock();
+        const auto it = m_writes.constFind(filePath);
+        if (it == m_writes.cend() || it.value() != write)
+            return {};
+        m_writes.erase(it);
+        return write->get();
+    }
+
+private:
+    using WritePtr = std::shared_ptr<std::shared_future<ErrorInfo>>;
+    std::mutex m_mutex;
+    QHash<QString, WritePtr> m_writes; // The destructor waits for them.
+};
+} // namespace
+
+void PersistentPool::finalizeWriteStreamInBackground()
+{
+    std::future<ErrorInfo> future = std::async(std::launch::async,
+            [write = prepareFileWrite()] { return write.execute(); });
+    BackgroundWrites::instance().add(m_filePath, std::move(future));
+}
+
+ErrorInfo PersistentPool::waitForBackgroundWrite(const QString &filePath)
+{
+    return BackgroundWrites::instance().wait(filePath);
+}
+
+void PersistentPool::finishBackgroundWrite(const QString &filePath)
+{
+    const ErrorInfo error = waitForBackgroundWrite(filePath);
+    if (error.hasError())
+        m_logger.printWarning(error);
+}
+
+std::unique_ptr<PersistentPool::StoredState> PersistentPool::takeStoredState()
+{
+    auto state = std::make_unique<StoredState>();
+    state->m_filePath = m_filePath;
+    state->m_fileSize = m_fileSize;
+    state->m_generation = m_generation;
+    state->m_sections = std::move(m_sections);
+    state->m_sharedObjectIds = std::move(m_storageIndices);
+    if (m_loading) {
+        for (const std::shared_ptr<void> &object : m_loaded) {
+            if (object)
+                state->m_sharedObjects.push_back(object);
+        }
+        state->m_strings = std::move(m_stringStorage);
+        state->m_envs = std::move(m_envStorage);
+        state->m_stringLists = std::move(m_stringListStorage);
+    } else {
+        state->m_sharedObjects = std::move(m_storedSharedObjects);
+        state->m_strings = valuesById(m_inverseStringStorage, m_lastStoredStringId);
+        state->m_envs = valuesById(m_inverseEnvStorage, m_lastStoredEnvId);
+        state->m_stringLists = valuesById(m_inverseStringListStorage, m_lastStoredStringListId);
+    }
+    qCDebug(lcBuildGraph) << "state of" << m_filePath << "holds" << state->m_sections.size()
+                          << "sections," << state->m_sharedObjectIds.size() << "shared objects,"
+                          << state->m_strings.size() << "strings," << state->m_envs.size()
+                          << "environments and" << state->m_stringLists.size()
+                          << "string lists";
+    clear();
+    m_sections.clear();
+    m_loadedRaw.clear();
+    m_storedPersistentObjects.clear();
+    m_envStorage.clear();
+    m_inverseEnvStorage.clear();
+    m_stringListStorage.clear();
+    m_inverseStringListStorage.clear();
+    return state;
+}
+
+void PersistentPool::readStringTable()
+{
+    // The data might be corrupt, so we must not trust the numbers before validating them.
+    // Every size occupies at least one byte, and every string at most what is left.
+    const auto count = readVarint();
+    QBS_CHECK(count <= quint64(m_readEnd - m_readPos));
+    std::vector<qsizetype> sizes;
+    sizes.reserve(count);
+    for (quint64 i = 0; i < count; ++i) {
+        const auto size = readVarint();
+        QBS_CHECK(size <= quint64(m_readEnd - m_readPos));
+        sizes.push_back(qsizetype(size));
+    }
+    m_stringStorage.reserve(m_stringStorage.size() + count);
+    for (const qsizetype size : sizes) {
+        m_stringStorage.push_back(QString::fromUtf8(readBytes(size), size));
+        ++m_lastStoredStringId;
     }
 }
 
 void PersistentPool::storeVariant(const QVariant &variant)
 {
     if (variant.isNull()) {
-        m_stream << quint32(QMetaType::User);
-        m_stream << variant;
+        store(quint32(QMetaType::User));
+        storeVariantWithDataStream(variant);
         return;
     }
     const auto type = static_cast<quint32>(variant.userType());
-    m_stream << type;
+    store(type);
     switch (type) {
+    case QMetaType::Bool:
+        store(variant.toBool());
+        break;
+    case QMetaType::Int:
+        store(variant.toInt());
+        break;
+    case QMetaType::LongLong:
+        store(variant.toLongLong());
+        break;
     case QMetaType::QString:
         store(variant.toString());
         break;
@@ -161,7 +538,7 @@ void PersistentPool::storeVariant(const QVariant &variant)
         store(variant.toMap());
         break;
     default:
-        m_stream << variant;
+        storeVariantWithDataStream(variant);
     }
 }
 
@@ -170,6 +547,15 @@ QVariant PersistentPool::loadVariant()
     const auto type = load<quint32>();
     QVariant value;
     switch (type) {
+    case QMetaType::Bool:
+        value = load<bool>();
+        break;
+    case QMetaType::Int:
+        value = load<int>();
+        break;
+    case QMetaType::LongLong:
+        value = load<qlonglong>();
+        break;
     case QMetaType::QString:
         value = load<QString>();
         break;
@@ -183,28 +569,46 @@ QVariant PersistentPool::loadVariant()
         value = load<QVariantMap>();
         break;
     default:
-        m_stream >> value;
+        value = loadVariantWithDataStream();
     }
     return value;
 }
 
+void PersistentPool::storeVariantWithDataStream(const QVariant &variant)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_4_8);
+    stream << variant;
+    writeVarint(data.size());
+    writeBytes(data.constData(), data.size());
+}
+
+QVariant PersistentPool::loadVariantWithDataStream()
+{
+    const auto size = qsizetype(readVarint());
+    QDataStream stream(QByteArray::fromRawData(readBytes(size), size));
+    stream.setVersion(QDataStream::Qt_4_8);
+    QVariant value;
+    stream >> value;
+    return value;
+}
+
 void PersistentPool::clear()
 {
+    m_buffer.clear();
+    m_readPos = m_readEnd = nullptr;
     m_loaded.clear();
+    m_storedSharedObjects.clear();
     m_storageIndices.clear();
     m_stringStorage.clear();
     m_inverseStringStorage.clear();
 }
 
-void PersistentPool::doLoadValue(QString &s)
-{
-    m_stream >> s;
-}
-
 void PersistentPool::doLoadValue(QStringList &l)
 {
-    int size;
-    m_stream >> size;
+    const int size = load<int>();
+    l.reserve(size);
     for (int i = 0; i < size; ++i)
         l << load<QString>();
 }
@@ -218,12 +622,12 @@ void PersistentPool::doLoadValue(QProcessEnvironment &env)
 
 void PersistentPool::doStoreValue(const QString &s)
 {
-    m_stream << s;
+    m_stringStorage.push_back(s);
 }
 
 void PersistentPool::doStoreValue(const QStringList &l)
 {
-    m_stream << int(l.size());
+    store(int(l.size()));
     for (const QString &s : l)
         store(s);
 }
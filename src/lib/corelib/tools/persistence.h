@@ -53,6 +53,7 @@
 #include <QtCore/qstringlist.h>
 #include <QtCore/qvariant.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <type_traits>
@@ -71,7 +72,25 @@ public:
 template<typename T, typename Enable = void>
 struct PPHelper;
 
-class PersistentPool
+// Base class for objects that are stored via plain pointers and can get deleted individually,
+// such as build graph nodes. They remember under which id they were last loaded or stored,
+// so that parts of a build graph file can be rewritten without identifying the objects
+// in the remaining parts by their addresses, which the allocator re-uses.
+class PersistentObject
+{
+public:
+    PersistentObject() = default;
+    PersistentObject(const PersistentObject &) {}
+    PersistentObject &operator=(const PersistentObject &) { return *this; }
+
+private:
+    friend class PersistentPool;
+
+    mutable quint32 m_persistenceGeneration = 0;
+    mutable int m_persistentId = -1;
+};
+
+class QBS_AUTOTEST_EXPORT PersistentPool
 {
 public:
     PersistentPool(Logger &logger);
@@ -112,32 +131,106 @@ public:
             load(args...);
     }
 
+    using PersistentObjectId = int;
+
+    // A build graph file consists of sections, each of which carries the strings that
+    // are first used in it. Objects are defined in the section they are first stored in and
+    // referenced by id afterwards. This makes it possible to rewrite only the trailing
+    // sections of a file, as long as nothing that was stored in the leading ones has changed.
+    // Objects held by shared pointers are identified by address and kept alive by the state,
+    // so their addresses cannot get re-used. All other objects must be PersistentObjects.
+    class StoredState
+    {
+    public:
+        int sectionCount() const { return int(m_sections.size()); }
+
+        // The section that the object is defined in, or -1.
+        int sectionOf(const PersistentObject *object) const;
+
+    private:
+        friend class PersistentPool;
+
+        struct Section
+        {
+            qint64 fileOffset = 0;
+            PersistentObjectId firstObjectId = 0;
+            PersistentObjectId firstStringId = 0;
+            PersistentObjectId firstEnvId = 0;
+            PersistentObjectId firstStringListId = 0;
+        };
+
+        QString m_filePath;
+        qint64 m_fileSize = 0;
+        quint32 m_generation = 0;
+        std::vector<Section> m_sections;
+        std::unordered_map<const void *, PersistentObjectId> m_sharedObjectIds;
+        std::vector<std::shared_ptr<const void>> m_sharedObjects;
+
+        // Indexed by id. The look-up tables needed for storing are only created when
+        // the file actually gets rewritten.
+        std::vector<QString> m_strings;
+        std::vector<QProcessEnvironment> m_envs;
+        std::vector<QStringList> m_stringLists;
+    };
+
     void load(const QString &filePath);
     void setupWriteStream(const QString &filePath);
+
+    // Prepares for rewriting the sections starting at firstSection of a file that was loaded
+    // or stored with the given state. Returns false if the file does not match the state,
+    // in which case the complete file has to be written.
+    bool setupWriteStream(const QString &filePath, StoredState &&state, int firstSection);
+    void beginSection();
     void finalizeWriteStream();
+
+    // Hands the serialized data over to a background thread that writes the file.
+    // Subsequent loads and stores of the same file, as well as the destruction of the
+    // corresponding BuildGraphLocker, wait for the write to finish.
+    void finalizeWriteStreamInBackground();
+
+    // Returns the error of a failed background write of the file. The error is returned
+    // to only one caller, which is responsible for reporting it.
+    static ErrorInfo waitForBackgroundWrite(const QString &filePath);
     void clear();
 
+    // Available after the file has been completely loaded or stored.
+    std::unique_ptr<StoredState> takeStoredState();
+
     const HeadData &headData() const { return m_headData; }
     void setHeadData(const HeadData &hd) { m_headData = hd; }
 
 private:
-    using PersistentObjectId = int;
-
     template <typename T> T *idLoad();
     template <class T> std::shared_ptr<T> idLoadS();
     template <typename T> T idLoadValue();
 
-    void doLoadValue(QString &s);
     void doLoadValue(QStringList &l);
     void doLoadValue(QProcessEnvironment &env);
 
-    template<typename T> void storeSharedObject(const T *object);
+    template<typename T> void storeSharedObject(const T *object,
+                                                const std::shared_ptr<const void> &owner = {});
+    static quint32 nextGeneration();
 
     void storeVariant(const QVariant &variant);
     QVariant loadVariant();
+    void storeVariantWithDataStream(const QVariant &variant);
+    QVariant loadVariantWithDataStream();
 
     template <typename T> void idStoreValue(const T &value);
 
+    template<typename T> void storeInteger(T value);
+    template<typename T> T loadInteger();
+    void writeVarint(quint64 value);
+    quint64 readVarint();
+    void writeBytes(const char *data, qsizetype size) { m_buffer.append(data, size); }
+    const char *readBytes(qsizetype size);
+    void readStringTable();
+    QByteArray takeSections();
+    void finishBackgroundWrite(const QString &filePath);
+
+    class BuildGraphFileWrite;
+    BuildGraphFileWrite prepareFileWrite();
+
     void doStoreValue(const QString &s);
     void doStoreValue(const QStringList &l);
     void doStoreValue(const QProcessEnvironment &env);
@@ -150,12 +243,30 @@ private:
     static const inline PersistentObjectId EmptyValueId = -2;
     static const inline PersistentObjectId NullValueId = -3;
 
-    std::unique_ptr<QIODevice> m_file;
-    QDataStream m_stream;
+    QString m_filePath;
+    bool m_loading = false;
+
+    // When storing, the serialized data apart from the string tables, which are put
+    // in front of the respective sections by finalizeWriteStream().
+    // When loading, the complete file contents.
+    QByteArray m_buffer;
+    const char *m_readPos = nullptr;
+    const char *m_readEnd = nullptr;
+
+    std::vector<StoredState::Section> m_sections;
+    std::vector<qsizetype> m_sectionBodyOffsets; // Into m_buffer, for the sections being stored.
+    int m_firstStoredSection = 0;
+    quint32 m_generation = 0;
+    qint64 m_rewriteOffset = -1; // Where the sections being stored start, if not a new file.
+    qint64 m_fileSize = 0;
+
     HeadData m_headData;
     std::vector<void *> m_loadedRaw;
     std::vector<std::shared_ptr<void>> m_loaded;
-    std::unordered_map<const void*, int> m_storageIndices;
+    std::vector<std::shared_ptr<const void>> m_storedSharedObjects;
+    std::unordered_map<const void *, PersistentObjectId> m_storageIndices;
+    std::unordered_map<const PersistentObject *, PersistentObjectId> m_storedPersistentObjects;
+    PersistentObjectId m_firstStoredObjectId = 0;
     PersistentObjectId m_lastStoredObjectId = 0;
 
     std::vector<QString> m_stringStorage;
@@ -175,28 +286,55 @@ private:
 
 template<typename T> inline const void *uniqueAddress(const T *t) { return t; }
 
-template<typename T> inline void PersistentPool::storeSharedObject(const T *object)
+template<typename T> inline void PersistentPool::storeSharedObject(
+        const T *object, const std::shared_ptr<const void> &owner)
 {
     if (!object) {
-        m_stream << -1;
+        storeInteger<PersistentObjectId>(-1);
         return;
     }
-    const void * const addr = uniqueAddress(object);
-    const auto found = m_storageIndices.find(addr);
-    if (found == m_storageIndices.end()) {
-        PersistentObjectId id = m_lastStoredObjectId++;
-        m_storageIndices[addr] = id;
-        m_stream << id;
+    if constexpr (std::is_base_of_v<PersistentObject, T>) {
+        const auto persistentObject = static_cast<const PersistentObject *>(object);
+        const auto found = m_storedPersistentObjects.find(persistentObject);
+        if (found != m_storedPersistentObjects.end()) {
+            storeInteger(found->second);
+            return;
+        }
+
+        // Defined in one of the sections that are not rewritten.
+        if (persistentObject->m_persistenceGeneration == m_generation
+                && persistentObject->m_persistentId >= 0
+                && persistentObject->m_persistentId < m_firstStoredObjectId) {
+            m_storedPersistentObjects.emplace(persistentObject, persistentObject->m_persistentId);
+            storeInteger(persistentObject->m_persistentId);
+            return;
+        }
+
+        const PersistentObjectId id = m_lastStoredObjectId++;
+        m_storedPersistentObjects.emplace(persistentObject, id);
+        persistentObject->m_persistenceGeneration = m_generation;
+        persistentObject->m_persistentId = id;
+        storeInteger(id);
         store(*object);
     } else {
-        m_stream << found->second;
+        const void * const addr = uniqueAddress(object);
+        const auto found = m_storageIndices.find(addr);
+        if (found == m_storageIndices.end()) {
+            PersistentObjectId id = m_lastStoredObjectId++;
+            m_storageIndices[addr] = id;
+            if (owner)
+                m_storedSharedObjects.push_back(owner);
+            storeInteger(id);
+            store(*object);
+        } else {
+            storeInteger(found->second);
+        }
     }
 }
 
 template <typename T> inline T *PersistentPool::idLoad()
 {
-    PersistentObjectId id;
-    m_stream >> id;
+    const auto id = loadInteger<PersistentObjectId>();
 
     if (id < 0)
         return nullptr;
@@ -211,6 +349,14 @@ template <typename T> inline T *PersistentPool::idLoad()
 
     const auto t = new T;
     m_loadedRaw[id] = t;
+    if constexpr (std::is_base_of_v<PersistentObject, T>) {
+        const auto persistentObject = static_cast<const PersistentObject *>(t);
+        persistentObject->m_persistenceGeneration = m_generation;
+        persistentObject->m_persistentId = id;
+    } else {
+        m_storageIndices[uniqueAddress(t)] = id;
+    }
+    m_lastStoredObjectId = std::max(m_lastStoredObjectId, id + 1);
     load(*t);
     return t;
 }
@@ -253,8 +399,7 @@ template<> inline PersistentPool::PersistentObjectId
 
 template <class T> inline std::shared_ptr<T> PersistentPool::idLoadS()
 {
-    PersistentObjectId id;
-    m_stream >> id;
+    const auto id = loadInteger<PersistentObjectId>();
 
     if (id < 0)
         return std::shared_ptr<T>();
@@ -265,14 +410,15 @@ template <class T> inline std::shared_ptr<T> PersistentPool::idLoadS()
     m_loaded.resize(id + 1);
     const std::shared_ptr<T> t = T::create();
     m_loaded[id] = t;
+    m_storageIndices[uniqueAddress(t.get())] = id;
+    m_lastStoredObjectId = std::max(m_lastStoredObjectId, id + 1);
     load(*t);
     return t;
 }
 
 template<typename T> inline T PersistentPool::idLoadValue()
 {
-    int id;
-    m_stream >> id;
+    const auto id = loadInteger<PersistentObjectId>();
     if (id == NullValueId)
         return T();
     if (id == EmptyValueId) {
@@ -281,14 +427,22 @@ template<typename T> inline T PersistentPool::idLoadValue()
         return T();
     }
     QBS_CHECK(id >= 0);
-    if (id >= static_cast<int>(idStorage<T>().size())) {
-        T value;
-        doLoadValue(value);
-        idStorage<T>().resize(id + 1);
-        idStorage<T>()[id] = value;
-        return value;
-    }
-    return idStorage<T>().at(id);
+
+    // Strings come from the string table, which was read up front.
+    if constexpr (std::is_same_v<T, QString>) {
+        QBS_CHECK(id < static_cast<int>(m_stringStorage.size()));
+        return m_stringStorage[id];
+    } else {
+        if (id >= static_cast<int>(idStorage<T>().size())) {
+            T value;
+            doLoadValue(value);
+            idStorage<T>().resize(id + 1);
+            idStorage<T>()[id] = value;
+            lastStoredId<T>() = id + 1;
+            return value;
+        }
+        return idStorage<T>().at(id);
+    }
 }
 
 template<typename T>
@@ -296,23 +450,88 @@ void PersistentPool::idStoreValue(const T &value)
 {
     if constexpr (std::is_same_v<T, QString>) {
         if (value.isNull()) {
-            m_stream << NullValueId;
+            storeInteger(NullValueId);
             return;
         }
     }
     if (value.isEmpty()) {
-        m_stream << EmptyValueId;
+        storeInteger(EmptyValueId);
         return;
     }
     int id = idMap<T>().value(value, ValueNotFoundId);
     if (id < 0) {
         id = lastStoredId<T>()++;
         idMap<T>().insert(value, id);
-        m_stream << id;
+        storeInteger(id);
         doStoreValue(value);
     } else {
-        m_stream << id;
+        storeInteger(id);
+    }
+}
+
+// Integers are written as LEB128 varints, signed ones zigzag-encoded, so that the
+// typically small values and ids take only one or two bytes.
+template<typename T> inline void PersistentPool::storeInteger(T value)
+{
+    if constexpr (sizeof(T) == 1) {
+        m_buffer.append(char(value));
+    } else if constexpr (std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        writeVarint(U(U(value) << 1) ^ U(value >> (sizeof(T) * 8 - 1)));
+    } else {
+        writeVarint(value);
+    }
+}
+
+template<typename T> inline T PersistentPool::loadInteger()
+{
+    if constexpr (sizeof(T) == 1) {
+        return T(*readBytes(1));
+    } else if constexpr (std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        const auto u = U(readVarint());
+        return T((u >> 1) ^ (~(u & 1) + 1));
+    } else {
+        return T(readVarint());
+    }
+}
+
+inline void appendVarint(QByteArray &data, quint64 value)
+{
+    char bytes[10];
+    int count = 0;
+    while (value >= 0x80) {
+        bytes[count++] = char(value | 0x80);
+        value >>= 7;
     }
+    bytes[count++] = char(value);
+    data.append(bytes, count);
+}
+
+inline void PersistentPool::writeVarint(quint64 value)
+{
+    appendVarint(m_buffer, value);
+}
+
+inline quint64 PersistentPool::readVarint()
+{
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const auto byte = quint8(*readBytes(1));
+        value |= quint64(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+    QBS_CHECK(false);
+    return value;
+}
+
+inline const char *PersistentPool::readBytes(qsizetype size)
+{
+    QBS_CHECK(size >= 0 && m_readEnd - m_readPos >= size);
+    const char * const data = m_readPos;
+    m_readPos += size;
+    return data;
 }
 
 // We need a helper class template, because we require partial specialization for some of
@@ -350,19 +569,8 @@ struct PPHelper<T, std::enable_if_t<std::is_member_function_pointer_v<
 
 template<typename T> struct PPHelper<T, std::enable_if_t<std::is_integral_v<T>>>
 {
-    static void store(const T &value, PersistentPool *pool) { pool->m_stream << value; }
-    static void load(T &value, PersistentPool *pool) { pool->m_stream >> value; }
-};
-
-template<> struct PPHelper<long>
-{
-    static void store(long value, PersistentPool *pool) { pool->m_stream << qint64(value); }
-    static void load(long &value, PersistentPool *pool)
-    {
-        qint64 v;
-        pool->m_stream >> v;
-        value = long(v);
-    }
+    static void store(const T &value, PersistentPool *pool) { pool->storeInteger(value); }
+    static void load(T &value, PersistentPool *pool) { value = pool->loadInteger<T>(); }
 };
 
 template<typename T> struct PPHelper<T, std::enable_if_t<std::is_enum_v<T>>>
@@ -370,11 +578,11 @@ template<typename T> struct PPHelper<T, std::enable_if_t<std::is_enum_v<T>>>
     using U = std::underlying_type_t<T>;
     static void store(const T &value, PersistentPool *pool)
     {
-        pool->m_stream << static_cast<U>(value);
+        pool->storeInteger(static_cast<U>(value));
     }
     static void load(T &value, PersistentPool *pool)
     {
-        pool->m_stream >> reinterpret_cast<U &>(value);
+        value = static_cast<T>(pool->loadInteger<U>());
     }
 };
 
@@ -382,7 +590,7 @@ template<typename T> struct PPHelper<std::shared_ptr<T>>
 {
     static void store(const std::shared_ptr<T> &value, PersistentPool *pool)
     {
-        pool->store(value.get());
+        pool->storeSharedObject(value.get(), value);
     }
     static void load(std::shared_ptr<T> &value, PersistentPool *pool)
     {
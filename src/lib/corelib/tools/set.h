@@ -40,6 +40,7 @@
 #ifndef QBS_SET_H
 #define QBS_SET_H
 
+#include <tools/chunkedvector.h>
 #include <tools/dynamictypecheck.h>
 #include <tools/persistence.h>
 #include <tools/stlutils.h>
@@ -55,6 +56,7 @@
 #include <memory>
 #include <set>
 #include <type_traits>
+#include <vector>
 
 namespace qbs {
 namespace Internal {
@@ -67,22 +69,29 @@ namespace helper {
 template<typename T> struct SortAfterLoad { static const bool required = false; };
 template<typename T> struct SortAfterLoad<T *> { static const bool required = true; };
 template<typename T> struct SortAfterLoad<std::shared_ptr<T>> { static const bool required = true; };
+
+// Sets of pointers hold build graph nodes and artifacts, of which a product can have
+// tens of thousands, so insertion and removal must not be linear in the set size.
+template<typename T> struct Storage { using type = std::vector<T>; };
+template<typename T> struct Storage<T *> { using type = ChunkedVector<T *>; };
 }
 
 template<typename T> class Set
 {
+    using Storage = typename helper::Storage<T>::type;
+
 public:
-    using const_iterator = typename std::vector<T>::const_iterator;
-    using iterator = typename std::vector<T>::iterator;
-    using reverse_iterator = typename std::vector<T>::reverse_iterator;
-    using const_reverse_iterator = typename std::vector<T>::const_reverse_iterator;
-    using size_type = typename std::vector<T>::size_type;
+    using const_iterator = typename Storage::const_iterator;
+    using iterator = typename Storage::iterator;
+    using reverse_iterator = typename Storage::reverse_iterator;
+    using const_reverse_iterator = typename Storage::const_reverse_iterator;
+    using size_type = typename Storage::size_type;
     using value_type = T;
-    using difference_type = typename std::vector<T>::difference_type;
-    using pointer = typename std::vector<T>::pointer;
-    using const_pointer = typename std::vector<T>::const_pointer;
-    using reference = typename std::vector<T>::reference;
-    using const_reference = typename std::vector<T>::const_reference;
+    using difference_type = typename Storage::difference_type;
+    using pointer = typename Storage::pointer;
+    using const_pointer = typename Storage::const_pointer;
+    using reference = typename Storage::reference;
+    using const_reference = typename Storage::const_reference;
 
     iterator begin() { return m_data.begin(); }
     iterator end() { return m_data.end(); }
@@ -163,7 +172,7 @@ private:
     bool sortAfterLoadRequired() const { return helper::SortAfterLoad<T>::required; }
     iterator asMutableIterator(const_iterator cit);
 
-    std::vector<T> m_data;
+    Storage m_data;
 };
 
 template<typename T> Set<T>::Set(const std::initializer_list<T> &list) : m_data(list)
@@ -99,6 +99,7 @@ public:
     bool logElapsedTime;
     bool forceProbeExecution;
     bool waitLockBuildGraph;
+    bool storeBuildGraphInBackground = false;
     SetupProjectParameters::RestoreBehavior restoreBehavior;
     ErrorHandlingMode propertyCheckingMode;
     ErrorHandlingMode productErrorMode;
@@ -165,6 +166,8 @@ SetupProjectParameters SetupProjectParameters::fromJson(const QJsonObject &data)
     setValueFromJson(params.d->logElapsedTime, data, "log-time");
     setValueFromJson(params.d->forceProbeExecution, data, "force-probe-execution");
     setValueFromJson(params.d->waitLockBuildGraph, data, "wait-lock-build-graph");
+    setValueFromJson(params.d->storeBuildGraphInBackground, data,
+                     "store-build-graph-in-background");
     setValueFromJson(params.d->environment, data, "environment");
     setValueFromJson(params.d->restoreBehavior, data, "restore-behavior");
     setValueFromJson(params.d->propertyCheckingMode, data, "error-handling-mode");
@@ -620,6 +623,24 @@ void SetupProjectParameters::setWaitLockBuildGraph(bool wait)
     d->waitLockBuildGraph = wait;
 }
 
+/*!
+ * \brief Returns true iff the build graph is written to disk in a background thread.
+ */
+bool SetupProjectParameters::storeBuildGraphInBackground() const
+{
+    return d->storeBuildGraphInBackground;
+}
+
+/*!
+ * Controls whether the resolve job finishes before the build graph file has been written.
+ * The build graph stays locked until the file has been written.
+ * The default is false.
+ */
+void SetupProjectParameters::setStoreBuildGraphInBackground(bool inBackground)
+{
+    d->storeBuildGraphInBackground = inBackground;
+}
+
 /*!
  * \brief Gets the environment used while resolving the project.
  */
@@ -132,6 +132,9 @@ public:
     bool waitLockBuildGraph() const;
     void setWaitLockBuildGraph(bool wait);
 
+    bool storeBuildGraphInBackground() const;
+    void setStoreBuildGraphInBackground(bool inBackground);
+
     QProcessEnvironment environment() const;
     void setEnvironment(const QProcessEnvironment &env);
     QProcessEnvironment adjustedEnvironment() const;
@@ -0,0 +1,92 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_SHARDEDMAP_H
+#define QBS_SHARDEDMAP_H
+
+#include <QtCore/qhash.h>
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace qbs {
+namespace Internal {
+
+// A map for read-mostly data that is accessed from many threads.
+// The keys are distributed over a number of independently locked shards, and look-ups
+// of existing entries take only a shared lock, so concurrent readers do not block each other.
+// Entries are never removed, so references to them stay valid for the lifetime of the map.
+// Synchronizing the access to the values themselves is up to the user.
+template<typename Key, typename Value, int ShardCount = 32>
+class ShardedMap
+{
+public:
+    // Returns the value for the key, default-constructing it if it does not exist yet.
+    Value &operator[](const Key &key)
+    {
+        Shard &shard = m_shards[qHash(key) % ShardCount];
+        {
+            std::shared_lock lock(shard.mutex);
+            const auto it = shard.values.find(key);
+            if (it != shard.values.end())
+                return *it->second;
+        }
+        std::unique_lock lock(shard.mutex);
+        std::unique_ptr<Value> &value = shard.values[key];
+        if (!value)
+            value = std::make_unique<Value>();
+        return *value;
+    }
+
+private:
+    struct Shard
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<Key, std::unique_ptr<Value>> values;
+    };
+    std::array<Shard, ShardCount> m_shards;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_SHARDEDMAP_H
@@ -0,0 +1,235 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "threadpool.h"
+
+#include <algorithm>
+#include <exception>
+
+namespace qbs {
+namespace Internal {
+
+static thread_local const ThreadPool *currentPool = nullptr;
+static thread_local int currentWorkerIndex = -1;
+
+ThreadPool::ThreadPool(int maxThreadCount) : m_workers(maxWorkerCount)
+{
+    if (maxThreadCount <= 0)
+        maxThreadCount = int(std::thread::hardware_concurrency());
+    m_threadCount = std::clamp(maxThreadCount, 1, maxWorkerCount);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_wakeUp.notify_all();
+    for (int i = 0; i < m_startedWorkerCount; ++i)
+        m_workers.at(i)->thread.join();
+}
+
+ThreadPool &ThreadPool::globalInstance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool &ThreadPool::ioInstance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::setMaxThreadCount(int count)
+{
+    {
+        // Sleeping workers check the count under this lock.
+        std::lock_guard lock(m_sleepMutex);
+        m_threadCount = std::clamp(count, 1, maxWorkerCount);
+    }
+    m_wakeUp.notify_all();
+}
+
+bool ThreadPool::isWorkerThread() const
+{
+    return currentPool == this;
+}
+
+void ThreadPool::enqueue(Task task)
+{
+    const int threadCount = m_threadCount;
+    if (m_startedWorkerCount < threadCount)
+        startWorkers(threadCount);
+
+    const int index = isWorkerThread() && currentWorkerIndex < threadCount
+            ? currentWorkerIndex : int(m_nextQueue++ % threadCount);
+    {
+        Worker &worker = *m_workers.at(index);
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard lock(m_sleepMutex);
+        ++m_pendingTaskCount;
+    }
+
+    // Idle workers beyond the thread count would swallow a single notification.
+    if (m_startedWorkerCount > m_threadCount)
+        m_wakeUp.notify_all();
+    else
+        m_wakeUp.notify_one();
+}
+
+void ThreadPool::startWorkers(int count)
+{
+    // If thread creation fails half-way, the exception propagates to the caller
+    // and the next enqueue() will retry for the workers that are not running yet.
+    std::lock_guard lock(m_startMutex);
+    for (int i = m_startedWorkerCount; i < count; ++i) {
+        if (!m_workers.at(i))
+            m_workers.at(i) = std::make_unique<Worker>();
+        m_workers.at(i)->thread = std::thread([this, i] { workerLoop(i); });
+        m_startedWorkerCount = i + 1;
+    }
+}
+
+void ThreadPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorkerIndex = index;
+    while (true) {
+        Task task;
+        if (index < m_threadCount && takeTask(index, task)) {
+            task();
+            continue;
+        }
+        std::unique_lock lock(m_sleepMutex);
+        m_wakeUp.wait(lock, [this, index] {
+            return m_stopping || (m_pendingTaskCount > 0 && index < m_threadCount);
+        });
+        if (m_stopping && (m_pendingTaskCount <= 0 || index >= m_threadCount))
+            return;
+    }
+}
+
+bool ThreadPool::takeTask(int preferredIndex, Task &task)
+{
+    // Own queue first, newest task first for locality ...
+    if (preferredIndex >= 0) {
+        Worker &worker = *m_workers.at(preferredIndex);
+        std::lock_guard lock(worker.mutex);
+        if (!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+            --m_pendingTaskCount;
+            return true;
+        }
+    }
+
+    // ... then steal the oldest task from some other worker, including idle ones.
+    const int workerCount = m_startedWorkerCount;
+    const int start = preferredIndex >= 0 ? preferredIndex + 1 : 0;
+    for (int i = 0; i < workerCount; ++i) {
+        const int victimIndex = (start + i) % workerCount;
+        if (victimIndex == preferredIndex)
+            continue;
+        Worker &victim = *m_workers.at(victimIndex);
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --m_pendingTaskCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::runChunks(int chunkCount, const std::function<void(int)> &runChunk)
+{
+    if (chunkCount <= 0)
+        return;
+
+    // Helper tasks can start after the batch is done, so they own the state. They only
+    // touch runChunk after having claimed a chunk, which the caller is still waiting for.
+    struct Batch
+    {
+        const std::function<void(int)> *runChunk = nullptr;
+        int chunkCount = 0;
+        std::atomic<int> nextChunk = 0;
+        std::mutex mutex;
+        std::condition_variable allDone;
+        int finishedChunks = 0;
+        std::exception_ptr error;
+    };
+    const auto batch = std::make_shared<Batch>();
+    batch->runChunk = &runChunk;
+    batch->chunkCount = chunkCount;
+    const auto work = [](Batch &batch) {
+        for (int chunk = batch.nextChunk++; chunk < batch.chunkCount; chunk = batch.nextChunk++) {
+            std::exception_ptr error;
+            try {
+                (*batch.runChunk)(chunk);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard lock(batch.mutex);
+            if (error && !batch.error)
+                batch.error = error;
+            if (++batch.finishedChunks == batch.chunkCount)
+                batch.allDone.notify_all();
+        }
+    };
+
+    const int helperCount = std::min(chunkCount - 1, maxThreadCount());
+    for (int i = 0; i < helperCount; ++i)
+        enqueue([batch, work] { work(*batch); });
+    work(*batch);
+
+    // All chunks are claimed at this point, so we only wait for ones that are being executed.
+    std::unique_lock lock(batch->mutex);
+    batch->allDone.wait(lock, [&batch] { return batch->finishedChunks == batch->chunkCount; });
+    if (batch->error)
+        std::rethrow_exception(batch->error);
+}
+
+} // namespace Internal
+} // namespace qbs
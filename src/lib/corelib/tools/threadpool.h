@@ -0,0 +1,163 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBS_THREADPOOL_H
+#define QBS_THREADPOOL_H
+
+#include "qbs_export.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace qbs {
+namespace Internal {
+
+// A work-stealing pool of worker threads. Each worker owns a task queue; tasks submitted
+// from a worker go to that worker's queue, all others are distributed round-robin.
+// Idle workers steal from the other queues. Threads are started lazily on first use and
+// live as long as the pool, so back-to-back resolves and builds do not pay for thread creation.
+// The number of workers that run tasks can be changed at any time, so that the pool can follow
+// the job count of the current resolve or build.
+// Tasks must not block on the completion of other tasks in the same pool; they can use
+// mapped() or runChunks() instead, where the waiting thread works on the batch itself.
+class QBS_AUTOTEST_EXPORT ThreadPool
+{
+public:
+    explicit ThreadPool(int maxThreadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // The pool shared by the loader and the executor. Its thread count is the job count
+    // of the resolve or build that was started last.
+    static ThreadPool &globalInstance();
+
+    // For blocking file operations requested by scripts, which thus neither queue up behind
+    // nor hold up the resolving and command tasks of the global pool.
+    static ThreadPool &ioInstance();
+
+    // Workers beyond the new count finish their current task and then stay idle.
+    // Their queued tasks get picked up by the others.
+    void setMaxThreadCount(int count);
+    int maxThreadCount() const { return m_threadCount; }
+    bool isWorkerThread() const;
+
+    template<typename F> auto run(F &&f) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        const auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+        std::future<Result> future = task->get_future();
+        enqueue([task] { (*task)(); });
+        return future;
+    }
+
+    // Calls runChunk for all chunk indexes from 0 to chunkCount - 1. Idle workers help out,
+    // while the calling thread works on the chunks itself and never picks up unrelated tasks,
+    // so this can be used from within pool tasks, even in the middle of a script evaluation.
+    // If runChunk throws, the first exception is rethrown once all chunks have finished.
+    void runChunks(int chunkCount, const std::function<void(int)> &runChunk);
+
+    // Applies f to all items, distributing them over the pool in chunks of the given size.
+    // The results are in the order of the items. See runChunks() for the details.
+    template<typename Container, typename F> auto mapped(const Container &items, const F &f,
+                                                         int chunkSize = 16)
+    {
+        using Result = std::decay_t<decltype(f(items.at(0)))>;
+        const int count = int(items.size());
+        const int chunkCount = (count + chunkSize - 1) / chunkSize;
+        std::vector<std::vector<Result>> chunkResults(chunkCount);
+        runChunks(chunkCount, [&](int chunk) {
+            const int begin = chunk * chunkSize;
+            const int end = std::min(count, begin + chunkSize);
+            std::vector<Result> &results = chunkResults.at(chunk);
+            results.reserve(end - begin);
+            for (int i = begin; i < end; ++i)
+                results.push_back(f(items.at(i)));
+        });
+        std::vector<Result> results;
+        results.reserve(count);
+        for (auto &chunk : chunkResults) {
+            for (auto &&result : chunk)
+                results.push_back(std::move(result));
+        }
+        return results;
+    }
+
+private:
+    using Task = std::function<void()>;
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void enqueue(Task task);
+    void startWorkers(int count);
+    void workerLoop(int index);
+    bool takeTask(int preferredIndex, Task &task);
+
+    static constexpr int maxWorkerCount = 1024;
+
+    // Has maxWorkerCount entries, which get filled when the respective workers are started.
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<int> m_threadCount = 0;
+    std::atomic<int> m_startedWorkerCount = 0;
+    std::mutex m_startMutex;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+    std::atomic<int> m_pendingTaskCount = 0;
+    std::atomic<unsigned int> m_nextQueue = 0;
+    bool m_stopping = false;
+};
+
+} // namespace Internal
+} // namespace qbs
+
+#endif // QBS_THREADPOOL_H
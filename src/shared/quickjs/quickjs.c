@@ -56152,6 +56152,31 @@ int isSimpleValue(JSValue v)
     return p->class_id >= JS_CLASS_OBJECT && p->class_id <= JS_CLASS_BOOLEAN;
 }
 
+JSValue evalFunctionWithThis(JSContext *ctx, JSValue fun_obj, JSValueConst this_obj)
+{
+    return JS_EvalFunctionInternal(ctx, fun_obj, this_obj, NULL, NULL);
+}
+
+#define QBS_STRINGIFY_HELPER(x) #x
+#define QBS_STRINGIFY(x) QBS_STRINGIFY_HELPER(x)
+
+const char *byteCodeFormatId(void)
+{
+    return CONFIG_VERSION "-bc" QBS_STRINGIFY(BC_VERSION)
+#ifdef JS_PTR64
+            "-ptr64"
+#else
+            "-ptr32"
+#endif
+#ifdef JS_NAN_BOXING
+            "-nanboxing"
+#endif
+#ifdef DUMP_LEAKS
+            "-dumpleaks"
+#endif
+            ;
+}
+
 JSValue JS_NewCFunctionMagic(JSContext *ctx, JSCFunctionMagic *func,
                              const char *name, int length,
                              JSCFunctionEnum cproto, int magic)
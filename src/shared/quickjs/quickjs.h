@@ -1048,6 +1048,13 @@ void setFunctionEnteredHandler(JSContext *ctx, FunctionEnteredHandler *handler);
 void setFunctionExitedHandler(JSContext *ctx, FunctionExitedHandler *handler);
 int isSimpleValue(JSValue v);
 
+/* Like JS_EvalFunction(), but with an explicit 'this' object, as in JS_EvalThis(). */
+JSValue evalFunctionWithThis(JSContext *ctx, JSValue fun_obj, JSValueConst this_obj);
+
+/* Identifies the format of the data written by JS_WriteObject(), which depends on the
+   engine version and the build configuration. */
+const char *byteCodeFormatId(void);
+
 #ifndef NDEBUG
 void watchRefCount(void *p);
 #endif
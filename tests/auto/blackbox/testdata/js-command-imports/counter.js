@@ -0,0 +1,6 @@
+var count = 0;
+
+function next()
+{
+    return ++count;
+}
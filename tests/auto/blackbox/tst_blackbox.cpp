@@ -2069,6 +2069,44 @@ void TestBlackbox::conflictingPropertyValues()
     }
 }
 
+void TestBlackbox::corruptBytecodeCache()
+{
+    QDir::setCurrent(testDataDir + "/corrupt-bytecode-cache");
+    const QString cacheDir = relativeBuildDir() + "/jsbytecode";
+    const QString savedCacheDir = QDir::currentPath() + "/saved-bytecode-cache";
+    rmDirR(relativeBuildDir());
+    rmDirR(savedCacheDir);
+    QCOMPARE(runQbs(), 0);
+    QVERIFY2(m_qbsStdout.contains("The answer is 42"), m_qbsStdout.constData());
+    const QFileInfoList cacheFiles = QDir(cacheDir).entryInfoList(QDir::Files);
+    QVERIFY(!cacheFiles.isEmpty());
+
+    // Truncated and garbled cache files must be ignored rather than fed to the engine.
+    for (const bool truncate : {true, false}) {
+        for (const QFileInfo &fi : cacheFiles) {
+            QFile f(fi.filePath());
+            QVERIFY2(f.open(QIODevice::ReadWrite), qPrintable(f.errorString()));
+            if (truncate) {
+                QVERIFY(f.resize(f.size() / 2));
+            } else {
+                QByteArray contents = f.readAll();
+                for (qsizetype i = contents.size() / 2; i < contents.size(); ++i)
+                    contents[i] = char(~contents.at(i));
+                QVERIFY(f.seek(0));
+                QCOMPARE(f.write(contents), qint64(contents.size()));
+            }
+        }
+
+        // Start from scratch, but with the damaged cache in place.
+        QVERIFY(QDir().rename(cacheDir, savedCacheDir));
+        rmDirR(relativeBuildDir());
+        QVERIFY(QDir().mkpath(relativeBuildDir()));
+        QVERIFY(QDir().rename(savedCacheDir, cacheDir));
+        QCOMPARE(runQbs(), 0);
+        QVERIFY2(m_qbsStdout.contains("The answer is 42"), m_qbsStdout.constData());
+    }
+}
+
 void TestBlackbox::cpuFeatures()
 {
     QDir::setCurrent(testDataDir + "/cpu-features");
@@ -5216,6 +5254,19 @@ void TestBlackbox::compilerDefinesByLanguage()
     QCOMPARE(runQbs(params), 0);
 }
 
+void TestBlackbox::jsCommandImports()
+{
+    QDir::setCurrent(testDataDir + "/js-command-imports");
+    QCOMPARE(runQbs(), 0);
+
+    // Consecutive commands of a product share the state of their imports,
+    // but not properties added to the product object.
+    QVERIFY2(m_qbsStdout.contains("call number 1, leftover: undefined"),
+             m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("call number 3, leftover: undefined"),
+             m_qbsStdout.constData());
+}
+
 void TestBlackbox::jsExtensionsFile()
 {
     QDir::setCurrent(testDataDir + "/jsextensions-file");
@@ -5397,6 +5448,11 @@ void TestBlackbox::jsExtensionsTextFile()
     QCOMPARE(lines.at(3).trimmed().constData(), "Third line.");
     QCOMPARE(lines.at(4).trimmed().constData(), qPrintable(QDir::currentPath() + "/file1.txt"));
     QCOMPARE(lines.at(5).trimmed().constData(), "true");
+
+    // Reading drops all carriage returns, not just the ones at the end of a line.
+    QFile file4("file4.txt");
+    QVERIFY(file4.open(QIODevice::ReadOnly));
+    QCOMPARE(file4.readAll(), QByteArray("[\"ab\",\"c\"]\"ab\\nc\""));
 }
 
 void TestBlackbox::jsExtensionsBinaryFile()
@@ -5425,6 +5481,9 @@ void TestBlackbox::jsExtensionsBinaryFile()
     QVERIFY(destination2.exists());
     QVERIFY(destination2.open(QIODevice::ReadOnly));
     QCOMPARE(destination2.readAll(), data);
+    QFile destination3("destination3.dat");
+    QVERIFY(destination3.open(QIODevice::ReadOnly));
+    QCOMPARE(destination3.readAll(), data.left(3) + data.left(3));
 }
 
 void TestBlackbox::lastModuleCandidateBroken()
@@ -5644,8 +5703,13 @@ void TestBlackbox::lexyaccOutputs()
     if (version >= qbs::Version(2, 6)) {
         // prefix only supported starting from bison 2.6
         QVERIFY(QDir::setCurrent(testDataDir + "/lexyacc/lex_prefix"));
+
+        // Start from scratch, but with the damaged cache in place.
+        QVERIFY(QDir().rename(cacheDir, savedCacheDir));
         rmDirR(relativeBuildDir());
-        QCOMPARE(runQbs(params), 0);
+        QVERIFY(QDir().mkpath(relativeBuildDir()));
+        QVERIFY(QDir().rename(savedCacheDir, cacheDir));
+        QCOMPARE(runQbs(), 0);
         VERIFY_COMPILATION(yaccOutputFilePath);
     }
 
@@ -5657,8 +5721,13 @@ void TestBlackbox::lexyaccOutputs()
     if (version >= qbs::Version(2, 4)) {
         // output syntax was changed in bison 2.4
         QVERIFY(QDir::setCurrent(testDataDir + "/lexyacc/yacc_output"));
+
+        // Start from scratch, but with the damaged cache in place.
+        QVERIFY(QDir().rename(cacheDir, savedCacheDir));
         rmDirR(relativeBuildDir());
-        QCOMPARE(runQbs(params), 0);
+        QVERIFY(QDir().mkpath(relativeBuildDir()));
+        QVERIFY(QDir().rename(savedCacheDir, cacheDir));
+        QCOMPARE(runQbs(), 0);
         VERIFY_COMPILATION(lexOutputFilePath);
     }
 
@@ -5899,8 +5968,13 @@ void TestBlackbox::listPropertyOrder()
     const QByteArray firstOutput = m_qbsStderr;
     QVERIFY(firstOutput.contains("listProp = [\"product\",\"higher3\",\"higher2\",\"higher1\",\"lower\"]"));
     for (int i = 0; i < 25; ++i) {
+
+        // Start from scratch, but with the damaged cache in place.
+        QVERIFY(QDir().rename(cacheDir, savedCacheDir));
         rmDirR(relativeBuildDir());
-        QCOMPARE(runQbs(params), 0);
+        QVERIFY(QDir().mkpath(relativeBuildDir()));
+        QVERIFY(QDir().rename(savedCacheDir, cacheDir));
+        QCOMPARE(runQbs(), 0);
         if (m_qbsStderr != firstOutput)
             break;
     }
@@ -8393,8 +8467,13 @@ void TestBlackbox::enableRtti()
     if (HostOsInfo::isMacosHost()) {
         params.arguments = QStringList() << "modules.cpp.enableRtti:true"
                                          << "project.treatAsObjcpp:true";
+
+        // Start from scratch, but with the damaged cache in place.
+        QVERIFY(QDir().rename(cacheDir, savedCacheDir));
         rmDirR(relativeBuildDir());
-        QCOMPARE(runQbs(params), 0);
+        QVERIFY(QDir().mkpath(relativeBuildDir()));
+        QVERIFY(QDir().rename(savedCacheDir, cacheDir));
+        QCOMPARE(runQbs(), 0);
     }
 
     params.expectFailure = true;
@@ -8639,6 +8718,67 @@ void TestBlackbox::includeLookup()
     QVERIFY2(m_qbsStdout.contains("definition.."), m_qbsStdout.constData());
 }
 
+void TestBlackbox::incrementalReResolve()
+{
+    QDir::setCurrent(testDataDir + "/incremental-re-resolve");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("0 products re-used from earlier run"),
+             m_qbsStdout.constData());
+
+    // Only the changed product is resolved again.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("a.qbs");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("2 products re-used from earlier run"),
+             m_qbsStdout.constData());
+
+    // Products depending on a changed product get resolved again too.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("b.qbs");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("1 products re-used from earlier run"),
+             m_qbsStdout.constData());
+
+    // The project file is used by all products.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("incremental-re-resolve.qbs");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("0 products re-used from earlier run"),
+             m_qbsStdout.constData());
+    QCOMPARE(runQbs(), 0);
+}
+
+void TestBlackbox::incrementalReResolveKeepsQueries()
+{
+    QDir::setCurrent(testDataDir + "/incremental-re-resolve-queries");
+    QFile::remove("marker");
+    QCOMPARE(runQbs(QbsRunParameters("resolve")), 0);
+    QVERIFY2(m_qbsStdout.contains("marker exists: false"), m_qbsStdout.constData());
+
+    // Product a is not evaluated again, so it must not lose its file system query.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("b.qbs");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("1 products re-used from earlier run"),
+             m_qbsStdout.constData());
+    QVERIFY2(!m_qbsStdout.contains("marker exists"), m_qbsStdout.constData());
+
+    // Not even after another incremental re-resolve.
+    WAIT_FOR_NEW_TIMESTAMP();
+    touch("b.qbs");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("1 products re-used from earlier run"),
+             m_qbsStdout.constData());
+
+    touch("marker");
+    QCOMPARE(runQbs(QbsRunParameters("resolve", QStringList("--log-time"))), 0);
+    QVERIFY2(m_qbsStdout.contains("Resolving"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("marker exists: true"), m_qbsStdout.constData());
+    QVERIFY2(m_qbsStdout.contains("0 products re-used from earlier run"),
+             m_qbsStdout.constData());
+    QVERIFY(QFile::remove("marker"));
+}
+
 void TestBlackbox::inputTagsChangeTracking_data()
 {
     QTest::addColumn<QString>("generateInput");
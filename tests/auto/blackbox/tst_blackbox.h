@@ -94,6 +94,7 @@ private slots:
     void conanfileProbe();
     void conflictingPropertyValues_data();
     void conflictingPropertyValues();
+    void corruptBytecodeCache();
     void cpuFeatures();
     void cxxModules_data();
     void cxxModules();
@@ -159,6 +160,8 @@ private slots:
     void importingProduct();
     void importsConflict();
     void includeLookup();
+    void incrementalReResolve();
+    void incrementalReResolveKeepsQueries();
     void inputTagsChangeTracking_data();
     void inputTagsChangeTracking();
     void inputsFromDependencies();
@@ -183,6 +186,7 @@ private slots:
     void invalidInstallDir();
     void invalidLibraryNames();
     void invalidLibraryNames_data();
+    void jsCommandImports();
     void jsExtensionsFile();
     void jsExtensionsFileInfo();
     void jsExtensionsHost();
@@ -42,12 +42,19 @@
 #include <buildgraph/artifact.h>
 #include <buildgraph/buildgraph.h>
 #include <buildgraph/cycledetector.h>
+#include <buildgraph/filedependency.h>
+#include <buildgraph/nodegraphexporter.h>
 #include <buildgraph/productbuilddata.h>
 #include <buildgraph/projectbuilddata.h>
+#include <buildgraph/reversedependencyindex.h>
 #include <language/language.h>
 #include <logging/logger.h>
 #include <tools/error.h>
 
+#include <QtCore/qbuffer.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+
 #include <QtTest/qtest.h>
 
 #include <memory>
@@ -71,10 +78,26 @@ void TestBuildGraph::cleanupTestCase()
 }
 
 
+// Creates an artifact in the product's build data. If projectBuildData is given, the
+// artifact is also added to its lookup table.
+Artifact *TestBuildGraph::createArtifact(const ResolvedProductPtr &product,
+                                         const QString &filePath, const FileTags &fileTags,
+                                         ProjectBuildData *projectBuildData)
+{
+    const auto artifact = new Artifact;
+    artifact->product = product;
+    artifact->setFilePath(filePath);
+    artifact->setFileTags(fileTags);
+    product->buildData->addNode(artifact);
+    if (projectBuildData)
+        projectBuildData->insertIntoLookupTable(artifact);
+    return artifact;
+}
+
 bool TestBuildGraph::cycleDetected(const ResolvedProductConstPtr &product)
 {
     try {
-        CycleDetector(Logger(m_logSink)).visitProduct(product);
+        CycleDetector().visitProduct(product);
         return false;
     } catch (const ErrorInfo &) {
         return true;
@@ -137,11 +160,160 @@ ResolvedProductConstPtr TestBuildGraph::productWithNoCycle()
     return product;
 }
 
+// Deep enough to overflow the stack with a recursive traversal.
+ResolvedProductConstPtr TestBuildGraph::productWithDeepChain(bool closeCycle)
+{
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->buildData = std::make_unique<ProductBuildData>();
+    Artifact *parent = nullptr;
+    Artifact *root = nullptr;
+    for (int i = 0; i < 200000; ++i) {
+        const auto artifact = new Artifact;
+        artifact->product = product;
+        product->buildData->addNode(artifact);
+        if (parent)
+            qbs::Internal::connect(parent, artifact);
+        else
+            product->buildData->addRootNode(root = artifact);
+        parent = artifact;
+    }
+    if (closeCycle)
+        qbs::Internal::connect(parent, root);
+    return product;
+}
+
 void TestBuildGraph::testCycle()
 {
     QVERIFY(cycleDetected(productWithDirectCycle()));
     QVERIFY(cycleDetected(productWithLessDirectCycle()));
     QVERIFY(!cycleDetected(productWithNoCycle()));
+    QVERIFY(!cycleDetected(productWithDeepChain(false)));
+    QVERIFY(cycleDetected(productWithDeepChain(true)));
+}
+
+void TestBuildGraph::testNodeGraphExport()
+{
+    // root -> left -> leaf, root -> right -> leaf. The tree dumper would print leaf twice.
+    const ResolvedProductPtr product = ResolvedProduct::create();
+    product->project = project;
+    product->name = QStringLiteral("p");
+    product->buildData = std::make_unique<ProductBuildData>();
+    Artifact * const root = createArtifact(product, QStringLiteral("/export/root"),
+                                           {"application"});
+    Artifact * const left = createArtifact(product, QStringLiteral("/export/left.o"), {"obj"});
+    Artifact * const right = createArtifact(product, QStringLiteral("/export/right.o"), {"obj"});
+    Artifact * const leaf = createArtifact(product, QStringLiteral("/export/leaf.h"), {"hpp"});
+    product->buildData->addRootNode(root);
+    qbs::Internal::connect(root, left);
+    qbs::Internal::connect(root, right);
+    qbs::Internal::connect(left, leaf);
+    qbs::Internal::connect(right, leaf);
+
+    const auto exportGraph = [&product](const FileTags &fileTags) {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        NodeGraphExporter(buffer, NodeGraphExporter::Format::JsonLines, fileTags)
+                .start({product});
+        QStringList nodes;
+        int edgeCount = 0;
+        for (const QByteArray &line : buffer.data().split('\n')) {
+            if (line.isEmpty())
+                continue;
+            const QJsonObject object = QJsonDocument::fromJson(line).object();
+            if (object.value(QStringLiteral("type")).toString() == QStringLiteral("node"))
+                nodes << object.value(QStringLiteral("label")).toString();
+            else
+                ++edgeCount;
+        }
+        nodes.sort();
+        return std::make_pair(nodes, edgeCount);
+    };
+
+    const auto fullGraph = exportGraph({});
+    QCOMPARE(fullGraph.first, QStringList({"/export/leaf.h", "/export/left.o",
+                                           "/export/right.o", "/export/root"}));
+    QCOMPARE(fullGraph.second, 4);
+
+    const auto filteredGraph = exportGraph({"application", "obj"});
+    QCOMPARE(filteredGraph.first, QStringList({"/export/left.o", "/export/right.o",
+                                               "/export/root"}));
+    QCOMPARE(filteredGraph.second, 2);
+}
+
+void TestBuildGraph::testReverseDependencyIndex()
+{
+    const TopLevelProjectPtr topLevelProject = TopLevelProject::create();
+    topLevelProject->buildData = std::make_unique<ProjectBuildData>();
+    const auto createProduct = [&topLevelProject] {
+        const ResolvedProductPtr product = ResolvedProduct::create();
+        product->project = topLevelProject;
+        product->buildData = std::make_unique<ProductBuildData>();
+        topLevelProject->products.push_back(product);
+        return product;
+    };
+    ProjectBuildData * const projectData = topLevelProject->buildData.get();
+    const auto dependents = [&topLevelProject](const QStringList &filePaths) {
+        QStringList result;
+        for (const Artifact * const artifact
+             : ReverseDependencyIndex(topLevelProject).dependents(filePaths)) {
+            result << artifact->filePath();
+        }
+        result.sort();
+        return result;
+    };
+
+    // lib.o includes lib.h, which is not part of the build graph. app links against liblib.a.
+    const auto header = new FileDependency;
+    header->setFilePath(QStringLiteral("/rdi/lib.h"));
+    topLevelProject->buildData->insertFileDependency(header);
+    const ResolvedProductPtr lib = createProduct();
+    Artifact * const libSource = createArtifact(lib, "/rdi/lib.cpp", {}, projectData);
+    Artifact * const libObject = createArtifact(lib, "/rdi/lib.o", {}, projectData);
+    Artifact * const library = createArtifact(lib, "/rdi/liblib.a", {}, projectData);
+    qbs::Internal::connect(libObject, libSource);
+    qbs::Internal::connect(library, libObject);
+    libObject->fileDependencies.insert(header);
+    const ResolvedProductPtr app = createProduct();
+    Artifact * const appSource = createArtifact(app, "/rdi/main.cpp", {}, projectData);
+    Artifact * const appObject = createArtifact(app, "/rdi/main.o", {}, projectData);
+    Artifact * const application = createArtifact(app, "/rdi/app", {}, projectData);
+    qbs::Internal::connect(appObject, appSource);
+    qbs::Internal::connect(application, appObject);
+    qbs::Internal::connect(application, library);
+
+    QCOMPARE(dependents({"/rdi/lib.h"}),
+             QStringList({"/rdi/app", "/rdi/lib.o", "/rdi/liblib.a"}));
+    QCOMPARE(dependents({"/rdi/main.cpp"}), QStringList({"/rdi/app", "/rdi/main.o"}));
+    QCOMPARE(dependents({"/rdi/lib.h", "/rdi/lib.o"}),
+             QStringList({"/rdi/app", "/rdi/liblib.a"}));
+    QCOMPARE(dependents({"/rdi/app"}), QStringList());
+    QCOMPARE(dependents({"/rdi/unknown.h"}), QStringList());
+}
+
+void TestBuildGraph::benchRuleOutputInsertion()
+{
+    // Mimics RulesApplicator for a product with many generated files that all end up
+    // as children of the same artifact.
+    const int outputCount = 20000;
+    QBENCHMARK {
+        const TopLevelProjectPtr benchProject = TopLevelProject::create();
+        benchProject->buildData = std::make_unique<ProjectBuildData>();
+        const ResolvedProductPtr product = ResolvedProduct::create();
+        product->project = benchProject;
+        product->buildData = std::make_unique<ProductBuildData>();
+        const auto target = new Artifact;
+        target->setFilePath(QStringLiteral("/bench/target"));
+        insertArtifact(product, target);
+        for (int i = 0; i < outputCount; ++i) {
+            const auto output = new Artifact;
+            output->setFilePath(QStringLiteral("/bench/generated/%1.cpp").arg(i));
+            insertArtifact(product, output);
+            qbs::Internal::connect(target, output);
+        }
+        QCOMPARE(int(target->children.size()), outputCount);
+        QCOMPARE(int(product->buildData->allNodes().size()), outputCount + 1);
+    }
 }
 
 int main(int argc, char *argv[])
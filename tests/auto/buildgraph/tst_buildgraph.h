@@ -40,6 +40,7 @@
 #define TST_BUILDGRAPH_H
 
 #include <buildgraph/forward_decls.h>
+#include <language/filetags.h>
 #include <language/forward_decls.h>
 #include <logging/ilogsink.h>
 
@@ -56,12 +57,20 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
     void testCycle();
+    void testNodeGraphExport();
+    void testReverseDependencyIndex();
+    void benchRuleOutputInsertion();
 
 private:
     qbs::Internal::ResolvedProductConstPtr productWithDirectCycle();
     qbs::Internal::ResolvedProductConstPtr productWithLessDirectCycle();
     qbs::Internal::ResolvedProductConstPtr productWithNoCycle();
+    qbs::Internal::ResolvedProductConstPtr productWithDeepChain(bool closeCycle);
     bool cycleDetected(const qbs::Internal::ResolvedProductConstPtr &product);
+    static qbs::Internal::Artifact *createArtifact(
+            const qbs::Internal::ResolvedProductPtr &product, const QString &filePath,
+            const qbs::Internal::FileTags &fileTags = {},
+            qbs::Internal::ProjectBuildData *projectBuildData = nullptr);
 
     qbs::ILogSink * const m_logSink;
 };
@@ -212,12 +212,16 @@ private slots:
                 << (QStringList() << "--changed-files" << "," << m_fileArgs);
         QTest::newRow("Invalid log level")
                 << (QStringList() << "--log-level" << "blubb" << m_fileArgs);
+        QTest::newRow("Invalid graph format")
+                << (QStringList("dump-nodes-tree") << "--format" << "blubb");
         QTest::newRow("Unknown numeric argument") << (QStringList() << m_fileArgs << "-123");
         QTest::newRow("Unknown parameter") << (QStringList() << m_fileArgs << "debug");
         QTest::newRow("Too many arguments") << (QStringList("help") << "build" << "clean");
         QTest::newRow("Property assignment for clean") << (QStringList("clean") << "profile:x");
         QTest::newRow("Property assignment for dump-nodes-tree")
                 << (QStringList("dump-nodes-tree") << "profile:x");
+        QTest::newRow("Property assignment for list-dependents")
+                << (QStringList("list-dependents") << "profile:x");
         QTest::newRow("Property assignment for status") << (QStringList("status") << "profile:x");
         QTest::newRow("Property assignment for update-timestamps")
                 << (QStringList("update-timestamps") << "profile:x");
@@ -50,9 +50,13 @@
 #include <language/item.h>
 #include <language/itempool.h>
 #include <language/language.h>
+#include <language/modulesearchindex.h>
 #include <language/propertymapinternal.h>
+#include <language/purebindingcache.h>
+#include <language/scriptcompilationcache.h>
 #include <language/scriptengine.h>
 #include <language/value.h>
+#include <loader/modulesnapshotcache.h>
 #include <loader/projectresolver.h>
 #include <parser/qmljslexer_p.h>
 #include <parser/qmljsparser_p.h>
@@ -68,8 +72,10 @@
 
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qprocess.h>
+#include <QtCore/qtemporarydir.h>
 
 #include <algorithm>
+#include <optional>
 #include <set>
 #include <utility>
 #include <vector>
@@ -1861,6 +1867,82 @@ void TestLanguage::jsExtensions()
     }
 }
 
+void TestLanguage::scriptCompilationCache()
+{
+    const QString code = "(function() { return 40 + 2; })";
+    const QString filePath = "/dev/null/cached.js";
+    const QByteArray key = ScriptCompilationCache::key(code, filePath, 1);
+    QVERIFY(key != ScriptCompilationCache::key(code, filePath, 2));
+    QVERIFY(key != ScriptCompilationCache::key(code + ' ', filePath, 1));
+
+    // The second engine must get the same function from the shared bytecode.
+    const auto otherEngine = ScriptEngine::create(m_logger, EvalContext::RuleExecution);
+    for (ScriptEngine * const engine : {m_engine.get(), otherEngine.get(), m_engine.get()}) {
+        JSContext * const ctx = engine->context();
+        const ScopedJsValue f(ctx, engine->evaluateCached(JsValueOwner::Caller, code,
+                                                          filePath, 1));
+        QVERIFY(!engine->checkAndClearException({}));
+        QVERIFY(JS_IsFunction(ctx, f));
+        const ScopedJsValue result(ctx, JS_Call(ctx, f, JS_UNDEFINED, 0, nullptr));
+        QCOMPARE(getJsVariant(ctx, result).toInt(), 42);
+    }
+    QVERIFY(!ScriptCompilationCache::instance().byteCode(key).isEmpty());
+
+    // With a disk cache directory, the bytecode is also persisted for later processes.
+    QTemporaryDir buildDir;
+    QVERIFY(buildDir.isValid());
+    const QString diskCacheDir = ScriptCompilationCache::diskCacheDirectory(buildDir.path());
+    const QString persistedCode = "(function() { return 43; })";
+    otherEngine->setByteCodeCacheDirectory(diskCacheDir);
+    const ScopedJsValue persisted(otherEngine->context(), otherEngine->evaluateCached(
+                                      JsValueOwner::Caller, persistedCode, filePath, 1));
+    QVERIFY(!otherEngine->checkAndClearException({}));
+    QCOMPARE(QDir(diskCacheDir).entryList(QDir::Files).size(), 1);
+
+    const ScopedJsValue broken(m_engine->context(), m_engine->evaluateCached(
+                                   JsValueOwner::Caller, QString("1 +"), filePath, 1));
+    QVERIFY(m_engine->checkAndClearException({}));
+    QVERIFY(ScriptCompilationCache::instance().byteCode(
+                ScriptCompilationCache::key("1 +", filePath, 1)).isEmpty());
+}
+
+void TestLanguage::staticProductDependencies()
+{
+    try {
+        resolveProject("static-product-dependencies.qbs");
+        QVERIFY(!!project);
+        QStringList productNames;
+        for (const ResolvedProductPtr &product : std::as_const(project->products))
+            productNames << product->name;
+        QCOMPARE(productNames.size(), 6);
+
+        // With a single job, the products finish in the order they were scheduled in.
+        // Dependents only get queued once their dependencies have finished, and the
+        // product heading the longest chain goes first, even though "standalone" comes
+        // first in the initial queue. The products on the seeming cycle are blocked on
+        // each other and only get released once nothing else is left.
+        QCOMPARE(productNames.mid(0, 4), QStringList({"base", "mid", "standalone", "top"}));
+        QStringList cycleProductNames = productNames.mid(4);
+        cycleProductNames.sort();
+        QCOMPARE(cycleProductNames, QStringList({"cycle1", "cycle2"}));
+
+        const QHash<QString, ResolvedProductPtr> products = productsFromProject(project);
+        const ResolvedProductPtr top = products.value("top");
+        QVERIFY(!!top);
+        QCOMPARE(top->dependencies.size(), size_t { 1 });
+        QCOMPARE((*top->dependencies.cbegin())->name, QString("mid"));
+        const ResolvedProductPtr cycle1 = products.value("cycle1");
+        QVERIFY(!!cycle1);
+        QCOMPARE(cycle1->dependencies.size(), size_t { 1 });
+        QCOMPARE((*cycle1->dependencies.cbegin())->name, QString("cycle2"));
+        const ResolvedProductPtr cycle2 = products.value("cycle2");
+        QVERIFY(!!cycle2);
+        QVERIFY(cycle2->dependencies.empty());
+    } catch (const ErrorInfo &e) {
+        QFAIL(qPrintable(e.toString()));
+    }
+}
+
 void TestLanguage::jsImportUsedInMultipleScopes_data()
 {
     QTest::addColumn<QString>("buildVariant");
@@ -2502,6 +2584,105 @@ void TestLanguage::moduleScope()
     QCOMPARE(exceptionCaught, false);
 }
 
+void TestLanguage::moduleSearchIndex()
+{
+    QTemporaryDir searchPath;
+    QVERIFY(searchPath.isValid());
+    const QString modulesDir = searchPath.path() + "/modules";
+    const QString innerDir = modulesDir + "/outer/inner";
+    QVERIFY(QDir().mkpath(innerDir));
+    const auto createFile = [](const QString &filePath) {
+        QFile file(filePath);
+        return file.open(QIODevice::WriteOnly);
+    };
+    QVERIFY(createFile(innerDir + "/inner.qbs"));
+    QVERIFY(createFile(innerDir + "/readme.txt"));
+
+    ModuleSearchIndex index;
+    QCOMPARE(index.findModuleDirectory(searchPath.path(), QStringList{"outer", "inner"}),
+             innerDir);
+    QCOMPARE(index.moduleFiles(innerDir), QStringList(innerDir + "/inner.qbs"));
+    QVERIFY(index.findModuleDirectory(searchPath.path(), QStringList{"Outer", "inner"})
+                .isEmpty());
+    QVERIFY(index.findModuleDirectory(searchPath.path(), QString("other")).isEmpty());
+    QVERIFY(index.findModuleDirectory(searchPath.path() + "/none", QString("outer")).isEmpty());
+
+    // The file system is consulted only once per directory.
+    QVERIFY(QDir().mkpath(modulesDir + "/other"));
+    QVERIFY(index.findModuleDirectory(searchPath.path(), QString("other")).isEmpty());
+
+    // Unless the directory is explicitly marked as changed.
+    index.resetVerification(modulesDir);
+    QCOMPARE(index.findModuleDirectory(searchPath.path(), QString("other")),
+             modulesDir + "/other");
+    QCOMPARE(index.moduleFiles(innerDir), QStringList(innerDir + "/inner.qbs"));
+}
+
+void TestLanguage::moduleSnapshots()
+{
+    bool exceptionCaught = false;
+    try {
+        ModuleSnapshotCache &cache = ModuleSnapshotCache::instance();
+        cache.clear();
+
+        // The second resolve must re-use the values from the first one.
+        for (int i = 0; i < 2; ++i) {
+            const int hitCount = cache.hitCount();
+            resolveProject("module-snapshots/module-snapshots.qbs");
+            QVERIFY(!!project);
+            const QHash<QString, ResolvedProductPtr> products = productsFromProject(project);
+            QCOMPARE(products.size(), 3);
+            const auto moduleValue = [&products](const QString &product, const QString &name) {
+                return products.value(product)->moduleProperties
+                        ->moduleProperty("snapshotmodule", name).toString();
+            };
+            QCOMPARE(moduleValue("p1", "constant"), QString("default"));
+            QCOMPARE(moduleValue("p1", "derived"), QString("default-suffix"));
+            QCOMPARE(moduleValue("p1", "productSpecific"), QString("p1-default"));
+            QCOMPARE(moduleValue("p2", "derived"), QString("default-suffix"));
+            QCOMPARE(moduleValue("p2", "productSpecific"), QString("p2-default"));
+            QCOMPARE(moduleValue("p3", "derived"), QString("overridden-suffix"));
+            QCOMPARE(moduleValue("p3", "productSpecific"), QString("p3-overridden"));
+            if (i == 1)
+                QVERIFY(cache.hitCount() >= hitCount + 3);
+        }
+
+        // Changing a declaration must not yield the values converted for the old one.
+        QTemporaryDir projectDir;
+        QVERIFY(projectDir.isValid());
+        const QString moduleDir = projectDir.path() + "/modules/snapshotmodule";
+        QVERIFY(QDir().mkpath(moduleDir));
+        QVERIFY(QFile::copy(testProject("module-snapshots/module-snapshots.qbs"),
+                            projectDir.path() + "/module-snapshots.qbs"));
+        const QString moduleFilePath = moduleDir + "/snapshotmodule.qbs";
+        QVERIFY(QFile::copy(testProject("module-snapshots/modules/snapshotmodule/"
+                                        "snapshotmodule.qbs"), moduleFilePath));
+        const auto constantValue = [this, &projectDir] {
+            defaultParameters.setProjectFilePath(projectDir.path() + "/module-snapshots.qbs");
+            resolveProject(nullptr);
+            return productsFromProject(project).value("p1")->moduleProperties
+                    ->moduleProperty("snapshotmodule", "constant");
+        };
+        QCOMPARE(constantValue().userType(), int(QMetaType::QString));
+        QCOMPARE(constantValue().userType(), int(QMetaType::QString));
+        waitForNewTimestamp(moduleDir);
+        QFile moduleFile(moduleFilePath);
+        QVERIFY(moduleFile.open(QIODevice::ReadWrite));
+        QByteArray moduleContent = moduleFile.readAll();
+        moduleContent.replace("property string constant", "property stringList constant");
+        QVERIFY(moduleFile.resize(0));
+        QCOMPARE(moduleFile.write(moduleContent), qint64(moduleContent.size()));
+        moduleFile.close();
+        const QVariant newValue = constantValue();
+        QCOMPARE(newValue.userType(), int(QMetaType::QStringList));
+        QCOMPARE(newValue.toStringList(), QStringList("default"));
+    } catch (const ErrorInfo &e) {
+        exceptionCaught = true;
+        qDebug() << e.toString();
+    }
+    QCOMPARE(exceptionCaught, false);
+}
+
 void TestLanguage::moduleWithProductDependency()
 {
     bool exceptionCaught = false;
@@ -3244,6 +3425,63 @@ void TestLanguage::propertyAssignmentInExportedGroup()
     QCOMPARE(exceptionCaught, false);
 }
 
+void TestLanguage::pureBindingCache()
+{
+    FileContextPtr fileContext = FileContext::create();
+    fileContext->setFilePath("/dev/null");
+    JSSourceValueCreator sourceValueCreator(fileContext);
+    ItemPool pool;
+    const auto createItem = [&](int x) {
+        Item * const item = Item::create(&pool, ItemType::Scope);
+        item->setProperty("x", VariantValue::create(x));
+        item->setProperty("y", sourceValueCreator.create("x + 1"));
+        return item;
+    };
+
+    PureBindingCache cache;
+    Evaluator evaluator(m_engine.get());
+    evaluator.setPureBindingCache(&cache);
+    const auto otherEngine = ScriptEngine::create(m_logger, EvalContext::PropertyEvaluation);
+    Evaluator otherEvaluator(otherEngine.get());
+    otherEvaluator.setPureBindingCache(&cache);
+    const auto y = [](Evaluator &evaluator, const Item *item) {
+        return getJsVariant(evaluator.engine()->context(), evaluator.property(item, "y")).toInt();
+    };
+
+    // The other engine must get the result of the first evaluation.
+    QCOMPARE(y(evaluator, createItem(1)), 2);
+    QCOMPARE(cache.hitCount(), 0);
+    QCOMPARE(y(otherEvaluator, createItem(1)), 2);
+    QCOMPARE(cache.hitCount(), 1);
+
+    // A different value of x must not yield the stored result.
+    QCOMPARE(y(otherEvaluator, createItem(5)), 6);
+    QCOMPARE(cache.hitCount(), 1);
+    QCOMPARE(y(evaluator, createItem(5)), 6);
+    QCOMPARE(cache.hitCount(), 2);
+    QCOMPARE(y(evaluator, createItem(1)), 2);
+    QCOMPARE(cache.hitCount(), 3);
+
+    // A name that the binding did not find in the item must not be there in other contexts
+    // either, as it would resolve to the item property instead.
+    const auto createItemWithFallback = [&](int x, std::optional<int> z) {
+        Item * const item = createItem(x);
+        if (z)
+            item->setProperty("z", VariantValue::create(*z));
+        item->setProperty("w", sourceValueCreator.create("typeof z === 'undefined' ? x : z"));
+        return item;
+    };
+    const auto w = [](Evaluator &evaluator, const Item *item) {
+        return getJsVariant(evaluator.engine()->context(), evaluator.property(item, "w")).toInt();
+    };
+    QCOMPARE(w(evaluator, createItemWithFallback(1, {})), 1);
+    QCOMPARE(cache.hitCount(), 3);
+    QCOMPARE(w(otherEvaluator, createItemWithFallback(1, 10)), 10);
+    QCOMPARE(cache.hitCount(), 3);
+    QCOMPARE(w(otherEvaluator, createItemWithFallback(1, {})), 1);
+    QCOMPARE(cache.hitCount(), 4);
+}
+
 void TestLanguage::qbs1275()
 {
     bool exceptionCaught = false;
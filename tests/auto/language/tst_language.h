@@ -135,6 +135,8 @@ private slots:
     void modulePropertiesInGroups();
     void modulePropertyOverridesPerProduct();
     void moduleScope();
+    void moduleSearchIndex();
+    void moduleSnapshots();
     void moduleWithProductDependency();
     void modules_data();
     void modules();
@@ -163,6 +165,7 @@ private slots:
     void propertiesBlockInGroup();
     void propertiesItemInModule();
     void propertyAssignmentInExportedGroup();
+    void pureBindingCache();
     void qbs1275();
     void qbsPropertiesInProjectCondition();
     void qbsPropertyConvenienceOverride();
@@ -178,6 +181,8 @@ private slots:
     void qualifiedId();
     void recursiveProductDependencies();
     void rfc1034Identifier();
+    void scriptCompilationCache();
+    void staticProductDependencies();
     void throwThings_data();
     void throwThings();
     void useInternalProfile();
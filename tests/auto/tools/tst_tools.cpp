@@ -44,17 +44,22 @@
 #include "../shared.h"
 
 #include <tools/buildoptions.h>
+#include <tools/directorylistingcache.h>
 #include <tools/error.h>
 #include <tools/fileinfo.h>
 #include <tools/filesaver.h>
 #include <tools/hostosinfo.h>
+#include <tools/pathtable.h>
+#include <tools/persistence.h>
 #include <tools/processutils.h>
 #include <tools/profile.h>
 #include <tools/set.h>
 #include <tools/settings.h>
 #include <tools/setupprojectparameters.h>
+#include <tools/shardedmap.h>
 #include <tools/span.h>
 #include <tools/stringutils.h>
+#include <tools/threadpool.h>
 #include <tools/version.h>
 
 #include <QtCore/qdir.h>
@@ -66,6 +71,13 @@
 
 #include <QtTest/qtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <random>
+
 using namespace qbs;
 using namespace qbs::Internal;
 
@@ -260,6 +272,50 @@ void TestTools::fileCaseCheck()
         QVERIFY(!FileInfo::isFileCaseCorrect(upperFilePath));
 }
 
+void TestTools::directoryListingCache()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString dirPath = tmpDir.path() + "/listed";
+    QVERIFY(QDir().mkpath(dirPath + "/subdir"));
+    QFile file(dirPath + "/file.txt");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.close();
+    QFile hiddenFile(dirPath + "/.hidden");
+    QVERIFY(hiddenFile.open(QIODevice::WriteOnly));
+    hiddenFile.close();
+
+    Internal::DirectoryListingCache cache;
+    const auto listing = cache.listing(dirPath);
+    QCOMPARE(listing->dirPath, dirPath);
+    QVERIFY(listing->lastModified.isValid());
+    QCOMPARE(int(listing->entries.size()), 3);
+    for (const Internal::DirectoryListingCache::Entry &entry : listing->entries) {
+        QCOMPARE(entry.isDir, entry.name == "subdir");
+        QVERIFY(!entry.isSymLink);
+        if (!HostOsInfo::isWindowsHost())
+            QCOMPARE(entry.isHidden, entry.name == ".hidden");
+    }
+
+    // Unchanged directories are served from the cache, the order of the request is kept.
+    const auto listings = cache.listings({dirPath + "/subdir", dirPath, tmpDir.path() + "/none"});
+    QCOMPARE(int(listings.size()), 3);
+    QCOMPARE(listings.at(0)->dirPath, dirPath + "/subdir");
+    QVERIFY(listings.at(0)->entries.empty());
+    QCOMPARE(listings.at(1), listing);
+    QVERIFY(!listings.at(2)->lastModified.isValid());
+    QVERIFY(listings.at(2)->entries.empty());
+
+    // A changed directory is read again.
+    waitForNewTimestamp(tmpDir.path());
+    QFile newFile(dirPath + "/new.txt");
+    QVERIFY(newFile.open(QIODevice::WriteOnly));
+    newFile.close();
+    const auto newListing = cache.listing(dirPath);
+    QVERIFY(newListing != listing);
+    QCOMPARE(int(newListing->entries.size()), 4);
+}
+
 void TestTools::testProfiles()
 {
     TemporaryProfile tpp("parent", m_settings);
@@ -1122,6 +1178,50 @@ void TestTools::set_intersects()
     QVERIFY(s1.intersects(s3));
 }
 
+void TestTools::set_largePointerSet()
+{
+    // Large sets of pointers switch to chunked storage; they must behave exactly like small ones.
+    std::vector<int> storage(10000);
+    std::vector<int *> pointers;
+    for (int &i : storage)
+        pointers.push_back(&i);
+    std::shuffle(pointers.begin(), pointers.end(), std::mt19937(42));
+
+    Set<int *> set;
+    for (int * const p : pointers)
+        QVERIFY(set.insert(p).second);
+    QVERIFY(!set.insert(pointers.front()).second);
+    QCOMPARE(set.size(), storage.size());
+    QVERIFY(std::is_sorted(set.cbegin(), set.cend()));
+    QCOMPARE(*set.cbegin(), &storage.front());
+    QCOMPARE(*set.crbegin(), &storage.back());
+    QCOMPARE(set.cend() - set.cbegin(), std::ptrdiff_t(storage.size()));
+
+    Set<int *> evens;
+    for (size_t i = 0; i < storage.size(); i += 2)
+        evens << &storage[i];
+    QVERIFY(set.contains(evens));
+    QCOMPARE((set & evens), evens);
+
+    Set<int *> odds = set - evens;
+    QCOMPARE(odds.size(), storage.size() / 2);
+    QVERIFY(!odds.intersects(evens));
+    for (size_t i = 0; i < storage.size(); i += 2)
+        QVERIFY(set.remove(&storage[i]));
+    QCOMPARE(set, odds);
+    QVERIFY(!set.contains(&storage[0]));
+    QVERIFY(set.contains(&storage[1]));
+    QVERIFY(set.find(&storage[3]) != set.end());
+
+    set.unite(evens);
+    QCOMPARE(set.size(), storage.size());
+    QVERIFY(std::equal(set.cbegin(), set.cend(), sorted(pointers).cbegin()));
+
+    for (auto it = set.begin(); it != set.end();)
+        it = set.erase(it);
+    QVERIFY(set.empty());
+}
+
 void TestTools::stringutils_join()
 {
     QFETCH(std::vector<std::string>, input);
@@ -1263,12 +1363,336 @@ void TestTools::hash_range()
     QCOMPARE(map[key2], 2);
 }
 
+void TestTools::shardedMap()
+{
+    ShardedMap<QString, std::atomic<int>> map;
+    std::atomic<int> &first = map[QStringLiteral("key0")];
+    QCOMPARE(first.load(), 0);
+
+    // Concurrent look-ups of the same keys must yield the same values.
+    ThreadPool pool(4);
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.push_back(pool.run([&map] {
+            for (int j = 0; j < 1000; ++j)
+                ++map[QStringLiteral("key%1").arg(j % 100)];
+        }));
+    }
+    for (const auto &f : futures)
+        f.wait();
+    for (int j = 0; j < 100; ++j)
+        QCOMPARE(map[QStringLiteral("key%1").arg(j)].load(), 80);
+    QCOMPARE(&map[QStringLiteral("key0")], &first);
+}
+
 void TestTools::span()
 {
     std::vector<int> vec;
     qbs::Internal::span<int> span(vec);
 }
 
+void TestTools::pathTable()
+{
+    PathTable table;
+    QCOMPARE(table.pathCount(), 0);
+    QCOMPARE(table.find(QStringLiteral("/usr/include/stdio.h")), PathTable::invalidPathId);
+
+    const PathTable::Entry * const stdio = table.intern(QStringLiteral("/usr/include/stdio.h"));
+    QCOMPARE(stdio->filePath(), QStringLiteral("/usr/include/stdio.h"));
+    QCOMPARE(stdio->dirPath, QStringLiteral("/usr/include"));
+    QCOMPARE(stdio->fileName, QStringLiteral("stdio.h"));
+    QCOMPARE(table.intern(QStringLiteral("/usr/include/stdio.h")), stdio);
+    QCOMPARE(table.find(QStringLiteral("/usr/include/stdio.h")), stdio->id);
+    QCOMPARE(table.find(u"/usr/include", u"stdio.h"), stdio->id);
+
+    const PathTable::Entry * const stdlib = table.intern(QStringLiteral("/usr/include/stdlib.h"));
+    QVERIFY(stdlib != stdio);
+    QVERIFY(stdlib->id != stdio->id);
+    QCOMPARE(stdlib->dirId, stdio->dirId);
+    QCOMPARE(stdlib->dirPath.constData(), stdio->dirPath.constData());
+    QCOMPARE(table.pathCount(), 2);
+    QCOMPARE(table.directoryCount(), 1);
+
+    // A file in the root directory and a plain file name both have an empty directory part,
+    // but must not be confused.
+    const PathTable::Entry * const rootFile = table.intern(QStringLiteral("/stdio.h"));
+    const PathTable::Entry * const plainFile = table.intern(QStringLiteral("stdio.h"));
+    QVERIFY(rootFile != plainFile);
+    QCOMPARE(rootFile->filePath(), QStringLiteral("/stdio.h"));
+    QCOMPARE(plainFile->filePath(), QStringLiteral("stdio.h"));
+    QCOMPARE(rootFile->fileName, QStringLiteral("stdio.h"));
+    QCOMPARE(plainFile->fileName, QStringLiteral("stdio.h"));
+    QVERIFY(rootFile->dirPath.isEmpty());
+    QVERIFY(plainFile->dirPath.isEmpty());
+    QCOMPARE(table.pathCount(), 4);
+    QCOMPARE(table.directoryCount(), 2);
+
+    // An entry goes away with its last reference, and so does a directory without entries.
+    // The ids of removed entries are not handed out again.
+    const PathTable::PathId stdioId = stdio->id;
+    table.release(stdio);
+    QCOMPARE(table.find(QStringLiteral("/usr/include/stdio.h")), stdioId);
+    table.release(stdio);
+    QCOMPARE(table.find(QStringLiteral("/usr/include/stdio.h")), PathTable::invalidPathId);
+    QCOMPARE(table.pathCount(), 3);
+    QCOMPARE(table.directoryCount(), 2);
+    table.release(stdlib);
+    table.release(rootFile);
+    QCOMPARE(table.pathCount(), 1);
+    QCOMPARE(table.directoryCount(), 0);
+    const PathTable::Entry * const stdioAgain
+            = table.intern(QStringLiteral("/usr/include/stdio.h"));
+    QVERIFY(stdioAgain->id != stdioId);
+    QCOMPARE(stdioAgain->filePath(), QStringLiteral("/usr/include/stdio.h"));
+    QCOMPARE(table.directoryCount(), 1);
+}
+
+void TestTools::persistentPool()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.filePath(QStringLiteral("test.bg"));
+    const QVariantMap config{{QStringLiteral("qbs.architecture"), QStringLiteral("x86_64")}};
+    const QVariantMap variants{
+        {QStringLiteral("bool"), true},
+        {QStringLiteral("int"), -42},
+        {QStringLiteral("longlong"), Q_INT64_C(1) << 40},
+        {QStringLiteral("string"), QStringLiteral("\u00e4\u00f6\u00fc")},
+        {QStringLiteral("stringList"), QStringList{QStringLiteral("a"), QString()}},
+        {QStringLiteral("double"), 0.5},
+        {QStringLiteral("null"), QVariant()}};
+    const std::vector<int> numbers{0, 1, -1, 127, 128, -65, std::numeric_limits<int>::min(),
+                                   std::numeric_limits<int>::max()};
+
+    Logger logger;
+    {
+        PersistentPool pool(logger);
+        PersistentPool::HeadData headData;
+        headData.projectConfig = config;
+        pool.setHeadData(headData);
+        pool.setupWriteStream(filePath);
+        pool.store(numbers, QStringLiteral("foo"), QString(), QString(0, QChar()),
+                   QStringLiteral("foo"), variants, quint64(-1), true);
+        pool.finalizeWriteStream();
+    }
+
+    PersistentPool pool(logger);
+    pool.load(filePath);
+    QCOMPARE(pool.headData().projectConfig, config);
+    QCOMPARE(pool.load<std::vector<int>>(), numbers);
+    QCOMPARE(pool.load<QString>(), QStringLiteral("foo"));
+    QVERIFY(pool.load<QString>().isNull());
+    const auto emptyString = pool.load<QString>();
+    QVERIFY(emptyString.isEmpty() && !emptyString.isNull());
+    QCOMPARE(pool.load<QString>(), QStringLiteral("foo"));
+    QCOMPARE(pool.load<QVariantMap>(), variants);
+    QCOMPARE(pool.load<quint64>(), quint64(-1));
+    QCOMPARE(pool.load<bool>(), true);
+
+    // A file with a different format must be rejected.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.write("XBS") == 3);
+    file.close();
+    bool exceptionCaught = false;
+    try {
+        PersistentPool(logger).load(filePath);
+    } catch (const ErrorInfo &) {
+        exceptionCaught = true;
+    }
+    QVERIFY(exceptionCaught);
+
+    // Loading waits for a pending background write.
+    {
+        PersistentPool writePool(logger);
+        writePool.setupWriteStream(filePath);
+        writePool.store(numbers);
+        writePool.finalizeWriteStreamInBackground();
+    }
+    PersistentPool readPool(logger);
+    readPool.load(filePath);
+    QCOMPARE(readPool.load<std::vector<int>>(), numbers);
+}
+
+void TestTools::persistentPoolSections()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString filePath = tmpDir.filePath(QStringLiteral("test.bg"));
+    const QString shared = QStringLiteral("shared");
+    const QStringList list{QStringLiteral("a"), QStringLiteral("b")};
+
+    Logger logger;
+    {
+        PersistentPool pool(logger);
+        pool.setupWriteStream(filePath);
+        pool.store(shared);
+        pool.beginSection();
+        pool.store(QStringLiteral("first"), shared, list);
+        pool.beginSection();
+        pool.store(QStringLiteral("old"), shared, list, QStringList{QStringLiteral("c")});
+        pool.finalizeWriteStream();
+    }
+
+    std::unique_ptr<PersistentPool::StoredState> state;
+    {
+        PersistentPool pool(logger);
+        pool.load(filePath);
+        QCOMPARE(pool.load<QString>(), shared);
+        pool.beginSection();
+        QCOMPARE(pool.load<QString>(), QStringLiteral("first"));
+        QCOMPARE(pool.load<QString>(), shared);
+        QCOMPARE(pool.load<QStringList>(), list);
+        pool.beginSection();
+        QCOMPARE(pool.load<QString>(), QStringLiteral("old"));
+        state = pool.takeStoredState();
+    }
+    QCOMPARE(state->sectionCount(), 3);
+
+    // Only the last section gets replaced; it can refer to data from the preceding ones.
+    {
+        PersistentPool pool(logger);
+        QVERIFY(pool.setupWriteStream(filePath, std::move(*state), 2));
+        pool.beginSection();
+        pool.store(QStringLiteral("new"), shared, list, QStringLiteral("first"),
+                   QStringList{QStringLiteral("d")});
+        pool.finalizeWriteStream();
+        state = pool.takeStoredState();
+    }
+    QCOMPARE(state->sectionCount(), 3);
+    {
+        PersistentPool pool(logger);
+        pool.load(filePath);
+        QCOMPARE(pool.load<QString>(), shared);
+        pool.beginSection();
+        QCOMPARE(pool.load<QString>(), QStringLiteral("first"));
+        QCOMPARE(pool.load<QString>(), shared);
+        QCOMPARE(pool.load<QStringList>(), list);
+        pool.beginSection();
+        QCOMPARE(pool.load<QString>(), QStringLiteral("new"));
+        QCOMPARE(pool.load<QString>(), shared);
+        QCOMPARE(pool.load<QStringList>(), list);
+        QCOMPARE(pool.load<QString>(), QStringLiteral("first"));
+        QCOMPARE(pool.load<QStringList>(), QStringList{QStringLiteral("d")});
+    }
+
+    // A file that was modified in the meantime must be written completely.
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::Append));
+    QVERIFY(file.write("x") == 1);
+    file.close();
+    PersistentPool pool(logger);
+    QVERIFY(!pool.setupWriteStream(filePath, std::move(*state), 2));
+}
+
+void TestTools::threadPool()
+{
+    ThreadPool pool(4);
+    QCOMPARE(pool.maxThreadCount(), 4);
+    QVERIFY(!pool.isWorkerThread());
+
+    std::atomic<int> counter = 0;
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.run([&counter, i] {
+            ++counter;
+            return i * 2;
+        }));
+    }
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(futures.at(i).get(), i * 2);
+    QCOMPARE(counter.load(), 1000);
+
+    auto throwingTask = pool.run([]() -> int { throw std::runtime_error("task failed"); });
+    QVERIFY_EXCEPTION_THROWN(throwingTask.get(), std::runtime_error);
+}
+
+void TestTools::threadPool_nestedTasks()
+{
+    // More nested batches than workers must not dead-lock, because the waiting threads
+    // work on their own batches.
+    ThreadPool pool(2);
+    std::atomic<int> counter = 0;
+    pool.runChunks(8, [&pool, &counter](int) {
+        pool.runChunks(8, [&counter](int) { ++counter; });
+    });
+    QCOMPARE(counter.load(), 64);
+}
+
+void TestTools::threadPool_noUnrelatedTasksWhileWaiting()
+{
+    // A task waiting for its batch must not pick up other queued tasks, which could
+    // be arbitrarily long product resolves or JavaScript commands.
+    ThreadPool pool(1);
+    std::promise<void> outerStarted;
+    std::promise<void> unrelatedQueued;
+    std::atomic<bool> unrelatedTaskRan = false;
+    std::atomic<bool> ranNested = false;
+    auto outer = pool.run([&] {
+        outerStarted.set_value();
+        unrelatedQueued.get_future().wait();
+        pool.runChunks(4, [&](int) { ranNested = ranNested || unrelatedTaskRan; });
+        ranNested = ranNested || unrelatedTaskRan;
+    });
+    outerStarted.get_future().wait();
+    auto unrelated = pool.run([&unrelatedTaskRan] { unrelatedTaskRan = true; });
+    unrelatedQueued.set_value();
+    outer.get();
+    unrelated.get();
+    QVERIFY(!ranNested);
+    QVERIFY(unrelatedTaskRan);
+}
+
+void TestTools::threadPool_mapped()
+{
+    ThreadPool pool(4);
+    QStringList items;
+    for (int i = 0; i < 100; ++i)
+        items << QString::number(i);
+    const std::vector<int> results = pool.mapped(items, [](const QString &s) {
+        return s.toInt() * 2;
+    }, 7);
+    QCOMPARE(int(results.size()), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(results.at(i), i * 2);
+    QVERIFY(pool.mapped(QStringList(), [](const QString &) { return true; }).empty());
+
+    const auto throwingMap = [&pool, &items] {
+        pool.mapped(items, [](const QString &s) {
+            if (s == QLatin1String("50"))
+                throw std::runtime_error("item failed");
+            return true;
+        });
+    };
+    QVERIFY_EXCEPTION_THROWN(throwingMap(), std::runtime_error);
+}
+
+void TestTools::threadPool_maxThreadCount()
+{
+    ThreadPool pool(2);
+    pool.setMaxThreadCount(0);
+    QCOMPARE(pool.maxThreadCount(), 1);
+
+    // The tasks only finish once all of them are running, which requires all eight workers.
+    pool.setMaxThreadCount(8);
+    QCOMPARE(pool.maxThreadCount(), 8);
+    std::mutex mutex;
+    std::condition_variable allRunning;
+    int runningCount = 0;
+    std::vector<std::future<bool>> futures;
+    for (int i = 0; i < 8; ++i) {
+        futures.push_back(pool.run([&] {
+            std::unique_lock lock(mutex);
+            if (++runningCount == 8)
+                allRunning.notify_all();
+            return allRunning.wait_for(lock, std::chrono::seconds(10),
+                                       [&runningCount] { return runningCount == 8; });
+        }));
+    }
+    for (auto &future : futures)
+        QVERIFY(future.get());
+}
+
 int main(int argc, char *argv[])
 {
     QCoreApplication app(argc, argv);
@@ -63,6 +63,7 @@ private slots:
     void fileSaver();
 
     void fileCaseCheck();
+    void directoryListingCache();
     void testBuildConfigMerging();
     void testFileInfo();
     void testProcessNameByPid();
@@ -90,6 +91,7 @@ private slots:
     void set_makeSureTheComfortFunctionsCompile();
     void set_initializerList();
     void set_intersects();
+    void set_largePointerSet();
 
     void stringutils_join();
     void stringutils_join_data();
@@ -101,8 +103,21 @@ private slots:
     void hash_tuple();
     void hash_range();
 
+    void pathTable();
+
+    void persistentPool();
+    void persistentPoolSections();
+
+    void shardedMap();
+
     void span();
 
+    void threadPool();
+    void threadPool_nestedTasks();
+    void threadPool_mapped();
+    void threadPool_noUnrelatedTasksWhileWaiting();
+    void threadPool_maxThreadCount();
+
 private:
     QString setupSettingsDir1();
     QString setupSettingsDir2();
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "activities.h"
+
+namespace qbsBenchmarker {
+
+const std::vector<Activity> &allActivities()
+{
+    static const std::vector<Activity> activities{
+        ActivityResolving, ActivityRuleExecution, ActivityNullBuild, ActivityIncrementalBuild,
+        ActivityBuildGraphLoading, ActivitySessionProjectData};
+    return activities;
+}
+
+QString activityName(Activity activity)
+{
+    switch (activity) {
+    case ActivityResolving:
+        return QStringLiteral("resolving");
+    case ActivityRuleExecution:
+        return QStringLiteral("rule-execution");
+    case ActivityNullBuild:
+        return QStringLiteral("null-build");
+    case ActivityIncrementalBuild:
+        return QStringLiteral("incremental-build");
+    case ActivityBuildGraphLoading:
+        return QStringLiteral("build-graph-loading");
+    case ActivitySessionProjectData:
+        return QStringLiteral("session-project-data");
+    }
+    return {};
+}
+
+QString activityDisplayName(Activity activity)
+{
+    switch (activity) {
+    case ActivityResolving:
+        return QStringLiteral("Resolving");
+    case ActivityRuleExecution:
+        return QStringLiteral("Rule Execution");
+    case ActivityNullBuild:
+        return QStringLiteral("Null Build");
+    case ActivityIncrementalBuild:
+        return QStringLiteral("Incremental Build");
+    case ActivityBuildGraphLoading:
+        return QStringLiteral("Build Graph Loading");
+    case ActivitySessionProjectData:
+        return QStringLiteral("Session Project Data");
+    }
+    return {};
+}
+
+} // namespace qbsBenchmarker
@@ -29,13 +29,27 @@
 #define QBS_BENCHMARKER_ACTIVITY_H
 
 #include <QtCore/qflags.h>
+#include <QtCore/qstring.h>
+
+#include <vector>
 
 namespace qbsBenchmarker {
 
-enum Activity { ActivityResolving = 1, ActivityRuleExecution = 2, ActivityNullBuild = 4 };
+enum Activity {
+    ActivityResolving = 1,
+    ActivityRuleExecution = 2,
+    ActivityNullBuild = 4,
+    ActivityIncrementalBuild = 8,
+    ActivityBuildGraphLoading = 16,
+    ActivitySessionProjectData = 32,
+};
 Q_DECLARE_FLAGS(Activities, Activity)
 Q_DECLARE_OPERATORS_FOR_FLAGS(Activities)
 
+const std::vector<Activity> &allActivities();
+QString activityName(Activity activity); // As used on the command line and in JSON output.
+QString activityDisplayName(Activity activity);
+
 } // namespace qbsBenchmarker
 
 #endif // Include guard.
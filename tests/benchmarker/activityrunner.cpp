@@ -0,0 +1,211 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "activityrunner.h"
+
+#include "exception.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace qbsBenchmarker {
+
+ActivityRunner::ActivityRunner(Activities activities, QString testProject, QString editFile,
+                               const QString &qbsBuildDir, QString baseOutputDir)
+    : m_activities(activities)
+    , m_testProject(std::move(testProject))
+    , m_editFile(std::move(editFile))
+    , m_qbsBinary(qbsBuildDir + "/benchmarker/install-root/bin/qbs")
+    , m_baseOutputDir(std::move(baseOutputDir))
+{
+    if (!QDir::root().mkpath(m_baseOutputDir))
+        throw Exception(QStringLiteral("Failed to create directory '%1'.").arg(m_baseOutputDir));
+}
+
+void ActivityRunner::prepareActivity(Activity activity, const QStringList &buildDirs) const
+{
+    for (const QString &buildDir : buildDirs) {
+        switch (activity) {
+        case ActivityResolving:
+            break;
+        case ActivityRuleExecution:
+        case ActivityBuildGraphLoading:
+        case ActivitySessionProjectData:
+            runProcess(qbsCommandLine("resolve", buildDir, false));
+            break;
+        case ActivityNullBuild:
+        case ActivityIncrementalBuild:
+            runProcess(qbsCommandLine("build", buildDir, false));
+            break;
+        }
+    }
+    if (activity == ActivityIncrementalBuild)
+        editFile();
+}
+
+QStringList ActivityRunner::qbsCommandLine(Activity activity, const QString &buildDir) const
+{
+    switch (activity) {
+    case ActivityResolving:
+        return qbsCommandLine("resolve", buildDir, false);
+    case ActivityRuleExecution:
+        return qbsCommandLine("build", buildDir, true);
+    case ActivityNullBuild:
+    case ActivityIncrementalBuild:
+        return qbsCommandLine("build", buildDir, false);
+    case ActivityBuildGraphLoading:
+        return QStringList() << m_qbsBinary << "list-products" << "-d" << buildDir
+                             << "-f" << m_testProject;
+    case ActivitySessionProjectData:
+        return QStringList() << m_qbsBinary << "session";
+    }
+    return {};
+}
+
+QStringList ActivityRunner::qbsCommandLine(const QString &command, const QString &buildDir,
+                                           bool dryRun) const
+{
+    QStringList commandLine = QStringList() << m_qbsBinary << command << "-qq" << "-d" << buildDir
+                                            << "-f" << m_testProject;
+    if (dryRun)
+        commandLine << "--dry-run";
+    return commandLine;
+}
+
+ProcessInteraction ActivityRunner::interaction(Activity activity, const QString &buildDir) const
+{
+    if (activity != ActivitySessionProjectData)
+        return {};
+    return [this, buildDir](int stdinFd, int stdoutFd) {
+        talkToSession(stdinFd, stdoutFd, buildDir);
+    };
+}
+
+// A real edit rather than just a timestamp update, so content-based checks see it too.
+void ActivityRunner::editFile() const
+{
+    QFile f(m_editFile);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append) || f.write("\n") != 1) {
+        throw Exception(QStringLiteral("Failed to edit file '%1': %2")
+                        .arg(m_editFile, f.errorString()));
+    }
+}
+
+#ifdef Q_OS_UNIX
+static void writeSessionPacket(int fd, const QJsonObject &message)
+{
+    const QByteArray payload = QJsonDocument(message).toJson(QJsonDocument::Compact).toBase64();
+    const QByteArray packet = "qbsmsg:" + QByteArray::number(payload.size()) + '\n' + payload;
+    qint64 written = 0;
+    while (written < packet.size()) {
+        const ssize_t bytesWritten = write(fd, packet.constData() + written,
+                                           packet.size() - written);
+        if (bytesWritten == -1) {
+            if (errno == EINTR)
+                continue;
+            throw Exception(QStringLiteral("Failed to write to session: %1")
+                            .arg(qt_error_string(errno)));
+        }
+        written += bytesWritten;
+    }
+}
+
+static QJsonObject readSessionPacket(int fd, QByteArray &data)
+{
+    static const QByteArray magicString = "qbsmsg:";
+    while (true) {
+        const int magicStringOffset = data.indexOf(magicString);
+        if (magicStringOffset != -1) {
+            const int sizeOffset = magicStringOffset + magicString.size();
+            const int newlineOffset = data.indexOf('\n', sizeOffset);
+            if (newlineOffset != -1) {
+                bool isNumber;
+                const int size = data.mid(sizeOffset, newlineOffset - sizeOffset)
+                        .toInt(&isNumber);
+                if (!isNumber || size < 0)
+                    throw Exception(QStringLiteral("Received invalid packet from session."));
+                if (data.size() - newlineOffset - 1 >= size) {
+                    const QByteArray payload = data.mid(newlineOffset + 1, size);
+                    data.remove(0, newlineOffset + 1 + size);
+                    return QJsonDocument::fromJson(QByteArray::fromBase64(payload)).object();
+                }
+            }
+        }
+        char buffer[4096];
+        const ssize_t bytesRead = read(fd, buffer, sizeof buffer);
+        if (bytesRead == 0)
+            throw Exception(QStringLiteral("Session terminated unexpectedly."));
+        if (bytesRead == -1) {
+            if (errno == EINTR)
+                continue;
+            throw Exception(QStringLiteral("Failed to read from session: %1")
+                            .arg(qt_error_string(errno)));
+        }
+        data.append(buffer, bytesRead);
+    }
+}
+#endif
+
+// Requests the project data the way IDEs do and waits for the reply.
+void ActivityRunner::talkToSession(int stdinFd, int stdoutFd, const QString &buildDir) const
+{
+#ifdef Q_OS_UNIX
+    writeSessionPacket(stdinFd, QJsonObject{
+                           {"type", "resolve-project"},
+                           {"project-file-path", m_testProject},
+                           {"build-root", buildDir},
+                           {"data-mode", "always"}});
+    QByteArray data;
+    while (true) {
+        const QJsonObject packet = readSessionPacket(stdoutFd, data);
+        if (packet.value("type").toString() != "project-resolved")
+            continue;
+        const QJsonObject error = packet.value("error").toObject();
+        if (!error.isEmpty()) {
+            throw Exception(QStringLiteral("Session failed to resolve project: %1")
+                            .arg(QString::fromUtf8(QJsonDocument(error).toJson())));
+        }
+        break;
+    }
+    writeSessionPacket(stdinFd, QJsonObject{{"type", "quit"}});
+#else
+    Q_UNUSED(stdinFd)
+    Q_UNUSED(stdoutFd)
+    Q_UNUSED(buildDir)
+#endif
+}
+
+} // namespace qbsBenchmarker
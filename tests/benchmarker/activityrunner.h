@@ -0,0 +1,70 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_BENCHMARKER_ACTIVITYRUNNER_H
+#define QBS_BENCHMARKER_ACTIVITYRUNNER_H
+
+#include "activities.h"
+#include "runsupport.h"
+
+#include <QtCore/qstringlist.h>
+
+namespace qbsBenchmarker {
+
+// Knows how to set up and invoke qbs for each activity. Subclasses do the measuring.
+class ActivityRunner
+{
+public:
+    ActivityRunner(Activities activities, QString testProject, QString editFile,
+                   const QString &qbsBuildDir, QString baseOutputDir);
+    virtual ~ActivityRunner() = default;
+
+protected:
+    // Brings the build directories into the state that the activity starts from.
+    void prepareActivity(Activity activity, const QStringList &buildDirs) const;
+
+    QStringList qbsCommandLine(Activity activity, const QString &buildDir) const;
+    QStringList qbsCommandLine(const QString &command, const QString &buildDir,
+                               bool dryRun) const;
+
+    // Empty for activities that do not talk to the process.
+    ProcessInteraction interaction(Activity activity, const QString &buildDir) const;
+
+    const Activities m_activities;
+    const QString m_testProject;
+    const QString m_editFile;
+    const QString m_qbsBinary;
+    const QString m_baseOutputDir;
+
+private:
+    void editFile() const;
+    void talkToSession(int stdinFd, int stdoutFd, const QString &buildDir) const;
+};
+
+} // namespace qbsBenchmarker
+
+#endif // Include guard.
@@ -31,6 +31,9 @@
 #include "exception.h"
 
 #include <QtCore/qcoreapplication.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
 
 #include <cstdlib>
 #include <iostream>
@@ -41,7 +44,7 @@ static bool hasRegression = false;
 
 static int relativeChange(qint64 oldVal, qint64 newVal)
 {
-    return newVal == 0 ? 0 : (newVal - oldVal) * 100 / oldVal;
+    return newVal == 0 || oldVal == 0 ? 0 : (newVal - oldVal) * 100 / oldVal;
 }
 
 static QByteArray relativeChangeString(int change)
@@ -53,53 +56,93 @@ static QByteArray relativeChangeString(int change)
     return changeString;
 }
 
-static void printResults(Activity activity, const BenchmarkResults &results,
-                         int regressionThreshold)
+static void printComparison(const char *what, const char *unit, qint64 oldValue,
+                            qint64 newValue, int regressionThreshold, bool checkForRegression)
 {
-    std::cout << "========== Performance data for ";
-    switch (activity) {
-    case ActivityResolving:
-        std::cout << "Resolving";
-        break;
-    case ActivityRuleExecution:
-        std::cout << "Rule Execution";
-        break;
-    case ActivityNullBuild:
-        std::cout << "Null Build";
-        break;
-    }
-    std::cout << " ==========" << std::endl;
-    const BenchmarkResult result = results.value(activity);
     const char * const indent = "    ";
-    std::cout << indent << "Old instruction count: " << result.oldInstructionCount << std::endl;
-    std::cout << indent << "New instruction count: " << result.newInstructionCount << std::endl;
-    int change = relativeChange(result.oldInstructionCount, result.newInstructionCount);
-    if (change > regressionThreshold)
-        hasRegression = true;
-    std::cout << indent << "Relative change: "
-              << relativeChangeString(change).constData()
-              << std::endl;
-    std::cout << indent << "Old peak memory usage: " << result.oldPeakMemoryUsage << " Bytes"
-              << std::endl;
-    std::cout << indent
-              << "New peak memory usage: " << result.newPeakMemoryUsage << " Bytes" << std::endl;
-    change = relativeChange(result.oldPeakMemoryUsage, result.newPeakMemoryUsage);
-    if (change > regressionThreshold)
+    std::cout << indent << "Old " << what << ": " << oldValue << unit << std::endl;
+    std::cout << indent << "New " << what << ": " << newValue << unit << std::endl;
+    const int change = relativeChange(oldValue, newValue);
+    if (checkForRegression && change > regressionThreshold)
         hasRegression = true;
     std::cout << indent << "Relative change: "
               << relativeChangeString(change).constData()
               << std::endl;
 }
 
+static void printResults(Activity activity, const BenchmarkResults &results,
+                         int regressionThreshold, bool valgrindUsed)
+{
+    std::cout << "========== Performance data for "
+              << qPrintable(activityDisplayName(activity)) << " ==========" << std::endl;
+    const BenchmarkResult result = results.value(activity);
+    if (valgrindUsed) {
+        printComparison("instruction count", "", result.oldInstructionCount,
+                        result.newInstructionCount, regressionThreshold, true);
+        printComparison("peak memory usage", " Bytes", result.oldPeakMemoryUsage,
+                        result.newPeakMemoryUsage, regressionThreshold, true);
+    }
+
+    // Wall-clock times are too noisy to be compared against the threshold if
+    // there is valgrind data.
+    printComparison("wall-clock time", " ms", result.oldWallClockTime,
+                    result.newWallClockTime, regressionThreshold, !valgrindUsed);
+    printComparison("peak resident set size", " Bytes", result.oldPeakRss, result.newPeakRss,
+                    regressionThreshold, !valgrindUsed);
+}
+
 static void printResults(Activities activities, const BenchmarkResults &results,
-                         int regressionThreshold)
+                         int regressionThreshold, bool valgrindUsed)
+{
+    for (const Activity activity : allActivities()) {
+        if (activities & activity)
+            printResults(activity, results, regressionThreshold, valgrindUsed);
+    }
+}
+
+static QJsonObject resultsToJson(const CommandLineParser &clParser,
+                                 const BenchmarkResults &results)
+{
+    QJsonObject activitiesObject;
+    for (const Activity activity : allActivities()) {
+        if (!(clParser.activies() & activity))
+            continue;
+        const BenchmarkResult result = results.value(activity);
+        const auto dataForVersion = [&clParser](qint64 instructionCount, qint64 peakMemoryUsage,
+                                                qint64 wallClockTime, qint64 peakRss) {
+            QJsonObject data{{"wall-clock-time-ms", wallClockTime}, {"peak-rss", peakRss}};
+            if (clParser.useValgrind()) {
+                data.insert("instruction-count", instructionCount);
+                data.insert("peak-memory-usage", peakMemoryUsage);
+            }
+            return data;
+        };
+        activitiesObject.insert(activityName(activity), QJsonObject{
+            {"old", dataForVersion(result.oldInstructionCount, result.oldPeakMemoryUsage,
+                                   result.oldWallClockTime, result.oldPeakRss)},
+            {"new", dataForVersion(result.newInstructionCount, result.newPeakMemoryUsage,
+                                   result.newWallClockTime, result.newPeakRss)}});
+    }
+    QJsonObject json{
+        {"old-commit", clParser.oldCommit()},
+        {"new-commit", clParser.newCommit()},
+        {"activities", activitiesObject},
+        {"regression", hasRegression}};
+    if (const auto syntheticProject = clParser.syntheticProject())
+        json.insert("synthetic-project", syntheticProject->toJson());
+    else
+        json.insert("test-project", clParser.testProjectFilePath());
+    return json;
+}
+
+static void writeJsonResults(const CommandLineParser &clParser, const BenchmarkResults &results)
 {
-    if (activities & ActivityResolving)
-        printResults(ActivityResolving, results, regressionThreshold);
-    if (activities & ActivityRuleExecution)
-        printResults(ActivityRuleExecution, results, regressionThreshold);
-    if (activities & ActivityNullBuild)
-        printResults(ActivityNullBuild, results, regressionThreshold);
+    QFile f(clParser.jsonOutputFilePath());
+    const QByteArray data = QJsonDocument(resultsToJson(clParser, results)).toJson();
+    if (!f.open(QIODevice::WriteOnly) || f.write(data) != data.size()) {
+        throw Exception(QStringLiteral("Failed to write file '%1': %2")
+                        .arg(f.fileName(), f.errorString()));
+    }
 }
 
 int main(int argc, char *argv[])
@@ -116,9 +159,15 @@ int main(int argc, char *argv[])
 
     Benchmarker benchmarker(clParser.activies(), clParser.oldCommit(), clParser.newCommit(),
                             clParser.testProjectFilePath(), clParser.qbsRepoDirPath());
+    if (const auto syntheticProject = clParser.syntheticProject())
+        benchmarker.setSyntheticProject(*syntheticProject);
+    benchmarker.setUseValgrind(clParser.useValgrind());
     try {
         benchmarker.benchmark();
-        printResults(clParser.activies(), benchmarker.results(), clParser.regressionThreshold());
+        printResults(clParser.activies(), benchmarker.results(), clParser.regressionThreshold(),
+                     clParser.useValgrind());
+        if (!clParser.jsonOutputFilePath().isEmpty())
+            writeJsonResults(clParser, benchmarker.results());
         if (hasRegression) {
             benchmarker.keepRawData();
             std::cout << "Performance regression detected. Raw benchmarking data available "
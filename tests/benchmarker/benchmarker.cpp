@@ -28,6 +28,7 @@
 #include "benchmarker.h"
 
 #include "exception.h"
+#include "nativerunner.h"
 #include "runsupport.h"
 #include "valgrindrunner.h"
 
@@ -72,27 +73,59 @@ void Benchmarker::benchmark()
     const QString newQbsBuildDir = m_baseOutputDir.path() + "/qbs-build." + m_newCommit;
     std::cout << "Building from new repo state..." << std::endl;
     buildQbs(newQbsBuildDir);
-    std::cout << "Now running valgrind. This can take a while." << std::endl;
 
-    ValgrindRunner oldDataRetriever(m_activities, m_testProject, oldQbsBuildDir,
-                                    m_baseOutputDir.path() + "/benchmark-data." + m_oldCommit);
-    ValgrindRunner newDataRetriever(m_activities, m_testProject, newQbsBuildDir,
-                                    m_baseOutputDir.path() + "/benchmark-data." + m_newCommit);
-    QFuture<void> oldFuture = QtConcurrent::run([&oldDataRetriever]{ oldDataRetriever.run(); });
-    QFuture<void> newFuture = QtConcurrent::run([&newDataRetriever]{ newDataRetriever.run(); });
-    oldFuture.waitForFinished();
-    const auto oldValgrindResults = oldDataRetriever.results();
-    for (const ValgrindResult &valgrindResult : oldValgrindResults) {
-        BenchmarkResult &benchmarkResult = m_results[valgrindResult.activity];
-        benchmarkResult.oldInstructionCount = valgrindResult.instructionCount;
-        benchmarkResult.oldPeakMemoryUsage = valgrindResult.peakMemoryUsage;
+    const QString oldDataDir = m_baseOutputDir.path() + "/benchmark-data." + m_oldCommit;
+    const QString newDataDir = m_baseOutputDir.path() + "/benchmark-data." + m_newCommit;
+    const auto [oldTestProject, oldEditFile] = setUpTestProject(oldDataDir);
+    const auto [newTestProject, newEditFile] = setUpTestProject(newDataDir);
+
+    if (m_useValgrind) {
+        std::cout << "Now running valgrind. This can take a while." << std::endl;
+        ValgrindRunner oldDataRetriever(m_activities, oldTestProject, oldEditFile,
+                                        oldQbsBuildDir, oldDataDir);
+        ValgrindRunner newDataRetriever(m_activities, newTestProject, newEditFile,
+                                        newQbsBuildDir, newDataDir);
+        QFuture<void> oldFuture = QtConcurrent::run([&oldDataRetriever]{
+            oldDataRetriever.run();
+        });
+        QFuture<void> newFuture = QtConcurrent::run([&newDataRetriever]{
+            newDataRetriever.run();
+        });
+        oldFuture.waitForFinished();
+        const auto oldValgrindResults = oldDataRetriever.results();
+        for (const ValgrindResult &valgrindResult : oldValgrindResults) {
+            BenchmarkResult &benchmarkResult = m_results[valgrindResult.activity];
+            benchmarkResult.oldInstructionCount = valgrindResult.instructionCount;
+            benchmarkResult.oldPeakMemoryUsage = valgrindResult.peakMemoryUsage;
+        }
+        newFuture.waitForFinished();
+        const auto newValgrindResults = newDataRetriever.results();
+        for (const ValgrindResult &valgrindResult : newValgrindResults) {
+            BenchmarkResult &benchmarkResult = m_results[valgrindResult.activity];
+            benchmarkResult.newInstructionCount = valgrindResult.instructionCount;
+            benchmarkResult.newPeakMemoryUsage = valgrindResult.peakMemoryUsage;
+        }
+    }
+
+    // Sequentially, as concurrent runs would distort each other's timings.
+    std::cout << "Now measuring wall-clock time and memory usage." << std::endl;
+    NativeRunner oldNativeRunner(m_activities, oldTestProject, oldEditFile, oldQbsBuildDir,
+                                 oldDataDir);
+    oldNativeRunner.run();
+    const auto oldNativeResults = oldNativeRunner.results();
+    for (const NativeResult &nativeResult : oldNativeResults) {
+        BenchmarkResult &benchmarkResult = m_results[nativeResult.activity];
+        benchmarkResult.oldWallClockTime = nativeResult.wallClockTime;
+        benchmarkResult.oldPeakRss = nativeResult.peakMemoryUsage;
     }
-    newFuture.waitForFinished();
-    const auto newValgrindResults = newDataRetriever.results();
-    for (const ValgrindResult &valgrindResult : newValgrindResults) {
-        BenchmarkResult &benchmarkResult = m_results[valgrindResult.activity];
-        benchmarkResult.newInstructionCount = valgrindResult.instructionCount;
-        benchmarkResult.newPeakMemoryUsage = valgrindResult.peakMemoryUsage;
+    NativeRunner newNativeRunner(m_activities, newTestProject, newEditFile, newQbsBuildDir,
+                                 newDataDir);
+    newNativeRunner.run();
+    const auto newNativeResults = newNativeRunner.results();
+    for (const NativeResult &nativeResult : newNativeResults) {
+        BenchmarkResult &benchmarkResult = m_results[nativeResult.activity];
+        benchmarkResult.newWallClockTime = nativeResult.wallClockTime;
+        benchmarkResult.newPeakRss = nativeResult.peakMemoryUsage;
     }
     std::cout << "Done!" << std::endl;
 }
@@ -130,4 +163,15 @@ void Benchmarker::buildQbs(const QString &buildDir) const
                << "config:benchmarker", buildDir);
 }
 
+// Returns the project file and the file to edit for incremental builds.
+// Every qbs version gets its own copy of a synthetic project, as the runners modify it.
+std::pair<QString, QString> Benchmarker::setUpTestProject(const QString &dataDir) const
+{
+    if (!m_syntheticProject)
+        return {m_testProject, QString()};
+    ProjectGenerator generator(*m_syntheticProject, dataDir + "/synthetic-project");
+    generator.generate();
+    return {generator.projectFilePath(), generator.editFilePath()};
+}
+
 } // namespace qbsBenchmarker
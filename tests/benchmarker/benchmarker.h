@@ -29,21 +29,31 @@
 #define QBS_BENCHMARKER_BENCHMARKER_H
 
 #include "activities.h"
+#include "projectgenerator.h"
 
 #include <QtCore/qhash.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 #include <QtCore/qtemporarydir.h>
 
+#include <optional>
+#include <utility>
+
 namespace qbsBenchmarker {
 
 class BenchmarkResult
 {
 public:
-    qint64 oldInstructionCount;
-    qint64 newInstructionCount;
-    qint64 oldPeakMemoryUsage;
-    qint64 newPeakMemoryUsage;
+    qint64 oldInstructionCount = 0;
+    qint64 newInstructionCount = 0;
+    qint64 oldPeakMemoryUsage = 0;
+    qint64 newPeakMemoryUsage = 0;
+
+    // Measured without valgrind. Times are in milliseconds.
+    qint64 oldWallClockTime = 0;
+    qint64 newWallClockTime = 0;
+    qint64 oldPeakRss = 0;
+    qint64 newPeakRss = 0;
 };
 using BenchmarkResults = QHash<Activity, BenchmarkResult>;
 
@@ -54,6 +64,12 @@ public:
                 QString testProject, QString qbsRepo);
     ~Benchmarker();
 
+    void setSyntheticProject(const SyntheticProjectParameters &parameters)
+    {
+        m_syntheticProject = parameters;
+    }
+    void setUseValgrind(bool useValgrind) { m_useValgrind = useValgrind; }
+
     void benchmark();
     void keepRawData() { m_baseOutputDir.setAutoRemove(false ); }
 
@@ -63,12 +79,15 @@ public:
 private:
     void rememberCurrentRepoState();
     void buildQbs(const QString &buildDir) const;
+    std::pair<QString, QString> setUpTestProject(const QString &dataDir) const;
 
     const Activities m_activities;
     const QString m_oldCommit;
     const QString m_newCommit;
     const QString m_testProject;
     const QString m_qbsRepo;
+    std::optional<SyntheticProjectParameters> m_syntheticProject;
+    bool m_useValgrind = true;
     QString m_commitToRestore;
     QTemporaryDir m_baseOutputDir;
     BenchmarkResults m_results;
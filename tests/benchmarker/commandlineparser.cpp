@@ -34,12 +34,11 @@
 #include <QtCore/qcoreapplication.h>
 #include <QtCore/qfileinfo.h>
 
+#include <algorithm>
+
 namespace qbsBenchmarker {
 
-static QString resolveActivity() { return "resolving"; }
-static QString ruleExecutionActivity() { return "rule-execution"; }
-static QString nullBuildActivity() { return "null-build"; }
-static QString allActivities() { return "all"; }
+static QString allActivitiesString() { return "all"; }
 
 CommandLineParser::CommandLineParser() = default;
 
@@ -58,22 +57,41 @@ void CommandLineParser::parse()
     QCommandLineOption testProjectOption(QStringList{"test-project", "p"},
             "The example project to use for the benchmark.", "project file path");
     parser.addOption(testProjectOption);
+    QCommandLineOption syntheticProjectOption(QStringList{"synthetic-project", "s"},
+            "Generate the project to use for the benchmark instead of passing one. "
+            "The value is one of small, medium or large, optionally followed by a "
+            "comma-separated list of overrides for the keys products, files, fan-out, "
+            "include-depth, qt and wildcards, e.g. \"large,qt=true\".", "specification");
+    parser.addOption(syntheticProjectOption);
     QCommandLineOption qbsRepoOption(QStringList{"qbs-repo", "r"}, "The qbs repository.",
                                      "repo path");
     parser.addOption(qbsRepoOption);
+    QStringList activityNames;
+    for (const Activity activity : allActivities())
+        activityNames << activityName(activity);
+    activityNames << allActivitiesString();
     QCommandLineOption activitiesOption(QStringList{"activities", "a"},
-            QStringLiteral("The activities to benchmark. Possible values (CSV): %1,%2,%3,%4")
-                    .arg(resolveActivity(), ruleExecutionActivity(), nullBuildActivity(),
-                         allActivities()), "activities", allActivities());
+            QStringLiteral("The activities to benchmark. Possible values (CSV): %1. "
+                           "%2 requires a synthetic project.")
+                    .arg(activityNames.join(','), activityName(ActivityIncrementalBuild)),
+            "activities", allActivitiesString());
     parser.addOption(activitiesOption);
     QCommandLineOption thresholdOption(QStringList{"regression-threshold", "t"},
             "A relative increase higher than this is considered a performance regression. "
-            "All temporary data from running the benchmarks will be kept if that happens.",
+            "All temporary data from running the benchmarks will be kept if that happens. "
+            "Applies to the valgrind data, or to the wall-clock time and memory usage "
+            "if valgrind is not used.",
             "value in per cent");
     parser.addOption(thresholdOption);
+    QCommandLineOption noValgrindOption("no-valgrind",
+            "Only measure wall-clock time and peak memory usage, without running valgrind.");
+    parser.addOption(noValgrindOption);
+    QCommandLineOption jsonOutputOption(QStringList{"json-output", "j"},
+            "Also write the results to this file in JSON format.", "file path");
+    parser.addOption(jsonOutputOption);
     parser.process(*QCoreApplication::instance());
     const QList<QCommandLineOption> mandatoryOptions = QList<QCommandLineOption>()
-            << oldCommitOption << newCommitOption << testProjectOption << qbsRepoOption;
+            << oldCommitOption << newCommitOption << qbsRepoOption;
     for (const QCommandLineOption &o : mandatoryOptions) {
         if (!parser.isSet(o))
             throwException(o.names().constFirst(), parser.helpText());
@@ -86,26 +104,52 @@ void CommandLineParser::parse()
         throw Exception(QStringLiteral("Error parsing command line: "
                 "'new commit' and 'old commit' must be different commits.\n%1").arg(parser.helpText()));
     }
-    m_testProjectFilePath = parser.value(testProjectOption);
+    if (parser.isSet(testProjectOption) == parser.isSet(syntheticProjectOption)) {
+        throw Exception(QStringLiteral("Error parsing command line: Exactly one of '--%1' and "
+                "'--%2' must be given.\n%3").arg(testProjectOption.names().constFirst(),
+                                                 syntheticProjectOption.names().constFirst(),
+                                                 parser.helpText()));
+    }
+    if (parser.isSet(testProjectOption)) {
+        m_testProjectFilePath = parser.value(testProjectOption);
+        if (m_testProjectFilePath.isEmpty()) {
+            throwException(testProjectOption.names().constFirst(), QString(),
+                           parser.helpText());
+        }
+    } else {
+        try {
+            m_syntheticProject = SyntheticProjectParameters::fromString(
+                        parser.value(syntheticProjectOption));
+        } catch (const Exception &e) {
+            throw Exception(QStringLiteral("Error parsing command line: %1\n%2")
+                            .arg(e.description(), parser.helpText()));
+        }
+    }
     m_qbsRepoDirPath = parser.value(qbsRepoOption);
     const QStringList activitiesList = parser.value(activitiesOption).split(',');
     m_activities = Activities();
     for (const QString &activityString : activitiesList) {
-        if (activityString == allActivities()) {
-            m_activities = ActivityResolving | ActivityRuleExecution | ActivityNullBuild;
+        if (activityString == allActivitiesString()) {
+            for (const Activity activity : allActivities())
+                m_activities |= activity;
+            if (!m_syntheticProject)
+                m_activities.setFlag(ActivityIncrementalBuild, false);
             break;
-        } else if (activityString == resolveActivity()) {
-            m_activities = ActivityResolving;
-        } else if (activityString == ruleExecutionActivity()) {
-            m_activities |= ActivityRuleExecution;
-        } else if (activityString == nullBuildActivity()) {
-            m_activities |= ActivityNullBuild;
-        } else {
+        }
+        const auto it = std::find_if(allActivities().cbegin(), allActivities().cend(),
+                                     [&activityString](Activity activity) {
+            return activityName(activity) == activityString;
+        });
+        if (it == allActivities().cend()
+                || (*it == ActivityIncrementalBuild && !m_syntheticProject)) {
             throwException(activitiesOption.names().constFirst(),
                            activityString,
                            parser.helpText());
         }
+        m_activities |= *it;
     }
+    m_useValgrind = !parser.isSet(noValgrindOption);
+    m_jsonOutputFilePath = parser.value(jsonOutputOption);
     m_regressionThreshold = 5;
     if (parser.isSet(thresholdOption)) {
         bool ok = true;
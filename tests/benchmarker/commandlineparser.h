@@ -29,9 +29,12 @@
 #define QBS_BENCHMARKER_COMMANDLINEPARSER_H
 
 #include "activities.h"
+#include "projectgenerator.h"
 
 #include <QtCore/qstringlist.h>
 
+#include <optional>
+
 namespace qbsBenchmarker {
 
 class CommandLineParser
@@ -45,8 +48,14 @@ public:
     QString oldCommit() const { return m_oldCommit; }
     QString newCommit() const { return m_newCommit; }
     QString testProjectFilePath() const { return m_testProjectFilePath; }
+    std::optional<SyntheticProjectParameters> syntheticProject() const
+    {
+        return m_syntheticProject;
+    }
     QString qbsRepoDirPath() const { return m_qbsRepoDirPath; }
     int regressionThreshold() const { return m_regressionThreshold; }
+    bool useValgrind() const { return m_useValgrind; }
+    QString jsonOutputFilePath() const { return m_jsonOutputFilePath; }
 
 private:
     [[noreturn]] void throwException(const QString &optionName, const QString &illegalValue,
@@ -57,8 +66,11 @@ private:
     QString m_oldCommit;
     QString m_newCommit;
     QString m_testProjectFilePath;
+    std::optional<SyntheticProjectParameters> m_syntheticProject;
     QString m_qbsRepoDirPath;
+    QString m_jsonOutputFilePath;
     int m_regressionThreshold = 0;
+    bool m_useValgrind = true;
 };
 
 } // namespace qbsBenchmarker
@@ -0,0 +1,56 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "nativerunner.h"
+
+#include <utility>
+
+namespace qbsBenchmarker {
+
+NativeRunner::NativeRunner(Activities activities, QString testProject, QString editFile,
+                           const QString &qbsBuildDir, const QString &baseOutputDir)
+    : ActivityRunner(activities, std::move(testProject), std::move(editFile), qbsBuildDir,
+                     baseOutputDir)
+{
+}
+
+void NativeRunner::run()
+{
+    for (const Activity activity : allActivities()) {
+        if (!(m_activities & activity))
+            continue;
+        const QString buildDir = m_baseOutputDir + "/build-dir." + activityName(activity)
+                + ".native";
+        prepareActivity(activity, QStringList(buildDir));
+        const ProcessStats stats = runMeasuredProcess(qbsCommandLine(activity, buildDir),
+                                                      QString(),
+                                                      interaction(activity, buildDir));
+        m_results.push_back(NativeResult(activity, stats.wallClockTime, stats.peakMemoryUsage));
+    }
+}
+
+} // namespace qbsBenchmarker
@@ -0,0 +1,65 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_BENCHMARKER_NATIVERUNNER_H
+#define QBS_BENCHMARKER_NATIVERUNNER_H
+
+#include "activityrunner.h"
+
+#include <QtCore/qlist.h>
+
+namespace qbsBenchmarker {
+
+class NativeResult
+{
+public:
+    NativeResult(Activity a, qint64 time, qint64 mem)
+        : activity(a), wallClockTime(time), peakMemoryUsage(mem) {}
+
+    Activity activity;
+    qint64 wallClockTime;
+    qint64 peakMemoryUsage;
+};
+
+// Measures wall-clock time and peak resident set size of unwrapped qbs processes.
+// Activities are run one after the other, so they do not compete for CPU time.
+class NativeRunner : public ActivityRunner
+{
+public:
+    NativeRunner(Activities activities, QString testProject, QString editFile,
+                 const QString &qbsBuildDir, const QString &baseOutputDir);
+
+    void run();
+    QList<NativeResult> results() const { return m_results; }
+
+private:
+    QList<NativeResult> m_results;
+};
+
+} // namespace qbsBenchmarker
+
+#endif // Include guard.
@@ -0,0 +1,233 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#include "projectgenerator.h"
+
+#include "exception.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qstringlist.h>
+
+#include <algorithm>
+#include <utility>
+
+namespace qbsBenchmarker {
+
+static SyntheticProjectParameters presetParameters(const QString &name)
+{
+    SyntheticProjectParameters params;
+    if (name == QLatin1String("small")) {
+        params.productCount = 10;
+        params.filesPerProduct = 5;
+        params.dependencyFanOut = 1;
+        params.includeDepth = 2;
+    } else if (name == QLatin1String("large")) {
+        params.productCount = 500;
+        params.filesPerProduct = 20;
+        params.dependencyFanOut = 4;
+        params.includeDepth = 5;
+    } else if (name != QLatin1String("medium")) {
+        throw Exception(QStringLiteral("Unknown synthetic project size '%1'.").arg(name));
+    }
+    return params;
+}
+
+static int intValue(const QString &key, const QString &value, int minimum)
+{
+    bool ok;
+    const int intValue = value.toInt(&ok);
+    if (!ok || intValue < minimum) {
+        throw Exception(QStringLiteral("Invalid value '%1' for synthetic project property '%2'.")
+                        .arg(value, key));
+    }
+    return intValue;
+}
+
+static bool boolValue(const QString &key, const QString &value)
+{
+    if (value == QLatin1String("true"))
+        return true;
+    if (value == QLatin1String("false"))
+        return false;
+    throw Exception(QStringLiteral("Invalid value '%1' for synthetic project property '%2'.")
+                    .arg(value, key));
+}
+
+SyntheticProjectParameters SyntheticProjectParameters::fromString(const QString &spec)
+{
+    QStringList parts = spec.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    SyntheticProjectParameters params;
+    if (!parts.isEmpty() && !parts.constFirst().contains(QLatin1Char('=')))
+        params = presetParameters(parts.takeFirst());
+    for (const QString &part : std::as_const(parts)) {
+        const int separatorIndex = part.indexOf(QLatin1Char('='));
+        if (separatorIndex == -1) {
+            throw Exception(QStringLiteral("Invalid synthetic project property '%1', expected "
+                                           "key=value.").arg(part));
+        }
+        const QString key = part.left(separatorIndex);
+        const QString value = part.mid(separatorIndex + 1);
+        if (key == QLatin1String("products"))
+            params.productCount = intValue(key, value, 1);
+        else if (key == QLatin1String("files"))
+            params.filesPerProduct = intValue(key, value, 1);
+        else if (key == QLatin1String("fan-out"))
+            params.dependencyFanOut = intValue(key, value, 0);
+        else if (key == QLatin1String("include-depth"))
+            params.includeDepth = intValue(key, value, 1);
+        else if (key == QLatin1String("qt"))
+            params.useQt = boolValue(key, value);
+        else if (key == QLatin1String("wildcards"))
+            params.useWildcards = boolValue(key, value);
+        else
+            throw Exception(QStringLiteral("Unknown synthetic project property '%1'.").arg(key));
+    }
+    return params;
+}
+
+QJsonObject SyntheticProjectParameters::toJson() const
+{
+    return QJsonObject{
+        {QStringLiteral("products"), productCount},
+        {QStringLiteral("files"), filesPerProduct},
+        {QStringLiteral("fan-out"), dependencyFanOut},
+        {QStringLiteral("include-depth"), includeDepth},
+        {QStringLiteral("qt"), useQt},
+        {QStringLiteral("wildcards"), useWildcards}};
+}
+
+ProjectGenerator::ProjectGenerator(SyntheticProjectParameters parameters, QString baseDir)
+    : m_parameters(std::move(parameters)), m_baseDir(std::move(baseDir))
+{
+}
+
+void ProjectGenerator::generate()
+{
+    QByteArray content = "Project {\n    references: [\n";
+    for (int i = 0; i < m_parameters.productCount; ++i) {
+        generateProduct(i);
+        content += "        \"" + productName(i).toUtf8() + '/' + productName(i).toUtf8()
+                + ".qbs\",\n";
+    }
+    content += "    ]\n}\n";
+    writeFile(projectFilePath(), content);
+}
+
+QString ProjectGenerator::projectFilePath() const
+{
+    return m_baseDir + QLatin1String("/synthetic-project.qbs");
+}
+
+// A source file in the middle of the dependency chain, so the incremental build
+// has to deal with a realistic amount of unaffected products.
+QString ProjectGenerator::editFilePath() const
+{
+    const int index = m_parameters.productCount / 2;
+    return productDir(index) + QLatin1Char('/') + productName(index) + QLatin1String("_f0.cpp");
+}
+
+QString ProjectGenerator::productName(int index) const
+{
+    return QStringLiteral("p") + QString::number(index);
+}
+
+QString ProjectGenerator::productDir(int index) const
+{
+    return m_baseDir + QLatin1Char('/') + productName(index);
+}
+
+void ProjectGenerator::generateProduct(int index)
+{
+    const QString dir = productDir(index);
+    if (!QDir::root().mkpath(dir))
+        throw Exception(QStringLiteral("Failed to create directory '%1'.").arg(dir));
+    const QByteArray name = productName(index).toUtf8();
+    const int firstDependency = std::max(0, index - m_parameters.dependencyFanOut);
+
+    // A chain of headers that every source file of the product pulls in.
+    for (int level = 0; level < m_parameters.includeDepth; ++level) {
+        QByteArray header = "#pragma once\n";
+        if (level + 1 < m_parameters.includeDepth)
+            header += "#include \"" + name + "_level" + QByteArray::number(level + 1) + ".h\"\n";
+        header += "inline int " + name + "_level" + QByteArray::number(level) + "() { return "
+                + QByteArray::number(level) + "; }\n";
+        writeFile(dir + QLatin1Char('/') + QString::fromUtf8(name) + QLatin1String("_level")
+                  + QString::number(level) + QLatin1String(".h"), header);
+    }
+
+    QByteArray fileList;
+    for (int i = 0; i < m_parameters.filesPerProduct; ++i) {
+        const QByteArray baseName = name + "_f" + QByteArray::number(i);
+        QByteArray header = "#pragma once\n#include \"" + name + "_level0.h\"\n";
+        if (m_parameters.useQt) {
+            header += "#include <QtCore/qobject.h>\n"
+                      "class " + baseName.toUpper() + " : public QObject\n{\n    Q_OBJECT\n"
+                      "public:\n    using QObject::QObject;\n};\n";
+        }
+        header += "int " + baseName + "();\n";
+        writeFile(dir + QLatin1Char('/') + QString::fromUtf8(baseName) + QLatin1String(".h"),
+                  header);
+
+        QByteArray source = "#include \"" + baseName + ".h\"\n";
+        if (i == 0) {
+            for (int dep = firstDependency; dep < index; ++dep)
+                source += "#include \"" + productName(dep).toUtf8() + "_level0.h\"\n";
+        }
+        source += "int " + baseName + "() { return " + name + "_level0(); }\n";
+        writeFile(dir + QLatin1Char('/') + QString::fromUtf8(baseName) + QLatin1String(".cpp"),
+                  source);
+        fileList += "        \"" + baseName + ".cpp\",\n        \"" + baseName + ".h\",\n";
+    }
+
+    QByteArray content = "StaticLibrary {\n    name: \"" + name + "\"\n"
+            "    Depends { name: \"cpp\" }\n";
+    if (m_parameters.useQt)
+        content += "    Depends { name: \"Qt.core\" }\n";
+    for (int dep = firstDependency; dep < index; ++dep)
+        content += "    Depends { name: \"" + productName(dep).toUtf8() + "\" }\n";
+    if (m_parameters.useWildcards) {
+        content += "    Group {\n        name: \"sources\"\n"
+                   "        files: [\"*.cpp\", \"*.h\"]\n    }\n";
+    } else {
+        content += "    files: [\n" + fileList + "    ]\n";
+    }
+    content += "    Export {\n        Depends { name: \"cpp\" }\n"
+               "        cpp.includePaths: [exportingProduct.sourceDirectory]\n    }\n}\n";
+    writeFile(dir + QLatin1Char('/') + QString::fromUtf8(name) + QLatin1String(".qbs"), content);
+}
+
+void ProjectGenerator::writeFile(const QString &filePath, const QByteArray &content) const
+{
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly) || f.write(content) != content.size()) {
+        throw Exception(QStringLiteral("Failed to write file '%1': %2")
+                        .arg(filePath, f.errorString()));
+    }
+}
+
+} // namespace qbsBenchmarker
@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (C) 2026 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of Qbs.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+#ifndef QBS_BENCHMARKER_PROJECTGENERATOR_H
+#define QBS_BENCHMARKER_PROJECTGENERATOR_H
+
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qstring.h>
+
+namespace qbsBenchmarker {
+
+// Describes a synthetic project. Products only depend on products with a lower index,
+// so the dependency graph is acyclic.
+class SyntheticProjectParameters
+{
+public:
+    // Parses specifications such as "medium" or "large,qt=true,fan-out=5".
+    static SyntheticProjectParameters fromString(const QString &spec);
+    QJsonObject toJson() const;
+
+    int productCount = 50;
+    int filesPerProduct = 10;
+    int dependencyFanOut = 2;
+    int includeDepth = 3;
+    bool useQt = false;
+    bool useWildcards = false;
+};
+
+class ProjectGenerator
+{
+public:
+    ProjectGenerator(SyntheticProjectParameters parameters, QString baseDir);
+
+    void generate();
+    QString projectFilePath() const;
+
+    // The file that gets edited for the incremental build.
+    QString editFilePath() const;
+
+private:
+    QString productName(int index) const;
+    QString productDir(int index) const;
+    void generateProduct(int index);
+    void writeFile(const QString &filePath, const QByteArray &content) const;
+
+    const SyntheticProjectParameters m_parameters;
+    const QString m_baseDir;
+};
+
+} // namespace qbsBenchmarker
+
+#endif // Include guard.
@@ -30,10 +30,22 @@
 #include "exception.h"
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qelapsedtimer.h>
 #include <QtCore/qprocess.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <vector>
+
 namespace qbsBenchmarker {
 
 void runProcess(const QStringList &commandLine, const QString &workingDir, QByteArray *output,
@@ -68,4 +80,104 @@ void runProcess(const QStringList &commandLine, const QString &workingDir, QByte
         *output = p.readAllStandardOutput().trimmed();
 }
 
+#ifdef Q_OS_UNIX
+// Other threads might be starting processes at the same time, so the descriptors
+// must not leak into their children.
+static void createPipe(int fds[2])
+{
+#ifdef Q_OS_LINUX
+    const bool success = pipe2(fds, O_CLOEXEC) == 0;
+#else
+    bool success = pipe(fds) == 0;
+    success = success && fcntl(fds[0], F_SETFD, FD_CLOEXEC) != -1
+            && fcntl(fds[1], F_SETFD, FD_CLOEXEC) != -1;
+#endif
+    if (!success)
+        throw Exception(QStringLiteral("Failed to create pipe: %1").arg(qt_error_string(errno)));
+}
+#endif
+
+ProcessStats runMeasuredProcess(const QStringList &commandLine, const QString &workingDir,
+                                const ProcessInteraction &interaction)
+{
+#ifdef Q_OS_UNIX
+    std::vector<QByteArray> args;
+    for (const QString &arg : commandLine)
+        args.push_back(arg.toLocal8Bit());
+    std::vector<char *> argv;
+    for (QByteArray &arg : args)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    const QByteArray nativeWorkingDir = workingDir.toLocal8Bit();
+
+    int stdinPipe[2];
+    int stdoutPipe[2];
+    createPipe(stdinPipe);
+    createPipe(stdoutPipe);
+    QElapsedTimer timer;
+    timer.start();
+    const pid_t pid = fork();
+    if (pid == -1) {
+        throw Exception(QStringLiteral("Failed to start process '%1': %2")
+                        .arg(commandLine.constFirst(), qt_error_string(errno)));
+    }
+    if (pid == 0) {
+        if (dup2(stdinPipe[0], STDIN_FILENO) == -1 || dup2(stdoutPipe[1], STDOUT_FILENO) == -1)
+            _exit(127);
+        if (!nativeWorkingDir.isEmpty() && chdir(nativeWorkingDir.constData()) != 0)
+            _exit(127);
+        execvp(argv.front(), argv.data());
+        _exit(127);
+    }
+    close(stdinPipe[0]);
+    close(stdoutPipe[1]);
+    try {
+        if (interaction)
+            interaction(stdinPipe[1], stdoutPipe[0]);
+    } catch (const Exception &) {
+        close(stdinPipe[1]);
+        close(stdoutPipe[0]);
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        throw;
+    }
+    close(stdinPipe[1]);
+
+    // Drain the output, so the process cannot block on a full pipe.
+    char buffer[4096];
+    for (;;) {
+        const ssize_t bytesRead = read(stdoutPipe[0], buffer, sizeof buffer);
+        if (bytesRead == 0 || (bytesRead == -1 && errno != EINTR))
+            break;
+    }
+    close(stdoutPipe[0]);
+
+    int status = 0;
+    struct rusage usage{};
+    while (wait4(pid, &status, 0, &usage) == -1) {
+        if (errno != EINTR) {
+            throw Exception(QStringLiteral("Failed to wait for process '%1': %2")
+                            .arg(commandLine.constFirst(), qt_error_string(errno)));
+        }
+    }
+    ProcessStats stats;
+    stats.wallClockTime = timer.elapsed();
+#ifdef Q_OS_MACOS
+    stats.peakMemoryUsage = usage.ru_maxrss;
+#else
+    stats.peakMemoryUsage = qint64(usage.ru_maxrss) * 1024;
+#endif
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw Exception(QStringLiteral("Command '%1' finished with status %2.")
+                        .arg(commandLine.constFirst()).arg(status));
+    }
+    return stats;
+#else
+    Q_UNUSED(workingDir)
+    Q_UNUSED(interaction)
+    throw Exception(QStringLiteral("Cannot measure process '%1': Not supported on this "
+                                   "platform.").arg(commandLine.constFirst()));
+#endif
+}
+
 } // namespace qbsBenchmarker
@@ -32,6 +32,8 @@
 #include <QtCore/qstring.h>
 #include <QtCore/qstringlist.h>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 class QByteArray;
 QT_END_NAMESPACE
@@ -41,6 +43,22 @@ namespace qbsBenchmarker {
 void runProcess(const QStringList &commandLine, const QString& workingDir = QString(),
                 QByteArray *output = nullptr, int *exitCode = nullptr);
 
+class ProcessStats
+{
+public:
+    qint64 wallClockTime = 0; // In milliseconds.
+    qint64 peakMemoryUsage = 0; // Maximum resident set size, in bytes.
+};
+
+// Receives file descriptors connected to the process' standard input and output.
+using ProcessInteraction = std::function<void(int stdinFd, int stdoutFd)>;
+
+// Runs the process without a wrapper and reports its own resource usage.
+// Only supported on Unix-like systems.
+ProcessStats runMeasuredProcess(const QStringList &commandLine,
+                                const QString &workingDir = QString(),
+                                const ProcessInteraction &interaction = {});
+
 } // namespace qbsBenchmarker
 
 #endif // Include guard.
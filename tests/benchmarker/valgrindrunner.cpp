@@ -41,109 +41,55 @@
 
 #include <deque>
 #include <mutex>
+#include <utility>
 
 namespace qbsBenchmarker {
 
-ValgrindRunner::ValgrindRunner(Activities activities, QString testProject,
+ValgrindRunner::ValgrindRunner(Activities activities, QString testProject, QString editFile,
                                const QString &qbsBuildDir, const QString &baseOutputDir)
-    : m_activities(activities)
-    , m_testProject(std::move(testProject))
-    , m_qbsBinary(qbsBuildDir + "/benchmarker/install-root/bin/qbs")
-    , m_baseOutputDir(baseOutputDir)
+    : ActivityRunner(activities, std::move(testProject), std::move(editFile), qbsBuildDir,
+                     baseOutputDir)
 {
-    if (!QDir::root().mkpath(m_baseOutputDir))
-        throw Exception(QStringLiteral("Failed to create directory '%1'.").arg(baseOutputDir));
 }
 
 void ValgrindRunner::run()
 {
     std::deque<QFuture<void>> futures;
-    if (m_activities & ActivityResolving)
-        futures.push_back(QtConcurrent::run([this]{ traceResolving(); }));
-    if (m_activities & ActivityRuleExecution)
-        futures.push_back(QtConcurrent::run([this]{ traceRuleExecution(); }));
-    if (m_activities & ActivityNullBuild)
-        futures.push_back(QtConcurrent::run([this]{ traceNullBuild(); }));
+    for (const Activity activity : allActivities()) {
+        if (m_activities & activity)
+            futures.push_back(QtConcurrent::run([this, activity]{ traceActivity(activity); }));
+    }
     while (!futures.empty()) {
         futures.front().waitForFinished();
         futures.pop_front();
     }
 }
 
-void ValgrindRunner::traceResolving()
+void ValgrindRunner::traceActivity(Activity activity)
 {
-    const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.resolving.callgrind";
-    const QString buildDirMassif = m_baseOutputDir + "/build-dir.resolving.massif";
-    traceActivity(ActivityResolving, buildDirCallgrind, buildDirMassif);
-}
-
-void ValgrindRunner::traceRuleExecution()
-{
-    const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.rule-execution.callgrind";
-    const QString buildDirMassif = m_baseOutputDir + "/build-dir.rule-execution.massif";
-    runProcess(qbsCommandLine("resolve", buildDirCallgrind, false));
-    runProcess(qbsCommandLine("resolve", buildDirMassif, false));
-    traceActivity(ActivityRuleExecution, buildDirCallgrind, buildDirMassif);
-}
-
-void ValgrindRunner::traceNullBuild()
-{
-    const QString buildDirCallgrind = m_baseOutputDir + "/build-dir.null-build.callgrind";
-    const QString buildDirMassif = m_baseOutputDir + "/build-dir.null-build.massif";
-    runProcess(qbsCommandLine("build", buildDirCallgrind, false));
-    runProcess(qbsCommandLine("build", buildDirMassif, false));
-    traceActivity(ActivityNullBuild, buildDirCallgrind, buildDirMassif);
-}
-
-void ValgrindRunner::traceActivity(Activity activity, const QString &buildDirCallgrind,
-                                   const QString &buildDirMassif)
-{
-    QString activityString;
-    QString qbsCommand;
-    bool dryRun = false;
-    switch (activity) {
-    case ActivityResolving:
-        activityString = "resolving";
-        qbsCommand = "resolve";
-        break;
-    case ActivityRuleExecution:
-        activityString = "rule-execution";
-        qbsCommand = "build";
-        dryRun = true;
-        break;
-    case ActivityNullBuild:
-        activityString = "null-build";
-        qbsCommand = "build";
-        break;
-    }
+    const QString activityString = activityName(activity);
+    const QString buildDirCallgrind = m_baseOutputDir + "/build-dir." + activityString
+            + ".callgrind";
+    const QString buildDirMassif = m_baseOutputDir + "/build-dir." + activityString + ".massif";
+    prepareActivity(activity, QStringList{buildDirCallgrind, buildDirMassif});
 
     const QString outFileCallgrind = m_baseOutputDir + "/outfile." + activityString + ".callgrind";
     const QString outFileMassif = m_baseOutputDir + "/outfile." + activityString + ".massif";
     QFuture<qint64> callGrindFuture = QtConcurrent::run(
-                [this, qbsCommand, buildDirCallgrind, dryRun, outFileCallgrind]
+                [this, activity, buildDirCallgrind, outFileCallgrind]
     {
-        return runCallgrind(qbsCommand, buildDirCallgrind, dryRun, outFileCallgrind);
+        return runCallgrind(activity, buildDirCallgrind, outFileCallgrind);
     });
     QFuture<qint64> massifFuture = QtConcurrent::run(
-                [this, qbsCommand, buildDirMassif, dryRun, outFileMassif]
+                [this, activity, buildDirMassif, outFileMassif]
     {
-        return runMassif(qbsCommand, buildDirMassif, dryRun, outFileMassif);
+        return runMassif(activity, buildDirMassif, outFileMassif);
     });
     callGrindFuture.waitForFinished();
     massifFuture.waitForFinished();
     addToResults(ValgrindResult(activity, callGrindFuture.result(), massifFuture.result()));
 }
 
-QStringList ValgrindRunner::qbsCommandLine(const QString &command, const QString &buildDir,
-                                           bool dryRun) const
-{
-    QStringList commandLine = QStringList() << m_qbsBinary << command << "-qq" << "-d" << buildDir
-                                            << "-f" << m_testProject;
-    if (dryRun)
-        commandLine << "--dry-run";
-    return commandLine;
-}
-
 QStringList ValgrindRunner::wrapForValgrind(const QStringList &commandLine, const QString &tool,
                                             const QString &outFile) const
 {
@@ -152,10 +98,15 @@ QStringList ValgrindRunner::wrapForValgrind(const QStringList &commandLine, cons
                          << commandLine;
 }
 
-QStringList ValgrindRunner::valgrindCommandLine(const QString &qbsCommand, const QString &buildDir,
-        bool dryRun, const QString &tool, const QString &outFile) const
+void ValgrindRunner::runValgrind(Activity activity, const QString &buildDir, const QString &tool,
+                                 const QString &outFile) const
 {
-    return wrapForValgrind(qbsCommandLine(qbsCommand, buildDir, dryRun), tool, outFile);
+    const QStringList commandLine = wrapForValgrind(qbsCommandLine(activity, buildDir), tool,
+                                                    outFile);
+    if (const ProcessInteraction processInteraction = interaction(activity, buildDir))
+        runMeasuredProcess(commandLine, QString(), processInteraction);
+    else
+        runProcess(commandLine);
 }
 
 void ValgrindRunner::addToResults(const ValgrindResult &result)
@@ -164,10 +115,10 @@ void ValgrindRunner::addToResults(const ValgrindResult &result)
     m_results.push_back(result);
 }
 
-qint64 ValgrindRunner::runCallgrind(const QString &qbsCommand, const QString &buildDir,
-                                     bool dryRun, const QString &outFile)
+qint64 ValgrindRunner::runCallgrind(Activity activity, const QString &buildDir,
+                                    const QString &outFile)
 {
-    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, "callgrind", outFile));
+    runValgrind(activity, buildDir, "callgrind", outFile);
     QFile f(outFile);
     if (!f.open(QIODevice::ReadOnly)) {
         throw Exception(QStringLiteral("Failed to open file '%1': %2")
@@ -193,10 +144,10 @@ qint64 ValgrindRunner::runCallgrind(const QString &qbsCommand, const QString &bu
                                         "output file '%1'.").arg(outFile));
 }
 
-qint64 ValgrindRunner::runMassif(const QString &qbsCommand, const QString &buildDir, bool dryRun,
-                                  const QString &outFile)
+qint64 ValgrindRunner::runMassif(Activity activity, const QString &buildDir,
+                                 const QString &outFile)
 {
-    runProcess(valgrindCommandLine(qbsCommand, buildDir, dryRun, "massif", outFile));
+    runValgrind(activity, buildDir, "massif", outFile);
     QByteArray ms_printOutput;
     runProcess(QStringList() << "ms_print" << outFile, QString(), &ms_printOutput);
     QBuffer buffer(&ms_printOutput);